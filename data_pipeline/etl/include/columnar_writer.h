@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "utils/columnar_format.h"
+#include "utils/string_pool.h"
+
+namespace etl
+{
+    /**
+     * builds a typed columnar table row by row and writes it in the layout of include/utils/columnar_format.h,
+     * strings from every column share one deduplicated heap
+     */
+    class ColumnarWriter
+    {
+    private:
+        struct ColumnData
+        {
+            std::string name{};
+            ColumnarFormat::Type type{};
+            std::vector<std::int32_t> ints{};
+            std::vector<double> doubles{};
+            std::vector<ColumnarFormat::StringRef> strings{};
+            std::vector<std::uint32_t> offsets{0}; // list columns only
+        };
+
+        std::vector<ColumnData> columns;
+        std::string heap;
+        Utils::StringPool heap_strings;
+        std::vector<std::uint32_t> heap_offsets; // indexed by interned string
+
+    public:
+        explicit ColumnarWriter(const std::vector<std::pair<std::string, ColumnarFormat::Type>> &schema)
+        {
+            columns.reserve(schema.size());
+            for (const auto &[name, type] : schema)
+            {
+                columns.push_back(ColumnData{name, type});
+            }
+        }
+
+        void append_int32(std::size_t column, std::int32_t value)
+        {
+            columns[column].ints.push_back(value);
+        }
+
+        void append_float64(std::size_t column, double value)
+        {
+            columns[column].doubles.push_back(value);
+        }
+
+        void append_string(std::size_t column, std::string_view value)
+        {
+            columns[column].strings.push_back(store(value));
+        }
+
+        void append_int32_list(std::size_t column, const std::vector<std::int32_t> &values)
+        {
+            ColumnData &data{columns[column]};
+            data.ints.insert(data.ints.end(), values.begin(), values.end());
+            data.offsets.push_back(static_cast<std::uint32_t>(data.ints.size()));
+        }
+
+        template <typename Range>
+        void append_string_list(std::size_t column, const Range &values)
+        {
+            ColumnData &data{columns[column]};
+            for (const auto &value : values)
+            {
+                data.strings.push_back(store(value));
+            }
+            data.offsets.push_back(static_cast<std::uint32_t>(data.strings.size()));
+        }
+
+        /**
+         * @param file_path output table
+         * @return true if every column has the same number of rows and the file was written
+         */
+        bool write(const std::string &file_path)
+        {
+            std::size_t row_count{columns.empty() ? 0 : rows(columns.front())};
+            for (const auto &column : columns)
+            {
+                if (rows(column) != row_count)
+                {
+                    return false;
+                }
+            }
+
+            std::vector<ColumnarFormat::StringRef> names{};
+            names.reserve(columns.size());
+            for (const auto &column : columns)
+            {
+                names.push_back(store(column.name));
+            }
+
+            std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open())
+            {
+                return false;
+            }
+
+            ColumnarFormat::Header header{};
+            std::copy(std::begin(ColumnarFormat::MAGIC), std::end(ColumnarFormat::MAGIC), header.magic);
+            header.version = ColumnarFormat::VERSION;
+            header.column_count = static_cast<std::uint32_t>(columns.size());
+            header.row_count = static_cast<std::uint32_t>(row_count);
+            header.string_heap_size = static_cast<std::uint32_t>(heap.size());
+
+            std::uint64_t cursor{sizeof(ColumnarFormat::Header)};
+            auto place = [&](std::size_t bytes)
+            {
+                std::uint64_t offset{cursor};
+                cursor += padded(bytes);
+                return offset;
+            };
+
+            header.schema_offset = place(columns.size() * sizeof(ColumnarFormat::Column));
+
+            std::vector<ColumnarFormat::Column> schema{};
+            schema.reserve(columns.size());
+            for (std::size_t i{0}; i < columns.size(); ++i)
+            {
+                const ColumnData &data{columns[i]};
+                ColumnarFormat::Column column{names[i], data.type, 0, 0, 0, 0};
+
+                auto [bytes, count]{payload(data)};
+                column.values_offset = place(bytes);
+                column.value_count = count;
+
+                if (ColumnarFormat::is_list(data.type))
+                {
+                    column.offsets_offset = place(data.offsets.size() * sizeof(std::uint32_t));
+                }
+
+                schema.push_back(column);
+            }
+
+            header.string_heap_offset = place(heap.size());
+
+            write_padded(out, &header, sizeof(header));
+            write_padded(out, schema.data(), schema.size() * sizeof(ColumnarFormat::Column));
+
+            for (const auto &data : columns)
+            {
+                switch (data.type)
+                {
+                case ColumnarFormat::Type::INT32:
+                case ColumnarFormat::Type::INT32_LIST:
+                    write_padded(out, data.ints.data(), data.ints.size() * sizeof(std::int32_t));
+                    break;
+                case ColumnarFormat::Type::FLOAT64:
+                    write_padded(out, data.doubles.data(), data.doubles.size() * sizeof(double));
+                    break;
+                case ColumnarFormat::Type::STRING:
+                case ColumnarFormat::Type::STRING_LIST:
+                    write_padded(out, data.strings.data(), data.strings.size() * sizeof(ColumnarFormat::StringRef));
+                    break;
+                }
+
+                if (ColumnarFormat::is_list(data.type))
+                {
+                    write_padded(out, data.offsets.data(), data.offsets.size() * sizeof(std::uint32_t));
+                }
+            }
+
+            write_padded(out, heap.data(), heap.size());
+
+            out.flush();
+            out.close();
+
+            return static_cast<bool>(out);
+        }
+
+    private:
+        ColumnarFormat::StringRef store(std::string_view sv)
+        {
+            std::uint32_t id{heap_strings.intern(sv)};
+            if (id == heap_offsets.size())
+            {
+                heap_offsets.push_back(static_cast<std::uint32_t>(heap.size()));
+                heap.append(sv);
+            }
+            return ColumnarFormat::StringRef{heap_offsets[id], static_cast<std::uint32_t>(sv.size())};
+        }
+
+        static std::size_t rows(const ColumnData &data)
+        {
+            if (ColumnarFormat::is_list(data.type))
+            {
+                return data.offsets.size() - 1;
+            }
+            return payload(data).second;
+        }
+
+        static std::pair<std::size_t /* bytes */, std::size_t /* values */> payload(const ColumnData &data)
+        {
+            switch (data.type)
+            {
+            case ColumnarFormat::Type::INT32:
+            case ColumnarFormat::Type::INT32_LIST:
+                return {data.ints.size() * sizeof(std::int32_t), data.ints.size()};
+            case ColumnarFormat::Type::FLOAT64:
+                return {data.doubles.size() * sizeof(double), data.doubles.size()};
+            case ColumnarFormat::Type::STRING:
+            case ColumnarFormat::Type::STRING_LIST:
+                return {data.strings.size() * sizeof(ColumnarFormat::StringRef), data.strings.size()};
+            }
+            return {0, 0};
+        }
+
+        static std::size_t padded(std::size_t bytes)
+        {
+            return (bytes + ColumnarFormat::ALIGNMENT - 1) / ColumnarFormat::ALIGNMENT * ColumnarFormat::ALIGNMENT;
+        }
+
+        static void write_padded(std::ofstream &out, const void *data, std::size_t bytes)
+        {
+            static constexpr char padding[ColumnarFormat::ALIGNMENT]{};
+            out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+            out.write(padding, static_cast<std::streamsize>(padded(bytes) - bytes));
+        }
+    };
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "config.h"
+#include "system_config.h"
+#include "zip_archive.h"
+#include "utils/hasher.h"
+#include "utils/utils.h"
+
+namespace etl
+{
+    /**
+     * bump whenever processing logic (e.g trip filters or sequence transforms) changes
+     * so that every system is rebuilt even though its inputs did not
+     */
+    inline constexpr int PIPELINE_VERSION{1};
+
+    /**
+     * records the content hash of every input an output file was built from,
+     * keyed by "<output>|<input>" so stations and routes are tracked independently
+     */
+    class Manifest
+    {
+    private:
+        std::map<std::string, std::uint64_t> entries; // ordered so the written manifest diffs cleanly
+
+    public:
+        Manifest() = default;
+
+        static Manifest load(const std::string &file_path)
+        {
+            Manifest manifest{};
+
+            std::ifstream file(file_path);
+            if (!file.is_open())
+            {
+                return manifest;
+            }
+
+            std::string line{};
+            std::getline(file, line); // header
+
+            while (std::getline(file, line))
+            {
+                auto tokens{Utils::split(line, ',')};
+                if (tokens.size() < 2)
+                {
+                    continue;
+                }
+
+                try
+                {
+                    std::uint64_t hash{std::stoull(std::string(Utils::trim(tokens[1])), nullptr, 16)};
+                    manifest.entries.emplace(std::string(tokens[0]), hash);
+                }
+                catch (const std::exception &)
+                {
+                    continue;
+                }
+            }
+
+            return manifest;
+        }
+
+        bool save(const std::string &file_path) const
+        {
+            std::ofstream file(file_path, std::ios::out | std::ios::trunc);
+            if (!file.is_open())
+            {
+                return false;
+            }
+
+            file << "dependency,hash\n";
+            for (const auto &[key, hash] : entries)
+            {
+                file << key << "," << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << "\n";
+            }
+
+            return static_cast<bool>(file);
+        }
+
+        /**
+         * @param output name of the output the dependencies belong to
+         * @param fingerprints current hashes of every dependency of the output
+         * @return true if every dependency hash matches the recorded one
+         */
+        bool is_current(std::string_view output, const std::vector<std::pair<std::string, std::uint64_t>> &fingerprints) const
+        {
+            for (const auto &[dependency, hash] : fingerprints)
+            {
+                auto it{entries.find(make_key(output, dependency))};
+                if (it == entries.end() || it->second != hash)
+                {
+                    return false;
+                }
+            }
+
+            return !fingerprints.empty();
+        }
+
+        void record(std::string_view output, const std::vector<std::pair<std::string, std::uint64_t>> &fingerprints)
+        {
+            std::erase_if(entries, [&](const auto &entry)
+                          { return entry.first.starts_with(std::string(output) + "|"); });
+
+            for (const auto &[dependency, hash] : fingerprints)
+            {
+                entries[make_key(output, dependency)] = hash;
+            }
+        }
+
+        void invalidate(std::string_view output)
+        {
+            record(output, {});
+        }
+
+    private:
+        static std::string make_key(std::string_view output, std::string_view dependency)
+        {
+            return std::string(output) + "|" + std::string(dependency);
+        }
+    };
+
+    /**
+     * paths are recorded relative to the data directory so moving the checkout does not invalidate the manifest
+     */
+    inline std::string relative_to_data(const std::string &file_path)
+    {
+        return std::filesystem::path(file_path).lexically_relative(DATA_DIRECTORY).generic_string();
+    }
+
+    /**
+     * fingerprints the declarative part of a system configuration, lambdas cannot be hashed
+     * so changes to them are covered by PIPELINE_VERSION instead
+     *
+     * @param config system specific configuration
+     * @return xxHash of the configuration fields
+     */
+    inline std::uint64_t hash_config(const SystemConfig &config)
+    {
+        Utils::Hasher hasher{};
+
+        auto add = [&](std::string_view field)
+        {
+            hasher.update(field);
+            hasher.update("\x1f", 1); // field separator so ("ab", "c") and ("a", "bc") differ
+        };
+
+        add(std::to_string(PIPELINE_VERSION));
+        add(config.name);
+        for (const auto &source : {config.station_input, config.trips_input, config.stop_times_input, config.routes_input.value_or(ZipSource{}), config.calendar_input.value_or(ZipSource{}), config.calendar_dates_input.value_or(ZipSource{})})
+        {
+            add(source.archive.empty() ? "" : relative_to_data(source.archive));
+            add(source.member);
+        }
+        add(relative_to_data(config.station_output_file));
+        add(relative_to_data(config.routes_output_file));
+        add(relative_to_data(config.station_binary_file));
+        add(relative_to_data(config.routes_binary_file));
+        add(relative_to_data(config.timetable_output_file));
+        add(config.station_header);
+        add(config.routes_header);
+
+        for (const auto &columns : {config.station_columns, config.trip_columns, config.stop_time_columns, config.route_columns.value_or(std::vector<std::string_view>{})})
+        {
+            for (std::string_view column : columns)
+            {
+                add(column);
+            }
+            add("");
+        }
+
+        for (ColumnarFormat::Type type : config.station_types)
+        {
+            add(std::to_string(static_cast<std::uint32_t>(type)));
+        }
+        add(std::to_string(static_cast<std::uint32_t>(config.ordered_stops_type)));
+
+        add(config.multiple_trips ? "1" : "0");
+
+        return hasher.digest();
+    }
+
+    /**
+     * fingerprints a single archive member from its central directory entry, the stored crc and size
+     * change whenever the member content does, so nothing has to be inflated to detect a change and
+     * refreshing one file of a feed leaves outputs built from its other files untouched
+     *
+     * @param source archive and member to fingerprint
+     * @param log receives the reason the archive could not be opened
+     * @return xxHash of the member crc and uncompressed size, or nullopt if the archive or member is missing
+     */
+    inline std::optional<std::uint64_t> hash_member(const ZipSource &source, const Log &log)
+    {
+        auto archive{ZipArchive::open(source.archive, log)};
+        if (!archive.has_value())
+        {
+            return std::nullopt;
+        }
+
+        const ZipArchive::Entry *entry{archive->find(source.member)};
+        if (entry == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        Utils::Hasher hasher{};
+        hasher.update(&entry->crc, sizeof(entry->crc));
+        hasher.update(&entry->uncompressed_size, sizeof(entry->uncompressed_size));
+        return hasher.digest();
+    }
+
+    /**
+     * hashes the config and each input of an output
+     *
+     * @param config system specific configuration
+     * @param inputs archive members the output is derived from
+     * @param log receives the reason an input archive could not be opened
+     * @return (dependency, hash) pairs, or nullopt if any input is missing
+     */
+    inline std::optional<std::vector<std::pair<std::string, std::uint64_t>>> fingerprint(const SystemConfig &config, const std::vector<ZipSource> &inputs, const Log &log)
+    {
+        std::vector<std::pair<std::string, std::uint64_t>> fingerprints{};
+        fingerprints.reserve(inputs.size() + 1);
+        fingerprints.emplace_back("config", hash_config(config));
+
+        for (const auto &input : inputs)
+        {
+            auto hash{hash_member(input, log)};
+            if (!hash.has_value())
+            {
+                return std::nullopt;
+            }
+
+            fingerprints.emplace_back(relative_to_data(input.archive) + ":" + input.member, *hash);
+        }
+
+        return fingerprints;
+    }
+}
@@ -1,35 +1,57 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <ranges>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
-#include <sstream>
 #include <unordered_map>
-#include <unordered_set>
+#include <variant>
 #include <vector>
 
 #include "config.h"
 #include "system_config.h"
+#include "zip_archive.h"
+#include "columnar_writer.h"
 #include "utils/utils.h"
+#include "utils/string_pool.h"
 
 namespace etl
 {
 
-    inline void process_stations(const SystemConfig &config)
+    /**
+     * @param header comma separated output column names
+     * @param types binary type of each column
+     * @return schema for the columnar copy of an output
+     */
+    inline std::vector<std::pair<std::string, ColumnarFormat::Type>> columnar_schema(std::string_view header, const std::vector<ColumnarFormat::Type> &types)
+    {
+        std::vector<std::pair<std::string, ColumnarFormat::Type>> schema{};
+        auto names{Utils::split(header, ',')};
+        for (std::size_t i{0}; i < names.size() && i < types.size(); ++i)
+        {
+            schema.emplace_back(std::string(Utils::trim(names[i])), types[i]);
+        }
+        return schema;
+    }
+
+    inline bool process_stations(const SystemConfig &config, const Log &log)
     {
         std::ofstream out(config.station_output_file);
         if (!out.is_open())
         {
             Utils::log_file_open_error(config.name, "stations", config.station_output_file);
-            return;
+            return false;
         }
 
         out << config.station_header << "\n";
 
-        Utils::open_and_parse(config.station_input_file, config.station_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+        ColumnarWriter table{columnar_schema(config.station_header, config.station_types)};
+        std::vector<std::variant<std::int32_t, double>> numbers(config.station_columns.size());
+
+        bool parsed{open_and_parse_member(config.station_input.archive, config.station_input.member, config.station_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
                               {
                 auto tokens = Utils::split(line, ',');
                 if (tokens.size() < column_index.size())
@@ -40,209 +62,277 @@ namespace etl
 
                 auto row {Utils::from_tokens(tokens, column_index)};
 
+                // numeric columns are converted up front so a bad value drops the row from both outputs
+                try
+                {
+                    for (std::size_t i{0}; i < config.station_columns.size(); ++i)
+                    {
+                        std::string_view value {Utils::trim(row[config.station_columns[i]])};
+                        if (config.station_types[i] == ColumnarFormat::Type::INT32)
+                        {
+                            numbers[i] = Utils::string_view_to_numeric<std::int32_t>(value);
+                        }
+                        else if (config.station_types[i] == ColumnarFormat::Type::FLOAT64)
+                        {
+                            numbers[i] = Utils::string_view_to_numeric<double>(value);
+                        }
+                    }
+                }
+                catch (const std::exception &)
+                {
+                    Utils::log_malformed_line(config.name, "stations", line_num, line);
+                    return;
+                }
+
                 // write out row values in column order in config
                 bool first = true;
-                for (const auto& column : config.station_columns)
+                for (std::size_t i{0}; i < config.station_columns.size(); ++i)
                 {
+                    std::string_view value {row[config.station_columns[i]]};
+
                     if (!first) out << ",";
-                    out << row[column];
+                    out << value;
                     first = false;
+
+                    switch (config.station_types[i])
+                    {
+                    case ColumnarFormat::Type::INT32: table.append_int32(i, std::get<std::int32_t>(numbers[i])); break;
+                    case ColumnarFormat::Type::FLOAT64: table.append_float64(i, std::get<double>(numbers[i])); break;
+                    case ColumnarFormat::Type::STRING: table.append_string(i, value); break;
+                    case ColumnarFormat::Type::STRING_LIST: table.append_string_list(i, Utils::split(Utils::trim(value), ' ')); break;
+                    case ColumnarFormat::Type::INT32_LIST: table.append_int32_list(i, {}); break;
+                    }
                 }
-                out << "\n"; });
+                out << "\n"; }, log)};
 
         out.flush();
         out.close();
+
+        if (!table.write(config.station_binary_file))
+        {
+            Utils::log_file_open_error(config.name, "stations", config.station_binary_file);
+            return false;
+        }
+
+        return parsed && static_cast<bool>(out);
     }
 
-    inline void process_routes(const SystemConfig &config)
+    /**
+     * extract a mapping from route id to the route long name
+     *
+     * @param config system specific configuration
+     * @param log receives the reason the routes file could not be read
+     * @return map where key is route_id and value is route_long_name, empty if the system has no routes file
+     */
+    inline std::unordered_map<int /* route_id */, std::string /* route_long_name */> extract_route_map(const SystemConfig &config, const Log &log)
     {
+        std::unordered_map<int, std::string> route_map{};
 
-        /**
-         * extract a mapping from "route|headsign" to vector of trip ids
-         *
-         * @param config system specific configuration
-         * @return map where key is "route_id|trip_headsign" and value is vector of trip ids
-         */
-        auto extract_headsign_to_trip = [](const SystemConfig &config) -> std::unordered_map<std::string /* route|headsign */, std::vector<std::string /* trip_id */>>
+        if (!config.routes_input.has_value() || !config.route_columns.has_value())
         {
-            std::unordered_map<std::string, std::vector<std::string>> headsign_to_trip{};
+            return route_map;
+        }
 
-            Utils::open_and_parse(config.trips_input_file, config.trip_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
-                                  {
-            std::unordered_set<std::string> used_pairs{};
-            auto tokens = Utils::split(line, ',');
-             if (tokens.size() < column_index.size())
-                {
-                    Utils::log_malformed_line(config.name, "trips", line_num, line);
-                    return;
-                }
-            
-            auto row {Utils::from_tokens(tokens, column_index)};
+        const ZipSource &routes_source{*config.routes_input};
+        auto route_columns{*config.route_columns};
 
-            if (!config.trip_filter(row))
+        open_and_parse_member(routes_source.archive, routes_source.member, route_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+                              {
+            auto tokens = Utils::split(line, ',');
+            if (tokens.size() < column_index.size())
             {
+                Utils::log_malformed_line(config.name, "routes", line_num, line);
                 return;
             }
 
-            std::ostringstream oss;
-            oss << row.at("route_id") << '|' << row.at("trip_headsign");
-            std::string unique_key = oss.str();
+            auto row {Utils::from_tokens(tokens, column_index)};
+
+            int route_id {Utils::string_view_to_numeric<int>(row.at("route_id"))};
 
-            bool first_occurrence {used_pairs.insert(unique_key).second};
-            if (config.multiple_trips || first_occurrence)
-            {
-                headsign_to_trip[unique_key].push_back(std::string(row.at("trip_id")));
-            } });
-            return headsign_to_trip;
+            route_map[route_id] = row.at("route_long_name"); }, log);
+
+        return route_map;
+    }
+
+    /**
+     * @param route_id route id as it appears in trips.txt
+     * @param route_map result of extract_route_map
+     * @return the route long name when the system has one, otherwise the route id itself
+     */
+    inline std::string resolve_route_name(const std::string &route_id, const std::unordered_map<int, std::string> &route_map)
+    {
+        if (route_map.empty())
+        {
+            return route_id;
+        }
+
+        int id{std::stoi(route_id)};
+        auto it = route_map.find(id);
+        return (it != route_map.end() ? it->second : std::to_string(id));
+    }
+
+    inline bool process_routes(const SystemConfig &config, const Log &log)
+    {
+        /**
+         * trips sharing a route and headsign, all fields are ids interned in the shared pool
+         */
+        struct TripGroup
+        {
+            std::uint32_t route_id;
+            std::uint32_t headsign;
+            std::vector<std::uint32_t> trip_ids;
         };
 
+        Utils::StringPool pool{}; // route ids, headsigns, trip ids and stop ids share one id space
+
         /**
-         * extract a mapping from trip id to ordered list of stops
-         * note: stop_id is a string and changed to int later to properly handle subway data
+         * group trip ids by route and headsign, in order of first appearance
          *
          * @param config system specific configuration
-         * @param valid_trip_ids set of trip ids to filter trips from file
-         * @return map where key is trip id and value is a vector of pairs (stop_sequence, stop_id)
+         * @return trip groups, keeping only the first trip of each group unless multiple_trips is set
          */
-        auto extract_trip_to_stops = [](const SystemConfig &config, std::unordered_set<std::string> &valid_trip_ids) -> std::unordered_map<std::string /* trip id */, std::vector<std::pair<int /* stop_sequence */, std::string /* stop_id */>>>
+        auto extract_headsign_to_trip = [&pool, &log](const SystemConfig &config) -> std::vector<TripGroup>
         {
-            std::unordered_map<std::string, std::vector<std::pair<int, std::string>>> trip_to_stops{};
+            std::vector<TripGroup> groups{};
+            std::unordered_map<std::uint64_t /* route << 32 | headsign */, std::size_t /* index into groups */> group_index{};
+            std::vector<std::string_view> tokens{};
+            std::unordered_map<std::string_view, std::string_view> row{}; // refilled for every row, trip filters take a row by column name
 
-            Utils::open_and_parse(config.stop_times_input_file, config.stop_time_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+            open_and_parse_member(config.trips_input.archive, config.trips_input.member, config.trip_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
                                   {
-            auto tokens = Utils::split(line, ',');
-                         if (tokens.size() < column_index.size())
-                {
-                    Utils::log_malformed_line(config.name, "stop times", line_num, line);
-                    return;
-                }
-            
-            auto row {Utils::from_tokens(tokens, column_index)};
+            Utils::split_into(line, ',', tokens);
+            if (tokens.size() < column_index.size())
+            {
+                Utils::log_malformed_line(config.name, "trips", line_num, line);
+                return;
+            }
 
-            std::string trip_id {row.at("trip_id")};
-            if (valid_trip_ids.find(trip_id) == valid_trip_ids.end())
+            Utils::from_tokens_into(tokens, column_index, row);
+
+            if (!config.trip_filter(row))
             {
                 return;
             }
 
-            int stop_seq {Utils::string_view_to_numeric<int>(row.at("stop_sequence"))};
+            std::uint32_t route_id {pool.intern(row.at("route_id"))};
+            std::uint32_t headsign {pool.intern(row.at("trip_headsign"))};
+            std::uint64_t key {(static_cast<std::uint64_t>(route_id) << 32) | headsign};
 
-            trip_to_stops[trip_id].emplace_back(stop_seq, row.at("stop_id")); });
+            auto [it, inserted] {group_index.try_emplace(key, groups.size())};
+            if (inserted)
+            {
+                groups.push_back(TripGroup{route_id, headsign, {}});
+            }
 
-            return trip_to_stops;
+            if (config.multiple_trips || inserted)
+            {
+                groups[it->second].trip_ids.push_back(pool.intern(row.at("trip_id")));
+            } }, log);
+
+            return groups;
         };
 
         /**
-         * extract a mapping from route id to the route long name
+         * extract the ordered stops of every selected trip
+         * note: stop_id is kept as a string id and changed to int later to properly handle subway data
          *
          * @param config system specific configuration
-         * @return map where key is route_id and value is route_long_name
+         * @param valid_trip_ids flags indexed by interned trip id, only flagged trips are kept
+         * @return stops indexed by trip id, each a vector of pairs (stop_sequence, stop_id)
          */
-        auto extract_route_map = [](const SystemConfig &config) -> std::unordered_map<int /* route_id */, std::string /* route_long_name */>
+        auto extract_trip_to_stops = [&pool, &log](const SystemConfig &config, const std::vector<bool> &valid_trip_ids) -> std::vector<std::vector<std::pair<int /* stop_sequence */, std::uint32_t /* stop_id */>>>
         {
-            std::unordered_map<int, std::string> route_map{};
+            std::vector<std::vector<std::pair<int, std::uint32_t>>> trip_to_stops(valid_trip_ids.size());
+            std::vector<std::string_view> tokens{};
 
-            if (!config.routes_input_file.has_value() || !config.route_columns.has_value())
+            open_and_parse_member(config.stop_times_input.archive, config.stop_times_input.member, config.stop_time_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+                                  {
+            Utils::split_into(line, ',', tokens);
+            if (tokens.size() < column_index.size())
             {
-                return route_map;
+                Utils::log_malformed_line(config.name, "stop times", line_num, line);
+                return;
             }
 
-            auto routes_file{*config.routes_input_file};
-            auto route_columns{*config.route_columns};
-
-            Utils::open_and_parse(routes_file, route_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
-                                  {
-            auto tokens = Utils::split(line, ',');
-                                     if (tokens.size() < column_index.size())
-                {
-                    Utils::log_malformed_line(config.name, "routes", line_num, line);
-                    return;
-                }
-            
-                auto row {Utils::from_tokens(tokens, column_index)};
+            // only three columns are needed, so index tokens directly rather than building a row map
+            auto trip_id {pool.find(Utils::trim(tokens[column_index.at("trip_id")]))};
+            if (!trip_id.has_value() || *trip_id >= valid_trip_ids.size() || !valid_trip_ids[*trip_id])
+            {
+                return;
+            }
 
-                int route_id {Utils::string_view_to_numeric<int>(row.at("route_id"))};
+            int stop_seq {Utils::string_view_to_numeric<int>(Utils::trim(tokens[column_index.at("stop_sequence")]))};
+            std::uint32_t stop_id {pool.intern(Utils::trim(tokens[column_index.at("stop_id")]))};
 
-                route_map[route_id] = row.at("route_long_name"); });
+            trip_to_stops[*trip_id].emplace_back(stop_seq, stop_id); }, log);
 
-            return route_map;
+            return trip_to_stops;
         };
 
-        auto headsign_to_trip = extract_headsign_to_trip(config);
+        auto trip_groups = extract_headsign_to_trip(config);
 
-        std::unordered_set<std::string> valid_trip_ids{};
-        for (const auto &[headsign, trips] : headsign_to_trip)
+        std::vector<bool> valid_trip_ids(pool.size(), false);
+        for (const auto &group : trip_groups)
         {
-            std::ranges::for_each(trips, [&](auto const &trip_id)
-                                  { valid_trip_ids.insert(trip_id); });
+            std::ranges::for_each(group.trip_ids, [&](std::uint32_t trip_id)
+                                  { valid_trip_ids[trip_id] = true; });
         }
 
         auto trip_to_stops = extract_trip_to_stops(config, valid_trip_ids);
-        auto route_map = extract_route_map(config);
+        auto route_map = extract_route_map(config, log);
 
         std::ofstream out(config.routes_output_file);
         if (!out.is_open())
         {
             Utils::log_file_open_error(config.name, "routes", config.routes_output_file);
-            return;
+            return false;
         }
 
         out << config.routes_header << "\n";
 
-        for (const auto &[route_headsign, trip_ids] : headsign_to_trip)
-        {
+        ColumnarWriter table{columnar_schema(config.routes_header, {ColumnarFormat::Type::STRING, ColumnarFormat::Type::STRING, config.ordered_stops_type})};
+        std::vector<std::int32_t> numeric_stops{};
 
-            std::vector<std::pair<int, std::string>> sorted_stops{};
+        for (const auto &group : trip_groups)
+        {
+            const std::vector<std::pair<int, std::uint32_t>> *stops{nullptr};
 
             if (config.multiple_trips)
             {
-                std::string longest_trip_id{};
                 size_t longest_length{};
 
-                for (const std::string &trip_id : trip_ids)
+                for (std::uint32_t trip_id : group.trip_ids)
                 {
-                    auto it = trip_to_stops.find(trip_id);
-                    if (it == trip_to_stops.end())
-                    {
-                        continue;
-                    }
-
-                    if (it->second.size() > longest_length)
+                    if (trip_to_stops[trip_id].size() > longest_length)
                     {
-                        longest_length = it->second.size();
-                        longest_trip_id = trip_id;
+                        longest_length = trip_to_stops[trip_id].size();
+                        stops = &trip_to_stops[trip_id];
                     }
                 }
-
-                if (longest_trip_id.empty())
-                {
-                    continue;
-                }
-
-                sorted_stops = trip_to_stops[longest_trip_id];
             }
-            else
+            else if (!trip_to_stops[group.trip_ids.front()].empty())
             {
-                auto it = trip_to_stops.find(trip_ids.front());
-                if (it == trip_to_stops.end())
-                {
-                    continue;
-                }
-
-                sorted_stops = it->second;
+                stops = &trip_to_stops[group.trip_ids.front()];
             }
 
-            std::ranges::sort(sorted_stops);
-            auto sequence = config.transform_sequence(sorted_stops); // see system specific config for more details
-
-            auto tokens = Utils::split(route_headsign, '|');
-            if (tokens.size() < 2)
+            if (stops == nullptr)
             {
                 continue;
             }
 
-            std::string route_id{tokens[0]};
-            std::string headsign{tokens[1]};
+            // stop ids are resolved back to strings only here, once per route and headsign
+            std::vector<std::pair<int, std::string>> sorted_stops{};
+            sorted_stops.reserve(stops->size());
+            for (const auto &[stop_seq, stop_id] : *stops)
+            {
+                sorted_stops.emplace_back(stop_seq, std::string(pool.view(stop_id)));
+            }
+
+            std::ranges::sort(sorted_stops);
+            auto sequence = config.transform_sequence(sorted_stops); // see system specific config for more details
+
+            std::string route_id{pool.view(group.route_id)};
+            std::string_view headsign{pool.view(group.headsign)};
 
             std::string ordered_stops{};
             for (int i = 0; i < sequence.size(); ++i)
@@ -255,22 +345,48 @@ namespace etl
                 ordered_stops += sequence[i];
             }
 
-            std::string route{};
-            if (!route_map.empty())
+            if (config.ordered_stops_type == ColumnarFormat::Type::INT32_LIST)
+            {
+                try
+                {
+                    numeric_stops.clear();
+                    for (const auto &stop : sequence)
+                    {
+                        numeric_stops.push_back(Utils::string_view_to_numeric<std::int32_t>(stop));
+                    }
+                }
+                catch (const std::exception &)
+                {
+                    log("Non-numeric stop id in " + config.name + " route " + route_id + ", skipping...");
+                    continue;
+                }
+            }
+
+            std::string route{resolve_route_name(route_id, route_map)};
+
+            out << route << "," << headsign << "," << ordered_stops << "\n";
+
+            table.append_string(0, route);
+            table.append_string(1, headsign);
+            if (config.ordered_stops_type == ColumnarFormat::Type::INT32_LIST)
             {
-                int id{std::stoi(route_id)};
-                auto it = route_map.find(id);
-                route = (it != route_map.end() ? it->second : std::to_string(id));
+                table.append_int32_list(2, numeric_stops);
             }
             else
             {
-                route = route_id;
+                table.append_string_list(2, sequence);
             }
-
-            out << route << "," << headsign << "," << ordered_stops << "\n";
         }
 
         out.flush();
         out.close();
+
+        if (!table.write(config.routes_binary_file))
+        {
+            Utils::log_file_open_error(config.name, "routes", config.routes_binary_file);
+            return false;
+        }
+
+        return !trip_groups.empty() && static_cast<bool>(out);
     }
-}
\ No newline at end of file
+}
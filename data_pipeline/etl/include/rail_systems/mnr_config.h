@@ -8,21 +8,29 @@ SystemConfig create_mnr_config()
     return SystemConfig
     {
         .name = "mnr",
-        .station_input_file = std::string(DATA_DIRECTORY) + "/raw/gtfsmnr/stops.txt",
-        .trips_input_file = std::string(DATA_DIRECTORY) + "/raw/gtfsmnr/trips.txt",
-        .stop_times_input_file = std::string(DATA_DIRECTORY) + "/raw/gtfsmnr/stop_times.txt",
-        .routes_input_file = std::string(DATA_DIRECTORY) + "/raw/gtfsmnr/routes.txt",
+        .station_input = ZipSource{std::string(DATA_DIRECTORY) + "/zips/gtfsmnr.zip", "stops.txt"},
+        .trips_input = ZipSource{std::string(DATA_DIRECTORY) + "/zips/gtfsmnr.zip", "trips.txt"},
+        .stop_times_input = ZipSource{std::string(DATA_DIRECTORY) + "/zips/gtfsmnr.zip", "stop_times.txt"},
+        .routes_input = ZipSource{std::string(DATA_DIRECTORY) + "/zips/gtfsmnr.zip", "routes.txt"},
+        .calendar_input = std::nullopt,
+        .calendar_dates_input = ZipSource{std::string(DATA_DIRECTORY) + "/zips/gtfsmnr.zip", "calendar_dates.txt"},
 
         .station_output_file = std::string(DATA_DIRECTORY) + "/clean/mnr/stations.csv",
         .routes_output_file = std::string(DATA_DIRECTORY) + "/clean/mnr/routes.csv",
+        .station_binary_file = std::string(DATA_DIRECTORY) + "/clean/mnr/stations.bin",
+        .routes_binary_file = std::string(DATA_DIRECTORY) + "/clean/mnr/routes.bin",
+        .timetable_output_file = std::string(DATA_DIRECTORY) + "/clean/mnr/timetable.bin",
+        .manifest_file = std::string(DATA_DIRECTORY) + "/clean/mnr/manifest.csv",
 
         .station_header = "stop_id,stop_code,stop_name,latitude,longitude",
         .routes_header = "route_id,headsign,ordered_stops",
 
         .station_columns = {"stop_id", "stop_code", "stop_name", "stop_lat", "stop_lon"},
+        .station_types = {ColumnarFormat::Type::INT32, ColumnarFormat::Type::STRING, ColumnarFormat::Type::STRING, ColumnarFormat::Type::FLOAT64, ColumnarFormat::Type::FLOAT64},
         .trip_columns = {"route_id", "trip_id", "trip_headsign", "direction_id", "peak_offpeak"},
         .stop_time_columns = {"trip_id", "stop_id", "stop_sequence"},
         .route_columns = std::vector<std::string_view>{"route_id", "route_long_name"},
+        .ordered_stops_type = ColumnarFormat::Type::INT32_LIST,
 
         .trip_filter = [](const auto &row)
         {
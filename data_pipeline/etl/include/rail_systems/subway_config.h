@@ -8,21 +8,29 @@ SystemConfig create_subway_config()
     return SystemConfig
     {
         .name = "subway",
-        .station_input_file = std::string(DATA_DIRECTORY) + "/raw/mta_subway_stations.csv",
-        .trips_input_file = std::string(DATA_DIRECTORY) + "/raw/gtfs_subway/trips.txt",
-        .stop_times_input_file = std::string(DATA_DIRECTORY) + "/raw/gtfs_subway/stop_times.txt",
-        .routes_input_file = std::nullopt,
+        .station_input = ZipSource{std::string(DATA_DIRECTORY) + "/zips/mta_subway_stations.csv.zip", ""},
+        .trips_input = ZipSource{std::string(DATA_DIRECTORY) + "/zips/gtfs_subway.zip", "trips.txt"},
+        .stop_times_input = ZipSource{std::string(DATA_DIRECTORY) + "/zips/gtfs_subway.zip", "stop_times.txt"},
+        .routes_input = std::nullopt,
+        .calendar_input = ZipSource{std::string(DATA_DIRECTORY) + "/zips/gtfs_subway.zip", "calendar.txt"},
+        .calendar_dates_input = std::nullopt,
 
         .station_output_file = std::string(DATA_DIRECTORY) + "/clean/subway/stations.csv",
         .routes_output_file = std::string(DATA_DIRECTORY) + "/clean/subway/routes.csv",
+        .station_binary_file = std::string(DATA_DIRECTORY) + "/clean/subway/stations.bin",
+        .routes_binary_file = std::string(DATA_DIRECTORY) + "/clean/subway/routes.bin",
+        .timetable_output_file = std::string(DATA_DIRECTORY) + "/clean/subway/timetable.bin",
+        .manifest_file = std::string(DATA_DIRECTORY) + "/clean/subway/manifest.csv",
 
         .station_header = "complex_id,gtfs_id,stop_name,train_lines,latitude,longitude",
         .routes_header = "route_id,headsign,ordered_stops",
 
         .station_columns = {"Complex ID", "GTFS Stop ID", "Stop Name", "Daytime Routes", "GTFS Latitude", "GTFS Longitude"},
+        .station_types = {ColumnarFormat::Type::INT32, ColumnarFormat::Type::STRING, ColumnarFormat::Type::STRING, ColumnarFormat::Type::STRING_LIST, ColumnarFormat::Type::FLOAT64, ColumnarFormat::Type::FLOAT64},
         .trip_columns = {"route_id", "trip_id", "service_id", "trip_headsign"},
         .stop_time_columns = {"trip_id", "stop_id", "stop_sequence"},
         .route_columns = std::nullopt,
+        .ordered_stops_type = ColumnarFormat::Type::STRING_LIST,
 
         .trip_filter = [](const auto &row)
         {
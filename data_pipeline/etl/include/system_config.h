@@ -1,30 +1,53 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <string_view>
 #include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "utils/columnar_format.h"
 
 namespace etl
 {
+    /**
+     * a csv inside one of the downloaded archives in data/zips, read in place without extracting
+     */
+    struct ZipSource
+    {
+        std::string archive;
+        std::string member; // empty for single file archives
+    };
+
     struct SystemConfig
     {
         std::string name;
 
-        std::string station_input_file;
-        std::string trips_input_file;
-        std::string stop_times_input_file;
-        std::optional<std::string> routes_input_file;
+        ZipSource station_input;
+        ZipSource trips_input;
+        ZipSource stop_times_input;
+        std::optional<ZipSource> routes_input;
+        std::optional<ZipSource> calendar_input;       // calendar.txt, weekly service patterns
+        std::optional<ZipSource> calendar_dates_input; // calendar_dates.txt, dated service additions and removals
 
         std::string station_output_file;
         std::string routes_output_file;
+        std::string station_binary_file; // columnar copy of station_output_file read by the simulator
+        std::string routes_binary_file;  // columnar copy of routes_output_file read by the simulator
+        std::string timetable_output_file;
+        std::string manifest_file;
 
         std::string station_header;
         std::string routes_header;
 
         std::vector<std::string_view> station_columns;
+        std::vector<ColumnarFormat::Type> station_types; // binary type of each station column
         std::vector<std::string_view> trip_columns;
         std::vector<std::string_view> stop_time_columns;
         std::optional<std::vector<std::string_view>> route_columns;
+        ColumnarFormat::Type ordered_stops_type; // INT32_LIST for numeric stop ids, STRING_LIST otherwise
 
         std::function<bool(const std::unordered_map<std::string_view, std::string_view>&)> trip_filter;
         std::function<std::vector<std::string>(const std::vector<std::pair<int, std::string>> &)> transform_sequence;
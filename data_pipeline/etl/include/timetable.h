@@ -0,0 +1,454 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "system_config.h"
+#include "processor.h"
+#include "zip_archive.h"
+#include "utils/utils.h"
+#include "utils/string_pool.h"
+#include "system/timetable_format.h"
+
+namespace etl
+{
+    inline const std::vector<std::string_view> TIMETABLE_TRIP_COLUMNS{"route_id", "trip_id", "service_id", "trip_headsign"};
+    inline const std::vector<std::string_view> TIMETABLE_STOP_TIME_COLUMNS{"trip_id", "stop_id", "stop_sequence", "arrival_time", "departure_time"};
+
+    /**
+     * @param sv GTFS time "H:MM:SS", hours may exceed 23 for trips running past midnight
+     * @return seconds after midnight of the service day, or nullopt if empty or malformed
+     */
+    inline std::optional<int> parse_gtfs_time(std::string_view sv)
+    {
+        auto parts{Utils::split(Utils::trim(sv), ':')};
+        if (parts.size() != 3 || parts[0].empty())
+        {
+            return std::nullopt;
+        }
+
+        try
+        {
+            int hours{Utils::string_view_to_numeric<int>(parts[0])};
+            int minutes{Utils::string_view_to_numeric<int>(parts[1])};
+            int seconds{Utils::string_view_to_numeric<int>(parts[2])};
+            return hours * 3600 + minutes * 60 + seconds;
+        }
+        catch (const std::exception &)
+        {
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * picks the service ids running on a representative weekday
+     *
+     * with calendar.txt, services flagged for wednesday are used as the midweek pattern,
+     * with only calendar_dates.txt, the monday to friday date with the most added services is used
+     *
+     * @param config system specific configuration
+     * @param log receives the reason a calendar could not be read
+     * @return weekday service ids, or nullopt if the system has no calendar so every trip is kept
+     */
+    inline std::optional<std::unordered_set<std::string, Utils::StringHash, std::equal_to<>>> extract_weekday_services(const SystemConfig &config, const Log &log)
+    {
+        std::unordered_set<std::string, Utils::StringHash, std::equal_to<>> services{};
+
+        if (config.calendar_input.has_value())
+        {
+            open_and_parse_member(config.calendar_input->archive, config.calendar_input->member, {"service_id", "wednesday"}, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+                                  {
+                auto tokens {Utils::split(line, ',')};
+                if (tokens.size() < column_index.size())
+                {
+                    Utils::log_malformed_line(config.name, "calendar", line_num, line);
+                    return;
+                }
+
+                auto row {Utils::from_tokens(tokens, column_index)};
+                if (row.at("wednesday") == "1")
+                {
+                    services.emplace(row.at("service_id"));
+                } }, log);
+
+            return services;
+        }
+
+        if (config.calendar_dates_input.has_value())
+        {
+            std::map<int /* yyyymmdd */, std::vector<std::string>> added_by_date{};
+
+            open_and_parse_member(config.calendar_dates_input->archive, config.calendar_dates_input->member, {"service_id", "date", "exception_type"}, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+                                  {
+                auto tokens {Utils::split(line, ',')};
+                if (tokens.size() < column_index.size())
+                {
+                    Utils::log_malformed_line(config.name, "calendar dates", line_num, line);
+                    return;
+                }
+
+                auto row {Utils::from_tokens(tokens, column_index)};
+                if (row.at("exception_type") != "1")
+                {
+                    return;
+                }
+
+                int date {Utils::string_view_to_numeric<int>(row.at("date"))};
+                std::chrono::year_month_day ymd {std::chrono::year{date / 10000}, std::chrono::month{static_cast<unsigned>(date / 100 % 100)}, std::chrono::day{static_cast<unsigned>(date % 100)}};
+                if (!ymd.ok())
+                {
+                    Utils::log_malformed_line(config.name, "calendar dates", line_num, line);
+                    return;
+                }
+
+                unsigned weekday {std::chrono::weekday{std::chrono::sys_days{ymd}}.iso_encoding()};
+                if (weekday <= 5)
+                {
+                    added_by_date[date].emplace_back(row.at("service_id"));
+                } }, log);
+
+            // ordered map, so ties resolve to the earliest date
+            auto busiest{std::ranges::max_element(added_by_date, [](const auto &a, const auto &b)
+                                                  { return a.second.size() < b.second.size(); })};
+
+            if (busiest != added_by_date.end())
+            {
+                services.insert(busiest->second.begin(), busiest->second.end());
+            }
+
+            return services;
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * ingests every weekday trip with its arrival and departure times into the binary timetable,
+     * see include/system/timetable_format.h for the layout
+     *
+     * @param config system specific configuration
+     * @param log receives the reason the timetable could not be written and the trips it skipped
+     * @return true if the timetable was written with at least one trip
+     */
+    inline bool process_timetable(const SystemConfig &config, const Log &log)
+    {
+        struct StopTime
+        {
+            int stop_sequence;
+            std::uint32_t stop; // raw stop id in raw_stops
+            std::optional<int> arrival;
+            std::optional<int> departure;
+        };
+
+        struct TripRecord
+        {
+            std::uint32_t route_id; // in strings
+            std::uint32_t headsign; // in strings
+            std::vector<StopTime> stop_times;
+        };
+
+        auto weekday_services{extract_weekday_services(config, log)};
+        if (weekday_services.has_value() && weekday_services->empty())
+        {
+            log("No weekday service found in calendar for " + config.name);
+            return false;
+        }
+
+        Utils::StringPool trip_ids{}; // dense trip index, matches positions in trips
+        Utils::StringPool strings{};  // route ids and headsigns
+        Utils::StringPool raw_stops{};
+        std::vector<TripRecord> trips{};
+        std::vector<std::string_view> tokens{};
+
+        bool parsed{open_and_parse_member(config.trips_input.archive, config.trips_input.member, TIMETABLE_TRIP_COLUMNS, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+                                          {
+            Utils::split_into(line, ',', tokens);
+            if (tokens.size() < column_index.size())
+            {
+                Utils::log_malformed_line(config.name, "trips", line_num, line);
+                return;
+            }
+
+            auto field = [&](std::string_view column) { return Utils::trim(tokens[column_index.at(column)]); };
+
+            if (weekday_services.has_value() && !weekday_services->contains(field("service_id")))
+            {
+                return;
+            }
+
+            std::uint32_t trip_index {trip_ids.intern(field("trip_id"))};
+            if (trip_index == trips.size())
+            {
+                trips.push_back(TripRecord{strings.intern(field("route_id")), strings.intern(field("trip_headsign")), {}});
+            } }, log)};
+
+        parsed = parsed && open_and_parse_member(config.stop_times_input.archive, config.stop_times_input.member, TIMETABLE_STOP_TIME_COLUMNS, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+                                                 {
+            Utils::split_into(line, ',', tokens);
+            if (tokens.size() < column_index.size())
+            {
+                Utils::log_malformed_line(config.name, "stop times", line_num, line);
+                return;
+            }
+
+            auto field = [&](std::string_view column) { return Utils::trim(tokens[column_index.at(column)]); };
+
+            auto trip_index {trip_ids.find(field("trip_id"))};
+            if (!trip_index.has_value())
+            {
+                return;
+            }
+
+            trips[*trip_index].stop_times.push_back(StopTime{
+                Utils::string_view_to_numeric<int>(field("stop_sequence")),
+                raw_stops.intern(field("stop_id")),
+                parse_gtfs_time(field("arrival_time")),
+                parse_gtfs_time(field("departure_time"))}); }, log);
+
+        if (!parsed)
+        {
+            return false;
+        }
+
+        // stop codes go through the same system transform as routes.csv, once per distinct stop
+        Utils::StringPool stop_codes{};
+        std::vector<std::uint32_t> raw_to_code(raw_stops.size());
+        for (std::uint32_t raw{0}; raw < raw_stops.size(); ++raw)
+        {
+            auto transformed{config.transform_sequence({{0, std::string(raw_stops.view(raw))}})};
+            raw_to_code[raw] = stop_codes.intern(transformed.empty() ? raw_stops.view(raw) : std::string_view(transformed.front()));
+        }
+
+        auto route_map{extract_route_map(config, log)};
+        Utils::StringPool route_names{};
+        std::vector<std::uint32_t> route_of(strings.size(), std::numeric_limits<std::uint32_t>::max());
+
+        struct Encoded
+        {
+            std::uint32_t route;
+            std::uint32_t trip;
+            int start_time;
+        };
+
+        std::vector<Encoded> order{};
+        order.reserve(trips.size());
+        std::size_t skipped{};
+
+        for (std::uint32_t t{0}; t < trips.size(); ++t)
+        {
+            auto &stop_times{trips[t].stop_times};
+            std::ranges::sort(stop_times, {}, &StopTime::stop_sequence);
+
+            // non-timepoint stops may leave times blank, interpolate them by stop position
+            for (auto &stop : stop_times)
+            {
+                if (!stop.arrival.has_value())
+                {
+                    stop.arrival = stop.departure;
+                }
+                if (!stop.departure.has_value())
+                {
+                    stop.departure = stop.arrival;
+                }
+            }
+
+            if (stop_times.size() < 2 || !stop_times.front().arrival.has_value() || !stop_times.back().arrival.has_value())
+            {
+                ++skipped;
+                continue;
+            }
+
+            for (std::size_t i{1}, last_known{0}; i < stop_times.size(); ++i)
+            {
+                if (!stop_times[i].arrival.has_value())
+                {
+                    continue;
+                }
+
+                for (std::size_t j{last_known + 1}; j < i; ++j)
+                {
+                    int from{*stop_times[last_known].departure};
+                    int to{*stop_times[i].arrival};
+                    int interpolated{from + static_cast<int>((to - from) * static_cast<long long>(j - last_known) / static_cast<long long>(i - last_known))};
+                    stop_times[j].arrival = interpolated;
+                    stop_times[j].departure = interpolated;
+                }
+                last_known = i;
+            }
+
+            std::uint32_t route_id{trips[t].route_id};
+            if (route_of[route_id] == std::numeric_limits<std::uint32_t>::max())
+            {
+                route_of[route_id] = route_names.intern(resolve_route_name(std::string(strings.view(route_id)), route_map));
+            }
+
+            order.push_back(Encoded{route_of[route_id], t, *stop_times.front().arrival});
+        }
+
+        // routes sorted by name, trips by start time within a route, trip id breaks ties for a stable output
+        std::vector<std::uint32_t> route_rank(route_names.size());
+        {
+            std::vector<std::uint32_t> by_name(route_names.size());
+            for (std::uint32_t r{0}; r < by_name.size(); ++r)
+            {
+                by_name[r] = r;
+            }
+            std::ranges::sort(by_name, {}, [&](std::uint32_t r)
+                              { return route_names.view(r); });
+            for (std::uint32_t rank{0}; rank < by_name.size(); ++rank)
+            {
+                route_rank[by_name[rank]] = rank;
+            }
+        }
+
+        std::ranges::sort(order, [&](const Encoded &a, const Encoded &b)
+                          {
+            if (route_rank[a.route] != route_rank[b.route]) return route_rank[a.route] < route_rank[b.route];
+            if (a.start_time != b.start_time) return a.start_time < b.start_time;
+            return trip_ids.view(a.trip) < trip_ids.view(b.trip); });
+
+        std::string heap{};
+        Utils::StringPool heap_strings{};
+        std::vector<std::uint32_t> heap_offsets{};
+        auto store = [&](std::string_view sv)
+        {
+            std::uint32_t id{heap_strings.intern(sv)};
+            if (id == heap_offsets.size())
+            {
+                heap_offsets.push_back(static_cast<std::uint32_t>(heap.size()));
+                heap.append(sv);
+            }
+            return TimetableFormat::StringRef{heap_offsets[id], static_cast<std::uint32_t>(sv.size())};
+        };
+
+        std::vector<TimetableFormat::Route> routes(route_names.size());
+        for (std::uint32_t r{0}; r < route_names.size(); ++r)
+        {
+            routes[route_rank[r]] = TimetableFormat::Route{store(route_names.view(r)), 0, 0};
+        }
+
+        std::vector<TimetableFormat::StringRef> stops{};
+        stops.reserve(stop_codes.size());
+        for (std::uint32_t s{0}; s < stop_codes.size(); ++s)
+        {
+            stops.push_back(store(stop_codes.view(s)));
+        }
+
+        std::vector<TimetableFormat::Trip> encoded_trips{};
+        std::vector<std::uint32_t> stop_index{};
+        std::vector<std::uint16_t> arrival_deltas{};
+        std::vector<std::uint16_t> dwells{};
+        encoded_trips.reserve(order.size());
+
+        constexpr int max_delta{std::numeric_limits<std::uint16_t>::max()};
+
+        for (const Encoded &entry : order)
+        {
+            const auto &stop_times{trips[entry.trip].stop_times};
+
+            bool encodable{std::ranges::all_of(stop_times, [&, previous = entry.start_time](const StopTime &stop) mutable
+                                               {
+                int delta {*stop.arrival - previous};
+                int dwell {*stop.departure - *stop.arrival};
+                previous = *stop.departure;
+                return delta >= 0 && delta <= max_delta && dwell >= 0 && dwell <= max_delta; })};
+
+            if (!encodable)
+            {
+                ++skipped;
+                continue;
+            }
+
+            std::uint32_t rank{route_rank[entry.route]};
+            if (routes[rank].trip_count == 0)
+            {
+                routes[rank].first_trip = static_cast<std::uint32_t>(encoded_trips.size());
+            }
+            ++routes[rank].trip_count;
+
+            encoded_trips.push_back(TimetableFormat::Trip{
+                store(strings.view(trips[entry.trip].headsign)),
+                rank,
+                static_cast<std::uint32_t>(stop_index.size()),
+                static_cast<std::uint32_t>(stop_times.size()),
+                entry.start_time});
+
+            int previous{entry.start_time};
+            for (const StopTime &stop : stop_times)
+            {
+                stop_index.push_back(raw_to_code[stop.stop]);
+                arrival_deltas.push_back(static_cast<std::uint16_t>(*stop.arrival - previous));
+                dwells.push_back(static_cast<std::uint16_t>(*stop.departure - *stop.arrival));
+                previous = *stop.departure;
+            }
+        }
+
+        if (skipped > 0)
+        {
+            log("In " + config.name + " timetable, skipped " + std::to_string(skipped) + " trips with missing or out of range times");
+        }
+
+        std::ofstream out(config.timetable_output_file, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+        {
+            Utils::log_file_open_error(config.name, "timetable", config.timetable_output_file);
+            return false;
+        }
+
+        TimetableFormat::Header header{};
+        std::copy(std::begin(TimetableFormat::MAGIC), std::end(TimetableFormat::MAGIC), header.magic);
+        header.version = TimetableFormat::VERSION;
+        header.route_count = static_cast<std::uint32_t>(routes.size());
+        header.stop_count = static_cast<std::uint32_t>(stops.size());
+        header.trip_count = static_cast<std::uint32_t>(encoded_trips.size());
+        header.stop_time_count = static_cast<std::uint32_t>(stop_index.size());
+        header.string_heap_size = static_cast<std::uint32_t>(heap.size());
+
+        std::uint64_t cursor{sizeof(TimetableFormat::Header)};
+        auto place = [&](std::size_t bytes)
+        {
+            std::uint64_t offset{cursor};
+            cursor += (bytes + TimetableFormat::ALIGNMENT - 1) / TimetableFormat::ALIGNMENT * TimetableFormat::ALIGNMENT;
+            return offset;
+        };
+
+        header.routes_offset = place(routes.size() * sizeof(TimetableFormat::Route));
+        header.stops_offset = place(stops.size() * sizeof(TimetableFormat::StringRef));
+        header.trips_offset = place(encoded_trips.size() * sizeof(TimetableFormat::Trip));
+        header.stop_index_offset = place(stop_index.size() * sizeof(std::uint32_t));
+        header.arrival_delta_offset = place(arrival_deltas.size() * sizeof(std::uint16_t));
+        header.dwell_offset = place(dwells.size() * sizeof(std::uint16_t));
+        header.string_heap_offset = place(heap.size());
+
+        auto write = [&](const void *data, std::size_t bytes)
+        {
+            static constexpr char padding[TimetableFormat::ALIGNMENT]{};
+            out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+            out.write(padding, static_cast<std::streamsize>((TimetableFormat::ALIGNMENT - bytes % TimetableFormat::ALIGNMENT) % TimetableFormat::ALIGNMENT));
+        };
+
+        write(&header, sizeof(header));
+        write(routes.data(), routes.size() * sizeof(TimetableFormat::Route));
+        write(stops.data(), stops.size() * sizeof(TimetableFormat::StringRef));
+        write(encoded_trips.data(), encoded_trips.size() * sizeof(TimetableFormat::Trip));
+        write(stop_index.data(), stop_index.size() * sizeof(std::uint32_t));
+        write(arrival_deltas.data(), arrival_deltas.size() * sizeof(std::uint16_t));
+        write(dwells.data(), dwells.size() * sizeof(std::uint16_t));
+        write(heap.data(), heap.size());
+
+        out.flush();
+        out.close();
+
+        return !encoded_trips.empty() && static_cast<bool>(out);
+    }
+}
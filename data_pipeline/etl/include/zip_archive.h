@@ -0,0 +1,564 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <zlib.h>
+
+#include "utils/utils.h"
+
+namespace etl
+{
+    /**
+     * receives the error messages of a system, systems are processed on threads of their own
+     * so the sink is where writes to the shared console are serialized
+     */
+    using Log = std::function<void(const std::string &message)>;
+
+    /**
+     * minimal zip reader over the central directory, members are inflated in fixed size blocks
+     * and handed to a callback so GTFS files never need to be extracted to disk
+     *
+     * supports stored and deflated members, including zip64 sizes and offsets
+     */
+    class ZipArchive
+    {
+    public:
+        struct Entry
+        {
+            std::string name;
+            std::uint16_t flags;
+            std::uint16_t method;
+            std::uint32_t crc;
+            std::uint64_t compressed_size;
+            std::uint64_t uncompressed_size;
+            std::uint64_t local_header_offset;
+        };
+
+        using BlockCallback = std::function<bool(std::string_view block)>;
+
+    private:
+        static constexpr std::uint32_t LOCAL_HEADER_SIGNATURE{0x04034b50};
+        static constexpr std::uint32_t CENTRAL_HEADER_SIGNATURE{0x02014b50};
+        static constexpr std::uint32_t END_OF_DIRECTORY_SIGNATURE{0x06054b50};
+        static constexpr std::uint32_t ZIP64_END_OF_DIRECTORY_SIGNATURE{0x06064b50};
+        static constexpr std::uint32_t ZIP64_LOCATOR_SIGNATURE{0x07064b50};
+
+        static constexpr std::uint16_t METHOD_STORED{0};
+        static constexpr std::uint16_t METHOD_DEFLATED{8};
+        static constexpr std::size_t BLOCK_SIZE{1 << 18};
+
+        std::string path;
+        std::ifstream file;
+        std::vector<Entry> entries;
+        Log log;
+
+    public:
+        /**
+         * @param archive_path path of the zip file
+         * @param log receives the errors of opening and streaming the archive
+         * @return archive with its central directory loaded, or nullopt if the file is missing or not a zip
+         */
+        static std::optional<ZipArchive> open(const std::string &archive_path, const Log &log)
+        {
+            ZipArchive archive{archive_path, log};
+            if (!archive.file)
+            {
+                log("Failed to open: " + archive_path);
+                return std::nullopt;
+            }
+
+            if (!archive.read_central_directory())
+            {
+                log("Invalid or unsupported zip archive: " + archive_path);
+                return std::nullopt;
+            }
+
+            return archive;
+        }
+
+        const std::vector<Entry> &get_entries() const
+        {
+            return entries;
+        }
+
+        /**
+         * finds a member by exact name, falling back to a basename match for archives that nest files in a folder,
+         * an empty name selects the only member of a single file archive
+         */
+        const Entry *find(std::string_view member) const
+        {
+            if (member.empty())
+            {
+                return entries.size() == 1 ? &entries.front() : nullptr;
+            }
+
+            auto it{std::ranges::find(entries, member, &Entry::name)};
+            if (it != entries.end())
+            {
+                return &*it;
+            }
+
+            it = std::ranges::find_if(entries, [&](const Entry &entry)
+                                      {
+                std::string_view name {entry.name};
+                return name.size() > member.size() && name.ends_with(member) && name[name.size() - member.size() - 1] == '/'; });
+
+            return it != entries.end() ? &*it : nullptr;
+        }
+
+        /**
+         * inflates a member block by block, verifying its crc once complete
+         *
+         * @param entry member to read, obtained from find()
+         * @param callback receives each block of uncompressed data, returning false stops the stream early
+         * @return true if the member was read completely and passed the crc check, or the callback stopped it
+         */
+        bool stream(const Entry &entry, const BlockCallback &callback)
+        {
+            if (entry.flags & 0x1)
+            {
+                log("Encrypted zip member " + entry.name + " in " + path + " is not supported");
+                return false;
+            }
+
+            std::optional<std::uint64_t> data_offset{locate_data(entry)};
+            if (!data_offset.has_value())
+            {
+                log("Corrupt local header for " + entry.name + " in " + path);
+                return false;
+            }
+
+            file.clear();
+            file.seekg(static_cast<std::streamoff>(*data_offset));
+
+            switch (entry.method)
+            {
+            case METHOD_STORED:
+                return stream_stored(entry, callback);
+            case METHOD_DEFLATED:
+                return stream_deflated(entry, callback);
+            default:
+                log("Unsupported compression method " + std::to_string(entry.method) + " for " + entry.name + " in " + path);
+                return false;
+            }
+        }
+
+    private:
+        ZipArchive(const std::string &p, const Log &l) : path(p), file(p, std::ios::binary), log(l) {}
+
+        static std::uint16_t read_16(const unsigned char *p)
+        {
+            return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+        }
+
+        static std::uint32_t read_32(const unsigned char *p)
+        {
+            return static_cast<std::uint32_t>(read_16(p)) | (static_cast<std::uint32_t>(read_16(p + 2)) << 16);
+        }
+
+        static std::uint64_t read_64(const unsigned char *p)
+        {
+            return static_cast<std::uint64_t>(read_32(p)) | (static_cast<std::uint64_t>(read_32(p + 4)) << 32);
+        }
+
+        bool read_at(std::uint64_t offset, std::vector<unsigned char> &buffer)
+        {
+            file.clear();
+            file.seekg(static_cast<std::streamoff>(offset));
+            file.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            return file.gcount() == static_cast<std::streamsize>(buffer.size());
+        }
+
+        bool read_central_directory()
+        {
+            file.seekg(0, std::ios::end);
+            std::uint64_t file_size{static_cast<std::uint64_t>(file.tellg())};
+
+            // end of central directory record is 22 bytes followed by an optional comment of up to 64KB
+            constexpr std::uint64_t eocd_size{22};
+            if (file_size < eocd_size)
+            {
+                return false;
+            }
+
+            std::uint64_t tail_size{std::min<std::uint64_t>(file_size, eocd_size + 0xFFFF)};
+            std::vector<unsigned char> tail(tail_size);
+            if (!read_at(file_size - tail_size, tail))
+            {
+                return false;
+            }
+
+            std::optional<std::uint64_t> eocd_position{};
+            for (std::uint64_t i{tail_size - eocd_size + 1}; i-- > 0;)
+            {
+                if (read_32(tail.data() + i) == END_OF_DIRECTORY_SIGNATURE)
+                {
+                    eocd_position = i;
+                    break;
+                }
+            }
+
+            if (!eocd_position.has_value())
+            {
+                return false;
+            }
+
+            const unsigned char *eocd{tail.data() + *eocd_position};
+            std::uint64_t entry_count{read_16(eocd + 10)};
+            std::uint64_t directory_size{read_32(eocd + 12)};
+            std::uint64_t directory_offset{read_32(eocd + 16)};
+
+            if (entry_count == 0xFFFF || directory_size == 0xFFFFFFFF || directory_offset == 0xFFFFFFFF)
+            {
+                std::uint64_t eocd_file_position{file_size - tail_size + *eocd_position};
+                if (eocd_file_position < 20)
+                {
+                    return false;
+                }
+
+                std::vector<unsigned char> locator(20);
+                if (!read_at(eocd_file_position - 20, locator) || read_32(locator.data()) != ZIP64_LOCATOR_SIGNATURE)
+                {
+                    return false;
+                }
+
+                std::vector<unsigned char> zip64_eocd(56);
+                if (!read_at(read_64(locator.data() + 8), zip64_eocd) || read_32(zip64_eocd.data()) != ZIP64_END_OF_DIRECTORY_SIGNATURE)
+                {
+                    return false;
+                }
+
+                entry_count = read_64(zip64_eocd.data() + 32);
+                directory_size = read_64(zip64_eocd.data() + 40);
+                directory_offset = read_64(zip64_eocd.data() + 48);
+            }
+
+            if (directory_offset + directory_size > file_size)
+            {
+                return false;
+            }
+
+            std::vector<unsigned char> directory(directory_size);
+            if (!read_at(directory_offset, directory))
+            {
+                return false;
+            }
+
+            entries.reserve(entry_count);
+
+            std::size_t position{};
+            for (std::uint64_t i{0}; i < entry_count; ++i)
+            {
+                constexpr std::size_t header_size{46};
+                if (position + header_size > directory.size() || read_32(directory.data() + position) != CENTRAL_HEADER_SIGNATURE)
+                {
+                    return false;
+                }
+
+                const unsigned char *header{directory.data() + position};
+                std::uint16_t name_length{read_16(header + 28)};
+                std::uint16_t extra_length{read_16(header + 30)};
+                std::uint16_t comment_length{read_16(header + 32)};
+
+                if (position + header_size + name_length + extra_length + comment_length > directory.size())
+                {
+                    return false;
+                }
+
+                Entry entry{
+                    std::string(reinterpret_cast<const char *>(header + header_size), name_length),
+                    read_16(header + 8),
+                    read_16(header + 10),
+                    read_32(header + 16),
+                    read_32(header + 20),
+                    read_32(header + 24),
+                    read_32(header + 42)};
+
+                apply_zip64_extra(entry, header + header_size + name_length, extra_length);
+
+                if (!entry.name.ends_with('/'))
+                {
+                    entries.push_back(std::move(entry));
+                }
+
+                position += header_size + name_length + extra_length + comment_length;
+            }
+
+            return true;
+        }
+
+        // zip64 extended information only lists the fields saturated in the regular header, in this order
+        static void apply_zip64_extra(Entry &entry, const unsigned char *extra, std::uint16_t length)
+        {
+            std::size_t position{};
+            while (position + 4 <= length)
+            {
+                std::uint16_t id{read_16(extra + position)};
+                std::uint16_t size{read_16(extra + position + 2)};
+                const unsigned char *data{extra + position + 4};
+
+                if (id == 0x0001)
+                {
+                    std::size_t field{};
+                    auto next = [&](std::uint64_t &value)
+                    {
+                        if (value == 0xFFFFFFFF && field + 8 <= size)
+                        {
+                            value = read_64(data + field);
+                            field += 8;
+                        }
+                    };
+
+                    next(entry.uncompressed_size);
+                    next(entry.compressed_size);
+                    next(entry.local_header_offset);
+                    return;
+                }
+
+                position += 4 + size;
+            }
+        }
+
+        std::optional<std::uint64_t> locate_data(const Entry &entry)
+        {
+            std::vector<unsigned char> header(30);
+            if (!read_at(entry.local_header_offset, header) || read_32(header.data()) != LOCAL_HEADER_SIGNATURE)
+            {
+                return std::nullopt;
+            }
+
+            // local name and extra lengths may differ from the central directory copy
+            return entry.local_header_offset + header.size() + read_16(header.data() + 26) + read_16(header.data() + 28);
+        }
+
+        bool verify(const Entry &entry, std::uint32_t crc, std::uint64_t produced)
+        {
+            if (crc != entry.crc || produced != entry.uncompressed_size)
+            {
+                log("Checksum mismatch for " + entry.name + " in " + path);
+                return false;
+            }
+
+            return true;
+        }
+
+        bool stream_stored(const Entry &entry, const BlockCallback &callback)
+        {
+            std::string block(BLOCK_SIZE, '\0');
+            std::uint64_t remaining{entry.compressed_size};
+            std::uint32_t crc{static_cast<std::uint32_t>(crc32(0L, Z_NULL, 0))};
+
+            while (remaining > 0)
+            {
+                std::size_t chunk{static_cast<std::size_t>(std::min<std::uint64_t>(remaining, block.size()))};
+                file.read(block.data(), static_cast<std::streamsize>(chunk));
+                if (file.gcount() != static_cast<std::streamsize>(chunk))
+                {
+                    log("Unexpected end of data for " + entry.name + " in " + path);
+                    return false;
+                }
+
+                crc = static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<const Bytef *>(block.data()), static_cast<uInt>(chunk)));
+                remaining -= chunk;
+
+                if (!callback(std::string_view(block.data(), chunk)))
+                {
+                    return true;
+                }
+            }
+
+            return verify(entry, crc, entry.compressed_size);
+        }
+
+        bool stream_deflated(const Entry &entry, const BlockCallback &callback)
+        {
+            z_stream stream{};
+            if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) // raw deflate, zip members carry no zlib header
+            {
+                log("Failed to initialize inflate for " + entry.name + " in " + path);
+                return false;
+            }
+
+            std::string input(BLOCK_SIZE, '\0');
+            std::string output(BLOCK_SIZE, '\0');
+            std::uint64_t remaining{entry.compressed_size};
+            std::uint64_t produced{};
+            std::uint32_t crc{static_cast<std::uint32_t>(crc32(0L, Z_NULL, 0))};
+            int status{Z_OK};
+
+            while (status != Z_STREAM_END)
+            {
+                if (stream.avail_in == 0)
+                {
+                    if (remaining == 0)
+                    {
+                        break;
+                    }
+
+                    std::size_t chunk{static_cast<std::size_t>(std::min<std::uint64_t>(remaining, input.size()))};
+                    file.read(input.data(), static_cast<std::streamsize>(chunk));
+                    if (file.gcount() != static_cast<std::streamsize>(chunk))
+                    {
+                        break;
+                    }
+
+                    remaining -= chunk;
+                    stream.next_in = reinterpret_cast<Bytef *>(input.data());
+                    stream.avail_in = static_cast<uInt>(chunk);
+                }
+
+                stream.next_out = reinterpret_cast<Bytef *>(output.data());
+                stream.avail_out = static_cast<uInt>(output.size());
+
+                status = inflate(&stream, Z_NO_FLUSH);
+                if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+                {
+                    break;
+                }
+
+                std::size_t inflated{output.size() - stream.avail_out};
+                if (inflated > 0)
+                {
+                    crc = static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<const Bytef *>(output.data()), static_cast<uInt>(inflated)));
+                    produced += inflated;
+
+                    if (!callback(std::string_view(output.data(), inflated)))
+                    {
+                        inflateEnd(&stream);
+                        return true;
+                    }
+                }
+            }
+
+            inflateEnd(&stream);
+
+            if (status != Z_STREAM_END)
+            {
+                log("Failed to inflate " + entry.name + " in " + path);
+                return false;
+            }
+
+            return verify(entry, crc, produced);
+        }
+    };
+
+    /**
+     * streaming counterpart of Utils::open_and_parse for a csv member of a zip archive,
+     * lines that straddle two inflated blocks are stitched together before being handed to the callback
+     *
+     * @param archive_path path of the zip file
+     * @param member name of the csv inside the archive, empty for single file archives
+     * @param required_columns columns that must be present in the header
+     * @param callback invoked for every line after the header with the column index and line number
+     * @param log receives the reason the member could not be read
+     * @return true if the member was found, had every required column and was read completely
+     */
+    inline bool open_and_parse_member(const std::string &archive_path, std::string_view member, const std::vector<std::string_view> &required_columns, const std::function<void(std::string_view, const std::unordered_map<std::string_view, int> &, int)> &callback, const Log &log)
+    {
+        auto archive{ZipArchive::open(archive_path, log)};
+        if (!archive.has_value())
+        {
+            return false;
+        }
+
+        const ZipArchive::Entry *entry{archive->find(member)};
+        if (entry == nullptr)
+        {
+            log("Missing member " + std::string(member.empty() ? "<single file>" : member) + " in archive " + archive_path);
+            return false;
+        }
+
+        std::string header{}; // owns the column names referenced by column_index
+        std::unordered_map<std::string_view, int> column_index{};
+        bool header_read{false};
+        bool columns_ok{true};
+        int line_num{2};
+
+        auto handle_line = [&](std::string_view line)
+        {
+            if (header_read)
+            {
+                callback(line, column_index, line_num);
+                ++line_num;
+                return true;
+            }
+
+            header = std::string(line);
+            header_read = true;
+
+            auto headers = Utils::split(header, ',');
+            for (int i = 0; i < headers.size(); ++i)
+            {
+                column_index[Utils::trim(headers[i])] = i;
+            }
+
+            for (const auto &column : required_columns)
+            {
+                if (!column_index.contains(column))
+                {
+                    log("Missing column " + std::string(column) + " in " + entry->name + " of " + archive_path);
+                    columns_ok = false;
+                }
+            }
+
+            return columns_ok;
+        };
+
+        std::string carry{};
+        bool streamed{archive->stream(*entry, [&](std::string_view block)
+                                      {
+            std::size_t line_start{0};
+            while (line_start < block.size())
+            {
+                std::size_t line_end{block.find('\n', line_start)};
+                if (line_end == std::string_view::npos)
+                {
+                    carry.append(block.substr(line_start));
+                    break;
+                }
+
+                std::string_view line{block.substr(line_start, line_end - line_start)};
+                if (!carry.empty())
+                {
+                    carry.append(line);
+                    line = carry;
+                }
+
+                bool keep_going{handle_line(line)};
+                carry.clear();
+                line_start = line_end + 1;
+
+                if (!keep_going)
+                {
+                    return false;
+                }
+            }
+            return true; })};
+
+        if (!streamed || !columns_ok)
+        {
+            return false;
+        }
+
+        if (!carry.empty())
+        {
+            handle_line(carry);
+        }
+
+        if (!header_read)
+        {
+            log("Missing header in " + entry->name + " of " + archive_path);
+            return false;
+        }
+
+        return columns_ok;
+    }
+}
@@ -1,16 +1,109 @@
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 
 #include "config.h"
 
 #include "processor.h"
+#include "timetable.h"
+#include "manifest.h"
 
 #include "rail_systems/subway_config.h"
 #include "rail_systems/mnr_config.h"
 #include "rail_systems/lirr_config.h"
 
+/**
+ * rebuilds the outputs of a single rail system whose inputs or config changed since the last run
+ *
+ * @param system system specific configuration
+ * @param output_mutex guards console output shared between system threads
+ * @return true if every output is up to date after the run
+ */
+bool run_system(const etl::SystemConfig &system, std::mutex &output_mutex)
+{
+    auto log = [&](const std::string &message)
+    {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::cout << message << "\n";
+    };
+
+    etl::Log log_error{[&](const std::string &message)
+                       {
+                           std::lock_guard<std::mutex> lock(output_mutex);
+                           std::cerr << message << "\n";
+                       }};
+
+    std::filesystem::create_directories(std::filesystem::path(system.station_output_file).parent_path());
+    std::filesystem::create_directories(std::filesystem::path(system.routes_output_file).parent_path());
+    std::filesystem::create_directories(std::filesystem::path(system.timetable_output_file).parent_path());
+
+    etl::Manifest manifest{etl::Manifest::load(system.manifest_file)};
+
+    auto run_stage = [&](const std::string &stage, const std::vector<std::string> &output_files, const std::vector<etl::ZipSource> &inputs, const std::function<bool(const etl::SystemConfig &, const etl::Log &)> &process)
+    {
+        auto fingerprints{etl::fingerprint(system, inputs, log_error)};
+        if (!fingerprints.has_value())
+        {
+            log("[ERROR] missing archive input for " + stage + " of " + system.name);
+            manifest.invalidate(stage);
+            return false;
+        }
+
+        bool outputs_exist{std::ranges::all_of(output_files, [](const std::string &output_file)
+                                               { return std::filesystem::exists(output_file); })};
+
+        if (outputs_exist && manifest.is_current(stage, *fingerprints))
+        {
+            log("[SKIPPING] " + stage + " inputs unchanged for " + system.name);
+            return true;
+        }
+
+        log("[PROCESSING] " + stage + " for " + system.name + "...");
+        if (!process(system, log_error))
+        {
+            log("[ERROR] failed to process " + stage + " for " + system.name);
+            manifest.invalidate(stage);
+            return false;
+        }
+
+        manifest.record(stage, *fingerprints);
+        return true;
+    };
+
+    std::vector<etl::ZipSource> route_inputs{system.trips_input, system.stop_times_input};
+    if (system.routes_input.has_value())
+    {
+        route_inputs.push_back(*system.routes_input);
+    }
+
+    std::vector<etl::ZipSource> timetable_inputs{route_inputs};
+    for (const auto &calendar : {system.calendar_input, system.calendar_dates_input})
+    {
+        if (calendar.has_value())
+        {
+            timetable_inputs.push_back(*calendar);
+        }
+    }
+
+    bool stations_ok{run_stage("stations", {system.station_output_file, system.station_binary_file}, {system.station_input}, etl::process_stations)};
+    bool routes_ok{run_stage("routes", {system.routes_output_file, system.routes_binary_file}, route_inputs, etl::process_routes)};
+    bool timetable_ok{run_stage("timetable", {system.timetable_output_file}, timetable_inputs, etl::process_timetable)};
+
+    if (!manifest.save(system.manifest_file))
+    {
+        log("[ERROR] could not write manifest for " + system.name);
+        return false;
+    }
+
+    return stations_ok && routes_ok && timetable_ok;
+}
+
 int main()
 {
     std::filesystem::create_directories(LOG_DIRECTORY);
@@ -22,33 +115,36 @@ int main()
         get_lirr_config()
     };
 
-    for (const auto &system : systems)
-    {
-        auto station_out_path = std::filesystem::path(system.station_output_file);
-        auto routes_out_path = std::filesystem::path(system.routes_output_file);
+    std::mutex output_mutex{};
+    std::atomic<bool> failed{false};
 
-        std::filesystem::create_directories(station_out_path.parent_path());
+    // systems share no inputs or outputs, so each is rebuilt independently in its own thread
+    std::vector<std::thread> threads{};
+    threads.reserve(systems.size());
 
-        if (std::filesystem::exists(system.station_output_file))
+    for (const auto &system : systems)
+    {
+        threads.emplace_back([&]()
+                             {
+        try
         {
-            std::cout << "[SKIPPING] cleaned station file already exists for " << system.name << "\n";
+            if (!run_system(system, output_mutex))
+            {
+                failed.store(true);
+            }
         }
-        else
+        catch (const std::exception &e)
         {
-            std::cout << "[PROCESSING] stations for " << system.name << "...\n";
-            etl::process_stations(system);
-        }
+            std::lock_guard<std::mutex> lock(output_mutex);
+            std::cerr << "[ERROR] ETL failed for system " << system.name << ": " << e.what() << "\n";
+            failed.store(true);
+        } });
+    }
 
-        if (std::filesystem::exists(system.routes_output_file))
-        {
-            std::cout << "[SKIPPING] cleaned routes file already exists for " << system.name << "\n";
-        }
-        else
-        {
-            std::cout << "[PROCESSING] routes for " << system.name << "...\n";
-            etl::process_routes(system);
-        }
+    for (auto &t : threads)
+    {
+        t.join();
     }
 
-    return 0;
-}
\ No newline at end of file
+    return failed.load() ? 1 : 0;
+}
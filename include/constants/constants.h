@@ -19,6 +19,21 @@ namespace Constants
     inline constexpr int DEFAULT_YARD_HEADWAY{6};
     inline constexpr int MAX_TRACK_DURATION{4};
 
+    inline constexpr bool SCHEDULE_FROM_TIMETABLE{false}; // build schedules from data/clean/<system>/timetable.bin when present
+    inline constexpr int TIMETABLE_SECONDS_PER_TICK{60};
+    inline constexpr bool WRITE_SCHEDULE_JSON{true}; // convert schedule.bin to a human-readable schedule.json after writing
+    inline constexpr bool CACHE_SCHEDULE{true};      // reuse schedule.bin and routes.bin when the scheduler inputs are unchanged
+
+    inline constexpr bool SCHEDULE_SERVICE_DAY{false}; // plan a full service day from headway profiles instead of one run per train
+    inline constexpr int SERVICE_DAY_TICKS{1440};
+    inline constexpr int DEFAULT_TURNAROUND_TIME{4};
+
+    inline constexpr bool VALIDATE_SCHEDULE{true}; // check the loaded schedule for platform, block, and headway conflicts
+    inline constexpr int MINIMUM_HEADWAY{2};
+
+    inline constexpr bool EVENT_DRIVEN{true}; // wake trains, repairs, and spawns when they are due and skip ticks without work
+    inline constexpr int WORKER_THREADS{0};    // threads running the ticks of every system, the main thread included, 0 for one per core
+
     inline constexpr double PLATFORM_DELAY_PROBABILITY{0.3};
     inline constexpr double SIGNAL_FAILURE_PROBABILITY{0.05};
     inline constexpr double SWITCH_FAILURE_PROBABILITY{0.02};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <queue>
 #include <string>
 #include <map>
@@ -11,9 +12,12 @@
 #include "map/graph.h"
 #include "core/train.h"
 #include "core/switch.h"
+#include "core/signal_propagator.h"
+#include "core/timing_wheel.h"
 #include "system/logger.h"
 #include "system/factory.h"
 #include "system/registry.h"
+#include "system/schedule_index.h"
 
 class Dispatch;
 
@@ -31,17 +35,22 @@ struct SwitchRequest
 class AgencyControl
 {
 private:
+    std::unique_ptr<ScheduleIndex> schedule_index; // mapped for the lifetime of the dispatchers that derive events from it
     std::vector<std::unique_ptr<Dispatch>> dispatchers;
     std::unordered_set<Dispatch*> active_dispatchers;
+    std::vector<Dispatch *> running; // active dispatchers of the current tick in the order they were issued
     std::string system_name;
     std::unique_ptr<Factory> factory;
     std::unique_ptr<Logger> logger;
+    std::unique_ptr<SignalPropagator> signal_propagator;
+    TimingWheel timers; // repairs and dwell of the whole system
+    std::vector<std::uint8_t> shared_tracks; // by track id, tracks that more than one line runs on
     Constants::System system_code;
     int current_tick;
 
-    std::unordered_set<Switch *> failed_switches;
     std::unordered_map<Switch *, std::multimap<int /* priority */, SwitchRequest, std::greater<int>>> switch_requests;
     std::unordered_map<Dispatch *, std::vector<std::pair<Train *, Track *>>> granted_links;
+    std::unordered_map<Signal *, std::pair<TimingWheel::Handle, TrainLine>> signal_repairs; // failed signals of every line, the timer that repairs each and the line that failed it last
     std::unordered_map<Train *, std::pair<Switch *, std::multimap<int /* priority */, SwitchRequest>::iterator>> train_to_request;
 
     bool simulation_complete;
@@ -52,15 +61,59 @@ public:
 
     std::string get_system_name() const;
     Dispatch *get_dispatch(TrainLine train_line) const;
+    TimingWheel &get_timers();
     std::vector<std::pair<Train *, Track *>> get_granted_links(Dispatch *dispatch);
 
     void inactivate(Dispatch* dispatch);
+
+    /**
+     * runs a whole tick on the calling thread, the same as prepare_tick, authorize_line for every line, and finish_tick
+     */
     void run(int tick);
 
+    /**
+     * fires due timers and prepares the active lines, before any line of the tick is authorized
+     */
+    void prepare_tick(int tick);
+
+    /**
+     * authorizes the trains of one active line, lines of a system can be authorized at the same time
+     * @param line below get_line_count(), lines past the number active this tick have nothing to do
+     */
+    void authorize_line(std::size_t line, int tick);
+
+    /**
+     * settles shared track claims, submits switch requests, resolves switches, and executes movement,
+     * once every line of the tick is authorized
+     */
+    void finish_tick(int tick);
+
+    std::size_t get_line_count() const;
+
+    /**
+     * @return tick of the next run with work to do, the next tick unless Constants::EVENT_DRIVEN,
+     * the maximum int once the simulation is complete
+     */
+    int next_event_tick() const;
+
     void request_switch(Train *train, Switch *sw, Track *from, Track *to, int priority, int tick, Dispatch *dispatch);
+
+    /**
+     * fails a signal and schedules its repair, signals are shared between lines so a signal failed again by
+     * any line before its repair has the one pending repair started over
+     */
+    void fail_signal(int tick, Signal *signal, int time_to_repair, TrainLine train_line);
+
     void resolve_switches();
 
 private:
+    /**
+     * trains of different lines authorized into the same shared track are settled in favor of the train in the
+     * lowest slot, the train serial execution in issue order would have moved
+     */
+    void settle_claims();
+
     void run_factory(const Transit::Map::Graph &graph, const Registry &r);
     void issue_dispatchers();
+    void validate_schedule() const;
 };
\ No newline at end of file
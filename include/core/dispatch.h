@@ -6,31 +6,37 @@
 #pragma once
 
 #include <vector>
-#include <unordered_set>
+#include <deque>
+#include <cstdint>
 #include <unordered_map>
 #include <variant>
 #include <optional>
 #include <map>
 #include <memory>
+#include <span>
 
 #include "enum/event_type.h"
 #include "core/train.h"
 #include "core/track.h"
 #include "core/platform.h"
+#include "core/line_topology.h"
+#include "core/signal_propagator.h"
+#include "core/timing_wheel.h"
 #include "core/station.h"
 #include "system/logger.h"
+#include "system/schedule_index.h"
 
 class AgencyControl;
 
 struct Event
 {
     int tick;
-    int train_id;
+    TrainId train_id;
     int station_id;
     Direction direction;
     EventType type;
 
-    Event(int t, int t_id, int s_id, Direction dir, EventType ty) : tick(t), train_id(t_id), station_id(s_id), direction(dir), type(ty) {}
+    Event(int t, TrainId t_id, int s_id, Direction dir, EventType ty) : tick(t), train_id(t_id), station_id(s_id), direction(dir), type(ty) {}
 
     bool operator<(const Event &other) const
     {
@@ -38,10 +44,15 @@ struct Event
     }
 };
 
-struct EventQueues
+/**
+ * released arrivals and departures of one train in the order it reaches them, departures from yards are kept
+ * with the yard instead since a train is spawned for them rather than matched against them
+ */
+struct TrainSchedule
 {
-    std::multimap<int /* tick */, Event> arrivals;
-    std::multimap<int /* tick */, Event> departures;
+    std::vector<Event> stops;
+    std::size_t cursor{0}; // next stop the train is expected at
+    std::deque<const ScheduleFormat::Trip *> runs; // released trips the train has not spawned for yet, in order
 };
 
 class Dispatch
@@ -50,35 +61,91 @@ private:
     std::unordered_map<int, Station *> stations;
     std::vector<Station *> yards;
     std::vector<Train *> trains;
-    std::unordered_set<Train*> finished_trains;
-    std::unordered_set<Signal *> failed_signals;
+    std::vector<Train *> active_trains; // spawned and not yet back in a yard, in slot order
+    std::vector<std::vector<std::uint32_t>> train_index; // into trains, by direction code and then instance of the train id
+    StateStore *train_state{nullptr};
+    std::pair<std::size_t, std::size_t> train_slots{}; // [first, last) slots of the trains in train_state
+    std::size_t finished_trains{0};
     std::vector<std::pair<Train *, Track *>> authorized;
-    std::unordered_map<int, EventQueues> schedule;
+    std::vector<std::pair<Train *, Track *>> switch_claims; // trains waiting on the inbound switch of a track, submitted after authorizing
+    std::vector<std::pair<Signal *, int /* time to repair */>> signal_failures; // drawn while authorizing, applied on submit
+    std::vector<Train *> moved_trains;
+    std::vector<Train *> ready_trains; // event driven, active trains without dwell left in slot order
+    std::vector<TrainSchedule> train_schedules; // by train, in the slot order of trains
+    std::unordered_map<int, std::multimap<int /* tick */, Event>> yard_departures;
+    std::vector<const ScheduleFormat::Trip *> pending_trips; // sorted by start tick, events are derived once a trip starts
+    std::size_t next_trip{0};
+    std::unordered_map<TrainId, int> remaining_trips;
+    const ScheduleIndex *schedule_index{nullptr};
 
     AgencyControl *agency_control;
     Logger *logger;
     TrainLine train_line;
+    const LineTopology *topology; // owned by the factory
+    SignalPropagator *signal_propagator; // shared by the dispatchers of the system
 
 public:
-    Dispatch(AgencyControl *ac, TrainLine tl, const std::vector<Station *> &st, const std::vector<Train *> &tn, Logger *log);
+    Dispatch(AgencyControl *ac, TrainLine tl, std::span<Station *const> st, std::span<Train *const> tn, const LineTopology &topo, SignalPropagator *sp, Logger *log);
 
     TrainLine get_train_line() const;
     const std::unordered_map<int, Station *> &get_stations() const;
     const std::vector<Train *> &get_trains() const;
+    const std::vector<Train *> &get_active_trains() const;
     const std::vector<std::pair<Train *, Track *>> &get_authorizations() const;
-    const std::unordered_map<int, EventQueues> &get_station_schedules() const;
+    const std::vector<TrainSchedule> &get_train_schedules() const;
+    const std::unordered_map<int, std::multimap<int, Event>> &get_yard_departures() const;
+
+    void load_schedule(const ScheduleIndex &index);
 
-    void load_schedule();
+    /**
+     * the three phases of authorizing a tick in order, for a line run on its own
+     */
     void authorize(int tick);
+
+    /**
+     * releases trips and spawns trains, which occupies yard platforms other lines may share
+     */
+    void prepare(int tick);
+
+    /**
+     * picks the trains that can move without touching state outside of the line, switch requests and signal
+     * failures are buffered, so lines of one system can authorize at the same time once they are prepared
+     */
+    void authorize_trains(int tick);
+
+    /**
+     * applies the buffered signal failures and requests the buffered switches from AgencyControl
+     */
+    void submit(int tick);
+
+    /**
+     * drops the authorization of a train that lost its block to a train of another line
+     */
+    void withdraw(Train *train);
+
     void execute(int tick);
 
+    /**
+     * @return earliest tick after tick at which the line has a waiting train, spawn, or trip due, the maximum
+     * int when it has none, timers are accounted for by AgencyControl
+     */
+    int next_event_tick(int tick) const;
+
 private:
-    void handle_signal_state(int tick, Signal *signal, bool set_red = false);
-    bool needs_yellow_signal(Track *track);
-    std::optional<Event> process_event(int tick, std::multimap<int, Event> &queue, Train *train);
+    std::optional<Event> process_event(Train *train, int station_id, EventType type);
+
+    Train *find_train(TrainId train_id) const;
+    void activate(Train *train);
+    void deactivate(Train *train);
+
+    void collect_ready_trains();
+    void schedule_wakeup(int tick, int from_tick, Train *train);
+    void set_ready(Train *train);
 
+    void release_trips(int tick);
     void handle_spawns(int tick);
     bool spawn_train(int tick, const Event &event);
+    void begin_run(Train *train);
     void despawn_train(int tick, const Event &event, Train *train, const Station *yard);
 
     void check_completion(int tick);
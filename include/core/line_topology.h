@@ -0,0 +1,66 @@
+/**
+ * for details on design, see:
+ * docs/core/line_topology.md
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "enum/transit_types.h"
+
+class Track;
+class Platform;
+class Station;
+
+/**
+ * successors, predecessors, and platforms of one train line, built once the network is frozen so
+ * lookups on the tick path index arrays instead of filtering the connections of every track
+ */
+class LineTopology
+{
+private:
+    // compressed rows indexed by track id, the candidates of a track are targets[offsets[id], offsets[id + 1])
+    struct Adjacency
+    {
+        std::vector<std::uint32_t> offsets{0};
+        std::vector<Track *> targets;
+
+        std::span<Track *const> of(const Track *track) const;
+    };
+
+    TrainLine train_line;
+    std::vector<Track *> tracks; // tracks and platforms that support the line
+    Adjacency successors;
+    Adjacency predecessors;
+    std::unordered_map<std::int64_t, std::vector<Platform *>> platforms; // keyed by station id and direction
+
+    static std::int64_t platform_key(int station_id, const Direction &direction);
+    static Track *select(std::span<Track *const> candidates);
+
+public:
+    /**
+     * @param tracks every track and platform of the system indexed by track id
+     */
+    LineTopology(TrainLine tl, std::span<Track *const> all_tracks, std::span<Station *const> stations);
+
+    TrainLine get_train_line() const;
+    std::span<Track *const> get_tracks() const;
+
+    std::span<Track *const> get_next_tracks(const Track *track) const;
+    std::span<Track *const> get_prev_tracks(const Track *track) const;
+
+    /**
+     * same choice as Track::get_next_track, the first free candidate or else the last occupied one
+     */
+    Track *get_next_track(const Track *track) const;
+    Track *get_prev_track(const Track *track) const;
+
+    /**
+     * same platforms and order as Station::select_platforms without building a vector
+     */
+    std::span<Platform *const> get_platforms(const Station *station, const Direction &direction) const;
+};
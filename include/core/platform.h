@@ -14,7 +14,7 @@ private:
     Direction direction;
 
 public:
-    Platform(int i, Signal *si, const Station *st, Direction dir, int dw = 2, std::unordered_set<TrainLine> lines = {});
+    Platform(int i, Signal *si, const Station *st, Direction dir, int dw = 2, std::unordered_set<TrainLine> lines = {}, StateStore *ss = nullptr);
 
     const Station *get_station() const;
     virtual const Direction &get_direction() const;
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
+
+#include "core/state_store.h"
 #include "enum/signal_state.h"
 
 class Track;
@@ -8,13 +12,18 @@ class Signal
 {
 private:
     const int id;
-    SignalState state;
     Track* track;
-    int failure_timer;
-    bool functional;
+
+    std::unique_ptr<StateStore> own_state; // only for signals built outside of a factory
+    StateStore *state;
+    std::size_t slot;
 
 public:
-    Signal(int i);
+    /**
+     * @param st store of the aspect and failure timer, a signal without one keeps its own
+     */
+    Signal(int i, StateStore *st = nullptr);
+    virtual ~Signal() = default;
 
     int get_id() const;
     Track* get_track() const;
@@ -22,7 +31,7 @@ public:
     void set_track(Track* tr);
 
     void set_failure(int failure);
-    void update_repair();
+    void repair();
     
     bool is_red() const;
     bool is_yellow() const;
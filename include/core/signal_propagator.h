@@ -0,0 +1,51 @@
+/**
+ * for details on design, see:
+ * docs/core/signal_propagator.md
+ */
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "core/line_topology.h"
+#include "enum/signal_state.h"
+#include "system/logger.h"
+
+class Track;
+
+/**
+ * keeps the signal aspects of one rail system current as blocks are entered and released, a signal is red while
+ * its block is occupied, yellow while one of the next two blocks of a line it serves is, and green otherwise
+ */
+class SignalPropagator
+{
+private:
+    // blocks ahead that decide an aspect, and so blocks behind an occupancy change that are updated
+    static constexpr int LOOKAHEAD{2};
+
+    std::vector<std::vector<const LineTopology *>> track_lines; // indexed by track id, the lines a track serves
+    Logger *logger;
+
+    SignalState aspect_of(const Track *track) const;
+    void update(int tick, Track *track);
+    void update_behind(int tick, const Track *track, int depth);
+
+public:
+    /**
+     * @param tracks every track and platform of the system indexed by track id
+     * @param topologies owned by the factory, one per train line
+     */
+    SignalPropagator(std::span<Track *const> tracks, std::span<const LineTopology *const> topologies, Logger *log);
+
+    /**
+     * sets the aspect of every signal from the current occupancy, without logging as no train has moved
+     */
+    void initialize(std::span<Track *const> tracks);
+
+    /**
+     * call once a train enters or leaves a track, updates the signal of the track and the signals up to
+     * LOOKAHEAD blocks behind it on every line it serves, logging only the signals whose aspect changed
+     */
+    void on_occupancy_change(int tick, Track *track);
+};
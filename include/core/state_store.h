@@ -0,0 +1,45 @@
+/**
+ * for details on design, see:
+ * docs/core/state_store.md
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "enum/signal_state.h"
+#include "enum/train_status.h"
+
+class Train;
+
+/**
+ * state that changes every tick, kept in parallel arrays indexed by the slot of each track, signal, and train,
+ * tracks, signals, and trains are handles over their slot so per tick sweeps run over contiguous arrays
+ */
+struct StateStore
+{
+    // tracks and platforms
+    std::vector<std::uint8_t> occupied;
+    std::vector<Train *> occupant;
+
+    // signals, a signal is functional while its failure timer is 0, a failed signal keeps its repair time until it is repaired
+    std::vector<SignalState> aspect;
+    std::vector<int> failure_timer;
+
+    // trains
+    std::vector<int> dwell_timer;
+    std::vector<TrainStatus> status;
+    std::vector<std::uint8_t> ready; // written by count_down_dwell
+
+    std::size_t add_track();
+    std::size_t add_signal();
+    std::size_t add_train();
+
+    /**
+     * one tick of dwell for the trains in slots [first, last), an active train without dwell left is marked
+     * ready to move, an active train still dwelling counts down instead, the only place the dwell rule lives
+     */
+    void count_down_dwell(std::size_t first, std::size_t last);
+};
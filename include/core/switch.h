@@ -32,7 +32,7 @@ public:
     bool set_link(Track *input, Track *output);
 
     void set_failure(int failure);
-    void update_repair();
+    void repair();
     bool is_functional() const;
 
     void add_approach_track(Track *tr);
@@ -0,0 +1,96 @@
+/**
+ * for details on design, see:
+ * docs/core/timing_wheel.md
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+/**
+ * hierarchical timing wheel of "expire at tick" callbacks, six levels of 64 slots cover every tick an int can
+ * hold, timers are kept in intrusive lists so scheduling and cancelling are constant time and only the timers
+ * that expire are touched as the wheel advances, timers expiring on one tick are called in the order they were scheduled
+ */
+class TimingWheel
+{
+public:
+    using Callback = std::function<void(int /* tick */)>;
+
+    struct Handle
+    {
+        std::uint32_t index{UINT32_MAX};
+        std::uint32_t generation{0};
+    };
+
+private:
+    static constexpr std::uint32_t NONE{UINT32_MAX};
+    static constexpr int SLOT_BITS{6};
+    static constexpr std::size_t SLOTS{1 << SLOT_BITS};
+    static constexpr int LEVELS{6};
+
+    enum class TimerState : std::uint8_t
+    {
+        FREE,
+        SCHEDULED,
+        EXPIRING // taken out of its slot and about to be called
+    };
+
+    struct Timer
+    {
+        int expire_tick{0};
+        Callback callback;
+        std::uint32_t prev{NONE};
+        std::uint32_t next{NONE};
+        std::uint32_t generation{0};
+        std::uint8_t level{0};
+        TimerState state{TimerState::FREE};
+    };
+
+    struct Slot
+    {
+        std::uint32_t head{NONE};
+        std::uint32_t tail{NONE};
+    };
+
+    std::vector<Timer> timers; // pooled, an entry is reused once its timer fires or is cancelled
+    std::vector<std::uint32_t> free_timers;
+    std::array<std::array<Slot, SLOTS>, LEVELS> slots{};
+    std::vector<std::uint32_t> expired;
+    std::size_t count{0};
+    int current_tick;
+
+    Slot &slot_of(const Timer &timer);
+    void link(std::uint32_t index);
+    void unlink(std::uint32_t index);
+    void release(std::uint32_t index);
+    void cascade(int tick);
+
+public:
+    explicit TimingWheel(int start_tick = 0);
+
+    /**
+     * @param expire_tick timers at or before the current tick expire on the next advance
+     */
+    Handle schedule(int expire_tick, Callback callback);
+
+    /**
+     * @return false for a timer that already expired or was cancelled
+     */
+    bool cancel(Handle handle);
+
+    /**
+     * moves the wheel to tick, calling every timer that expires on the way in order of expiry,
+     * callbacks may schedule and cancel timers
+     */
+    void advance(int tick);
+
+    std::optional<int> next_expiry() const;
+    int get_tick() const;
+    std::size_t size() const;
+};
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 #include <unordered_set>
 #include <memory>
 
+#include "core/state_store.h"
 #include "enum/transit_types.h"
 
 class Train;
@@ -16,8 +18,6 @@ class Track
 private:
     const int id;
     int duration;
-    bool occupied;
-    Train *current_train;
     Signal *const signal;
     std::unordered_set<TrainLine> train_lines;
 
@@ -27,8 +27,16 @@ private:
     Switch *outbound_switch;
     Switch *inbound_switch;
 
+    std::unique_ptr<StateStore> own_state; // only for tracks built outside of a factory
+    StateStore *state;
+    std::size_t slot;
+
 public:
-    Track(int i, Signal *s, int d = 1, std::unordered_set<TrainLine> lines = {});
+    /**
+     * @param st store of the occupancy, a track without one keeps its own
+     */
+    Track(int i, Signal *s, int d = 1, std::unordered_set<TrainLine> lines = {}, StateStore *st = nullptr);
+    virtual ~Track() = default;
 
     int get_id() const;
     int get_duration() const;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -9,6 +11,7 @@
 #include "enum/service_type.h"
 #include "enum/train_status.h"
 
+#include "core/state_store.h"
 #include "core/station.h"
 #include "core/track.h"
 #include "core/platform.h"
@@ -17,21 +20,28 @@
 class Train
 {
 private:
-    const int id;
-    int dwell_timer;
+    const TrainId id;
     int punctuality_delta;
     std::string headsign;
     const TrainLine train_line;
     ServiceType service_type;
-    TrainStatus status;
     Direction direction;
     Track *current_track;
     std::queue<const Station*> route;
 
+    std::unique_ptr<StateStore> own_state; // only for trains built outside of a factory
+    StateStore *state;
+    std::size_t slot;
+
 public:
-    Train(int i, const std::string& h, TrainLine l, ServiceType t, Direction d, std::vector<const Station*> r);
+    /**
+     * @param st store of the dwell timer and status, a train without one keeps its own
+     */
+    Train(TrainId i, const std::string& h, TrainLine l, ServiceType t, Direction d, std::vector<const Station*> r, StateStore *st = nullptr);
 
-    int get_id() const;
+    TrainId get_id() const;
+    StateStore *get_state_store() const;
+    std::size_t get_slot() const;
     int get_dwell() const;
     int get_lateness() const;
     std::string_view get_headsign() const;
@@ -51,10 +61,17 @@ public:
     bool is_departing() const;
     bool is_out_of_service() const;
     bool is_late() const;
+    bool is_ready() const; // set by StateStore::count_down_dwell for the current tick
 
-    bool request_movement();
     bool move_to_track(Track* to);
 
+    /**
+     * loads the direction, headsign and stations of the run a train spawns for, trains in service turn around
+     * at a yard and run many
+     * @param r stations after the origin yard, the destination yard included
+     */
+    void begin_run(Direction d, std::string_view h, std::vector<const Station *> r);
+
     bool spawn(Platform *yard_platform);
-    void despawn();
+    void despawn(bool in_service = false); // in service trains return to idle and can spawn for their next trip
 };
\ No newline at end of file
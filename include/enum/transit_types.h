@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <variant>
 #include <optional>
 #include <ranges>
@@ -108,6 +109,8 @@ namespace Generic
 using Direction = std::variant<SUB::Direction, MNR::Direction, LIRR::Direction, Generic::Direction>;
 using TrainLine = std::variant<SUB::TrainLine, MNR::TrainLine, LIRR::TrainLine, Generic::TrainLine>;
 
+using TrainId = std::int64_t; // encoded by the Registry, see docs/system/registry.md
+
 ///////////////////////
 // DIRECTION HELPERS //
 ///////////////////////
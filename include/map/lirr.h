@@ -33,8 +33,8 @@ namespace Transit::Map
         double weight_scale_factor {Constants::LIRR_SCALE_FACTOR};
         
         LongIslandRailroad();
-        void load_stations(const std::string &csv);
-        void load_connections(const std::string &csv);
+        void load_stations(const std::string &file_path);
+        void load_connections(const std::string &file_path);
 
         std::vector<int> merge_segments(const std::vector<std::vector<int>> &segments);
         std::vector<int> k_way_merge(const std::vector<std::vector<int>> &segments, const std::unordered_map<int, std::unordered_set<int>> &precedence);
@@ -13,6 +13,7 @@
 #include "constants/constants.h"
 #include "map/graph.h"
 #include "enum/transit_types.h"
+#include "utils/string_pool.h"
 
 namespace Transit::Map
 {
@@ -32,19 +33,12 @@ namespace Transit::Map
     private:
         double weight_scale_factor {Constants::SUBWAY_SCALE_FACTOR};
 
-        struct StringHash
-        {
-            using is_transparent = void;
-            [[nodiscard]] size_t operator()(std::string_view sv) const noexcept
-            {
-                return std::hash<std::string_view>{}(sv);
-            }
-        };
-        std::unordered_map<std::string, int, StringHash, std::equal_to<>> gtfs_to_id;
+        Utils::StringPool gtfs_ids;
+        std::vector<int> gtfs_to_id; // complex id, indexed by interned gtfs id
 
         Subway();
-        void load_stations(const std::string &csv);
-        void load_connections(const std::string &csv);
+        void load_stations(const std::string &file_path);
+        void load_connections(const std::string &file_path);
         ;
     };
 }
\ No newline at end of file
@@ -5,11 +5,14 @@
 
 #pragma once
 
+#include <deque>
+#include <span>
 #include <unordered_map>
 #include <vector>
 #include <tuple>
-#include <memory>
 
+#include "core/line_topology.h"
+#include "core/state_store.h"
 #include "core/train.h"
 #include "core/station.h"
 #include "core/track.h"
@@ -23,16 +26,30 @@
 class Factory
 {
 private:
-    int next_signal_id{1};
-    int next_track_id{1};
-    int next_switch_id{1};
+    StateStore state; // per tick state of the tracks, signals, and trains below, outlives them
 
-    std::unordered_map<int, std::unique_ptr<Train>> trains;
-    std::unordered_map<int, std::unique_ptr<Station>> stations;
-    std::unordered_map<int, std::unique_ptr<Signal>> signals;
-    std::unordered_map<int, std::unique_ptr<Platform>> platforms;
-    std::unordered_map<int, std::unique_ptr<Track>> tracks;
-    std::unordered_map<int, std::unique_ptr<Switch>> switches;
+    // objects live in chunked pools that never relocate them, so the pointers handed out stay valid
+    std::deque<Train> trains;
+    std::deque<Station> stations;
+    std::deque<Signal> signals;
+    std::deque<Platform> platforms;
+    std::deque<Track> tracks;
+    std::deque<Switch> switches;
+
+    // dense views in creation order, the ids of signals, tracks and switches are their index
+    std::vector<Train *> train_index;
+    std::vector<Station *> station_index;
+    std::vector<Signal *> signal_index;
+    std::vector<Platform *> platform_index;
+    std::vector<Track *> track_index; // platforms and tracks share one id space
+    std::vector<Switch *> switch_index;
+
+    std::unordered_map<int, Station *> station_ids; // station ids come from the graph and are sparse
+    std::unordered_map<TrainLine, std::vector<Train *>> line_trains;
+    std::unordered_map<TrainLine, std::vector<Station *>> line_stations;
+    std::unordered_map<TrainLine, LineTopology> line_topologies;
+    std::vector<const LineTopology *> topology_index;
+    LineTopology empty_topology{Generic::TrainLine::DEFAULT, {}, {}}; // for lines without stations
 
     struct platform_pair_hash
     {
@@ -58,21 +75,38 @@ private:
 public:
     Factory() = default;
 
+    Factory(const Factory &) = delete;
+    Factory &operator=(const Factory &) = delete;
+
     void build_network(const Transit::Map::Graph &graph, const Registry &registry, Constants::System system_code);
 
-    std::vector<Train *> get_trains() const;
-    std::vector<Train *> get_trains(TrainLine train_line) const;
-    std::vector<Station *> get_stations() const;
-    std::vector<Station *> get_stations(TrainLine train_line) const;
-    std::vector<Signal *> get_signals() const;
-    std::vector<Platform *> get_platforms() const;
-    std::vector<Track *> get_tracks() const;
-    std::vector<Switch *> get_switches() const;
+    /**
+     * views stay valid for the lifetime of the factory, per line views are only filled by build_network
+     */
+    std::span<Train *const> get_trains() const;
+    std::span<Train *const> get_trains(TrainLine train_line) const;
+    std::span<Station *const> get_stations() const;
+    std::span<Station *const> get_stations(TrainLine train_line) const;
+    std::span<Signal *const> get_signals() const;
+    std::span<Platform *const> get_platforms() const;
+    std::span<Track *const> get_tracks() const; // indexed by track id, platforms included
+    std::span<Switch *const> get_switches() const;
+
+    /**
+     * slots of signals and tracks equal their ids, trains of a line occupy consecutive slots
+     */
+    StateStore &get_state_store();
+
+    /**
+     * successors, predecessors, and platforms of a train line, built by build_network once the network is complete
+     */
+    const LineTopology &get_topology(TrainLine train_line) const;
+    std::span<const LineTopology *const> get_topologies() const;
 
 private:
-    int generate_signal_id();
-    int generate_track_id();
-    int generate_switch_id();
+    Signal *allocate_signal();
+    Switch *allocate_switch();
+    void index_lines();
 
     void create_trains(const Registry &registry, Constants::System system_code);
     void create_stations(const Transit::Map::Graph &graph, const Registry &registry, Constants::System system_code);
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <vector>
 #include <unordered_map>
 #include <optional>
@@ -16,7 +19,7 @@
 
 struct Info
 {
-    int id;
+    TrainId id;
     Constants::System system_code;
     TrainLine train_line;
     Direction direction;
@@ -35,25 +38,63 @@ public:
     Registry(const Registry &) = delete;
     Registry &operator=(const Registry &) = delete;
 
-    const std::vector<int>& get_train_registry(Constants::System system_code) const;
+    const std::vector<TrainId>& get_train_registry(Constants::System system_code) const;
     const std::vector<std::pair<int, int>>& get_yard_registry(Constants::System system_code) const;
 
-    //[ system (4 bits) | train_line_code (8 bits) | direction_code (12 bits) | instance (8 bits) ]
-    int encode(Constants::System system_code, int train_line_code, int direction_code, int instance);
-    Info decode(int encoded_id) const;
+    /**
+     * fleet sizes are runtime settings and must be changed before schedules and trains are built from the registry,
+     * the trains of a line are split across its directions
+     */
+    int get_fleet_size(Constants::System system_code, const TrainLine &train_line) const;
+    void set_fleet_size(Constants::System system_code, const TrainLine &train_line, int trains);
 
-    void register_route(int train_id, const Transit::Map::Route& route);
-    std::optional<std::reference_wrapper<const Transit::Map::Route>> get_registered_route(int train_id) const;
+    //[ unused (1 bit) | instance (31 bits) | system (4 bits) | train_line_code (8 bits) | direction_code (12 bits) | unused (8 bits) ]
+    TrainId encode(Constants::System system_code, int train_line_code, int direction_code, int instance);
+    Info decode(TrainId encoded_id) const;
+
+    // single fields of an encoded id, for lookups that do not need the enumerations decode resolves
+    static int system_code_of(TrainId encoded_id);
+    static int train_line_code_of(TrainId encoded_id);
+    static int direction_code_of(TrainId encoded_id);
+    static int instance_of(TrainId encoded_id);
+
+    /**
+     * a system is written while its schedule is built and frozen afterwards, a frozen system rejects changes
+     * and can be read from any thread without locks, registering the route a train already has is allowed
+     */
+    void register_route(TrainId train_id, const Transit::Map::Route& route);
+    std::optional<std::reference_wrapper<const Transit::Map::Route>> get_registered_route(TrainId train_id) const;
+
+    void freeze(Constants::System system_code);
+    bool is_frozen(Constants::System system_code) const;
+
+protected:
+    Registry(); // tests build registries of their own that no other test has frozen
 
 private:
-    std::unordered_map<Constants::System, std::vector<int /* encoded_id */>> train_registry;
-    std::unordered_map<Constants::System, std::vector<std::pair<int /* from_encoded_id */, int /* to_encoded_id */>>> yard_registry;
-    std::unordered_map<int /* train_id */, const Transit::Map::Route&> route_registry;
+    /**
+     * systems are only written by the thread that builds their schedule, so each one is a shard of its own
+     */
+    struct SystemRegistry
+    {
+        int direction_count{};
+        std::vector<int> fleet_sizes;                    // indexed by train line enumeration
+        std::vector<TrainId> trains;                     // grouped by train line, then direction
+        std::vector<std::size_t> first_train;            // into trains, indexed by train line * direction count + direction, with an end sentinel
+        std::vector<const Transit::Map::Route *> routes; // indexed like trains
+        std::vector<std::pair<int /* from_encoded_id */, int /* to_encoded_id */>> yards; // indexed by train line enumeration
+        std::atomic<bool> frozen{false};
+    };
+
+    std::array<SystemRegistry, Constants::SYSTEMS.size()> systems;
 
-    Registry();
+    static std::size_t system_index(Constants::System system_code);
+    SystemRegistry &get_system(Constants::System system_code);
+    const SystemRegistry &get_system(Constants::System system_code) const;
+    std::optional<std::pair<std::size_t /* system */, std::size_t /* train */>> locate(TrainId train_id) const;
 
     void build_registry();
 
-    void generate_trains(Constants::System system_code, int tl_count, int dir_count);
-    void generate_yards(Constants::System system_code, int tl_count);
+    void generate_trains(Constants::System system_code);
+    void generate_yards(Constants::System system_code);
 };
\ No newline at end of file
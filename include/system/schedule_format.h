@@ -0,0 +1,109 @@
+/**
+ * for details on design, see:
+ * docs/system/schedule_index.md
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * on-disk layout of schedule/<system>/schedule.bin, shared by the scheduler writer and the dispatch reader
+ *
+ * every section starts on an 8 byte boundary so it can be used in place from a memory mapping,
+ * values are stored in native byte order and the format is only produced and consumed on little-endian hosts
+ */
+namespace ScheduleFormat
+{
+    static_assert(std::endian::native == std::endian::little, "schedule format assumes a little-endian host");
+
+    inline constexpr char MAGIC[4]{'C', 'T', 'S', 'B'};
+    inline constexpr std::uint32_t VERSION{3};
+    inline constexpr std::size_t ALIGNMENT{8};
+
+    struct StringRef
+    {
+        std::uint32_t offset; // into the string heap
+        std::uint32_t length;
+    };
+
+    struct Header
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t system_code; // Constants::System, selects the enum of every trip direction
+        std::uint32_t line_count;
+        std::uint32_t trip_count;
+        std::uint32_t pattern_count;
+        std::uint32_t stop_count;
+        std::uint32_t station_count;
+        std::uint32_t string_heap_size;
+        std::uint32_t reserved;
+
+        std::uint64_t lines_offset;       // Line[line_count], sorted by name
+        std::uint64_t trips_offset;       // Trip[trip_count], grouped by line in schedule order
+        std::uint64_t patterns_offset;    // Pattern[pattern_count], deduplicated across lines
+        std::uint64_t stops_offset;       // Stop[stop_count], grouped by pattern in travel order
+        std::uint64_t stations_offset;    // Station[station_count], sorted by id
+        std::uint64_t string_heap_offset; // char[string_heap_size]
+    };
+
+    struct Line
+    {
+        StringRef name;
+        std::uint32_t first_trip;
+        std::uint32_t trip_count;
+    };
+
+    /**
+     * a trip runs its stopping pattern shifted by start_tick, trains on the same route
+     * and yards share one pattern and only differ in their start
+     */
+    struct Trip
+    {
+        std::int64_t train_id; // encoded by the registry
+        StringRef headsign;
+        std::uint32_t direction; // enum value of the system direction
+        std::uint32_t pattern;
+        std::int32_t start_tick;
+        std::uint32_t reserved;
+    };
+
+    /**
+     * stops of a pattern occupy [first_stop, first_stop + stop_count) in the stops section
+     */
+    struct Pattern
+    {
+        std::uint32_t first_stop;
+        std::uint32_t stop_count;
+    };
+
+    /**
+     * ticks are relative to the start of the trip
+     */
+    struct Stop
+    {
+        std::int32_t station_id;
+        std::int32_t arrival_tick;   // -1 at the origin yard
+        std::int32_t departure_tick; // -1 at the destination yard
+    };
+
+    /**
+     * station names are kept once per station instead of on every stop
+     */
+    struct Station
+    {
+        std::int32_t station_id;
+        StringRef name;
+    };
+
+    static_assert(sizeof(StringRef) == 8);
+    static_assert(sizeof(Header) == 88);
+    static_assert(sizeof(Line) == 16);
+    static_assert(sizeof(Trip) == 32);
+    static_assert(sizeof(Pattern) == 8);
+    static_assert(sizeof(Stop) == 12);
+    static_assert(sizeof(Station) == 12);
+}
@@ -0,0 +1,58 @@
+/**
+ * for details on design, see:
+ * docs/system/schedule_index.md
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "constants/constants.h"
+#include "enum/transit_types.h"
+#include "system/schedule_format.h"
+#include "utils/mapped_file.h"
+
+/**
+ * immutable per train line view of a system schedule.bin written by the scheduler, the file is memory mapped
+ * and validated once so every Dispatch reads the trips of its own train line in place
+ */
+class ScheduleIndex
+{
+public:
+    explicit ScheduleIndex(const std::string &file_path);
+
+    std::span<const ScheduleFormat::Trip> get_trips(TrainLine train_line) const;
+    std::span<const ScheduleFormat::Stop> get_stops(const ScheduleFormat::Trip &trip) const; // ticks relative to trip.start_tick
+    Direction get_direction(const ScheduleFormat::Trip &trip) const;
+    std::string_view get_headsign(const ScheduleFormat::Trip &trip) const;
+    std::string_view get_station_name(int station_id) const;
+
+    Constants::System get_system_code() const;
+    std::size_t get_trip_count() const;
+    std::size_t get_pattern_count() const;
+
+    /**
+     * @param file_path human-readable schedule in the schema of schedule.json
+     */
+    void write_json(const std::string &file_path) const;
+
+private:
+    Utils::MappedFile file;
+    ScheduleFormat::Header header{};
+
+    std::span<const ScheduleFormat::Line> lines_section;
+    std::span<const ScheduleFormat::Trip> trips_section;
+    std::span<const ScheduleFormat::Pattern> patterns_section;
+    std::span<const ScheduleFormat::Stop> stops_section;
+    std::span<const ScheduleFormat::Station> stations_section;
+    std::string_view string_heap;
+
+    template <typename T>
+    std::span<const T> section(std::uint64_t offset, std::uint64_t count, const std::string &name) const;
+
+    std::string_view resolve(const ScheduleFormat::StringRef &ref) const;
+    void validate() const;
+};
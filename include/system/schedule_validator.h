@@ -0,0 +1,68 @@
+/**
+ * for details on design, see:
+ * docs/system/schedule_validator.md
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "constants/constants.h"
+#include "enum/transit_types.h"
+#include "system/factory.h"
+#include "system/schedule_index.h"
+
+/**
+ * checks a schedule against the track topology built by the factory before it is run, every stop occupies
+ * a platform of its station and every leg occupies the track blocks between two stations for its travel ticks
+ */
+class ScheduleValidator
+{
+public:
+    enum class ConflictType
+    {
+        PLATFORM, // more trains dwell at a station in one direction than it has platforms
+        BLOCK,    // two trains occupy one track block at the same time
+        HEADWAY   // two trains enter one track block closer than the minimum headway
+    };
+
+    struct Conflict
+    {
+        ConflictType type;
+        int resource_id; // station id for platform conflicts, track id otherwise
+        TrainId first_train;
+        TrainId second_train;
+        int tick; // when the second train starts the conflicting occupancy
+    };
+
+    explicit ScheduleValidator(const Factory &factory, int mh = Constants::MINIMUM_HEADWAY);
+
+    /**
+     * @return conflicts ordered by tick, legs between stations without a track connection are not checked
+     */
+    std::vector<Conflict> validate(const ScheduleIndex &index) const;
+
+private:
+    struct Occupancy
+    {
+        std::int64_t resource;
+        int start_tick;
+        int end_tick; // exclusive
+        TrainId train_id;
+    };
+
+    int minimum_headway;
+
+    std::unordered_map<int, const Station *> stations;
+    std::unordered_map<std::int64_t, int> platform_capacity; // keyed like platform occupancies
+
+    static std::int64_t platform_key(int station_id, std::uint32_t direction);
+
+    std::vector<const Track *> find_block(int from_id, int to_id, const Direction &direction, TrainLine train_line) const;
+    void collect(const ScheduleIndex &index, TrainLine train_line, std::vector<Occupancy> &platforms, std::vector<Occupancy> &blocks, std::vector<Occupancy> &entries) const;
+
+    static void sweep(std::vector<Occupancy> &occupancies, ConflictType type, const std::unordered_map<std::int64_t, int> *capacity, std::vector<Conflict> &conflicts);
+    void check_headways(std::vector<Occupancy> &entries, std::vector<Conflict> &conflicts) const;
+};
@@ -0,0 +1,73 @@
+/**
+ * for details on design, see:
+ * docs/system/schedule_index.md
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "constants/constants.h"
+#include "enum/transit_types.h"
+#include "system/schedule_format.h"
+#include "utils/string_pool.h"
+
+/**
+ * collects stopping patterns and trips as the scheduler generates them and writes them in the layout of
+ * system/schedule_format.h, identical patterns are stored once and headsigns and station names share one deduplicated heap
+ */
+class ScheduleWriter
+{
+public:
+    explicit ScheduleWriter(Constants::System sc);
+
+    /**
+     * @param stops stops with ticks relative to the start of the trip
+     * @return id of the pattern, equal stop sequences share one id
+     */
+    std::uint32_t add_pattern(std::span<const ScheduleFormat::Stop> stops);
+    void add_station(int station_id, std::string_view station_name);
+    void add_trip(const TrainLine &train_line, TrainId train_id, const Direction &direction, std::string_view headsign, std::uint32_t pattern, int start_tick);
+
+    /**
+     * appends the stations, patterns and trips of another writer of the same system, trips keep their order
+     * after the trips already added and patterns are deduplicated against the ones already stored
+     */
+    void append(const ScheduleWriter &other);
+
+    std::size_t get_trip_count() const;
+    std::size_t get_pattern_count() const;
+    std::span<const ScheduleFormat::Stop> get_stops(std::uint32_t pattern) const;
+
+    void write(const std::string &file_path) const;
+
+private:
+    struct Line
+    {
+        ScheduleFormat::StringRef name{};
+        std::vector<ScheduleFormat::Trip> trips{};
+    };
+
+    Constants::System system_code;
+    std::map<std::string, Line, std::less<>> lines;
+
+    std::vector<ScheduleFormat::Pattern> patterns;
+    std::vector<ScheduleFormat::Stop> stops;
+    std::unordered_map<std::string, std::uint32_t, Utils::StringHash, std::equal_to<>> pattern_ids; // keyed by the bytes of the stops
+
+    std::map<int, ScheduleFormat::StringRef> station_names;
+    std::string heap;
+    Utils::StringPool heap_strings;
+    std::vector<std::uint32_t> heap_offsets; // indexed by interned string
+
+    ScheduleFormat::StringRef store(std::string_view sv);
+    std::string_view resolve(const ScheduleFormat::StringRef &ref) const;
+    Line &line_for(std::string line_name);
+};
@@ -5,23 +5,49 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <fstream>
-
-#include <nlohmann/json.hpp>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "map/graph.h"
 #include "utils/utils.h"
+#include "utils/task_executor.h"
 #include "constants/constants.h"
 #include "system/registry.h"
+#include "system/timetable.h"
+#include "system/schedule_writer.h"
+#include "system/service_planner.h"
 
 class Scheduler
 {
 public:
     Scheduler() = default;
-    static void write_schedule(const Transit::Map::Graph &graph, Registry& registry, const std::string& outfile_subfolder, Constants::System system_code);
+    static void write_schedule(const Transit::Map::Graph &graph, Registry& registry, const std::string& outfile_subfolder, Constants::System system_code, Utils::TaskExecutor *executor = nullptr);
 
 private:
-    static void process_system(nlohmann::json &train_lines_json, const Transit::Map::Graph& graph, Registry& registry, Constants::System system_code);
-    static void generate_train_schedule(nlohmann::json& schedule_json, const Transit::Map::Graph& graph, const Transit::Map::Route& route, const Info& train_info, const Info& origin_yard_info, const Info& destination_yard_info);
+    // route of a train indexed by [direction][instance parity], built once per system instead of searched per train
+    using RouteTable = std::unordered_map<TrainLine, std::array<std::array<const Transit::Map::Route *, 2>, 2>>;
+    using YardMap = std::unordered_map<TrainLine, std::pair<int, int>>;
+
+    static void process_system(ScheduleWriter &writer, const Transit::Map::Graph& graph, Registry& registry, Constants::System system_code, Utils::TaskExecutor *executor);
+    static void process_timetable(ScheduleWriter &writer, const Transit::Map::Graph &graph, Registry &registry, Constants::System system_code, const Timetable &timetable);
+    static void process_line(ScheduleWriter &writer, std::vector<std::pair<TrainId, const Transit::Map::Route *>> &assigned_routes, const Transit::Map::Graph &graph, const Registry &registry, const RouteTable &route_table, const YardMap &yard_map, const std::vector<TrainId> &train_ids);
+    static void plan_service_day(ScheduleWriter &writer, std::vector<std::pair<TrainId, const Transit::Map::Route *>> &assigned_routes, const Transit::Map::Graph &graph, const Registry &registry, const RouteTable &route_table, const YardMap &yard_map, const std::vector<TrainId> &train_ids);
+    static RouteTable build_route_table(const Transit::Map::Graph &graph, Constants::System system_code);
+    static std::unordered_map<TrainLine, std::pair<int, int>> build_yard_map(const Registry &registry, Constants::System system_code);
+    static std::optional<std::pair<Info, Info>> find_yards(const Registry &registry, const std::unordered_map<TrainLine, std::pair<int, int>> &yard_map, const Info &train_info);
+    static std::uint32_t generate_stopping_pattern(ScheduleWriter &writer, const Transit::Map::Graph& graph, const Transit::Map::Route& route, const Info& origin_yard_info, const Info& destination_yard_info);
+
+    /**
+     * schedules are a deterministic function of the graph, the registry, and the scheduling constants, so a schedule
+     * written from inputs with the same fingerprint is reused and only its routes are restored into the registry
+     */
+    static std::uint64_t fingerprint(const Transit::Map::Graph &graph, const Registry &registry, Constants::System system_code);
+    static bool restore_routes(const std::string &routes_path, const std::string &schedule_path, std::uint64_t inputs, const Transit::Map::Graph &graph, Registry &registry, Constants::System system_code);
+    static void write_routes(const std::string &routes_path, const std::string &schedule_path, std::uint64_t inputs, const Transit::Map::Graph &graph, const Registry &registry, Constants::System system_code);
 };
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ * for details on design, see:
+ * docs/system/service_planner.md
+ */
+
+#pragma once
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "constants/constants.h"
+#include "enum/transit_types.h"
+
+struct HeadwayPeriod
+{
+    int start_tick;
+    int headway; // ticks between departures from each yard of a line
+};
+
+/**
+ * headways of one train line over a service day
+ */
+struct ServiceProfile
+{
+    std::vector<HeadwayPeriod> periods; // sorted by start tick, each runs until the next one starts
+    int end_tick;                       // no run starts at or after it
+    int turnaround;                     // ticks a train waits in a yard before its next run
+
+    int headway_at(int tick) const;
+
+    static ServiceProfile default_for(Constants::System system_code);
+};
+
+/**
+ * plans the runs of a train line from a headway profile, trains shuttle between the two yards of the line
+ * and leave again after a turnaround, so a small fleet covers a full service day
+ */
+class ServicePlanner
+{
+public:
+    struct Run
+    {
+        TrainId train_id;
+        int side;    // index of the yard the run leaves from, the run ends at the other yard
+        int variant; // index into the run ticks of its side, consecutive runs of a side alternate variants
+        int start_tick;
+    };
+
+    /**
+     * @param run_ticks ticks from yard departure to yard arrival for each variant of a side, a side without variants is not served
+     * @param fleet train id and side of its first run, trains of a side leave in fleet order
+     * @return runs in order of their planned departure
+     */
+    static std::vector<Run> plan(const ServiceProfile &profile, const std::array<std::vector<int>, 2> &run_ticks, const std::vector<std::pair<TrainId, int>> &fleet);
+};
@@ -0,0 +1,62 @@
+/**
+ * for details on design, see:
+ * docs/system/timetable.md
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "system/timetable_format.h"
+#include "utils/mapped_file.h"
+
+/**
+ * read-only view over a timetable.bin written by the etl, the file is memory mapped
+ * and validated once on construction so lookups afterwards are plain array accesses
+ */
+class Timetable
+{
+public:
+    struct StopTime
+    {
+        std::uint32_t stop; // index into stop codes
+        int arrival;        // seconds after midnight of the service day
+        int departure;
+    };
+
+    explicit Timetable(const std::string &file_path);
+
+    std::size_t route_count() const;
+    std::string_view route_name(std::uint32_t route) const;
+    std::span<const TimetableFormat::Trip> trips(std::uint32_t route) const;
+
+    std::size_t trip_count() const;
+    std::string_view headsign(const TimetableFormat::Trip &trip) const;
+
+    std::size_t stop_count() const;
+    std::string_view stop_code(std::uint32_t stop) const;
+
+    void decode(const TimetableFormat::Trip &trip, std::vector<StopTime> &out) const;
+
+private:
+    Utils::MappedFile file;
+    TimetableFormat::Header header{};
+
+    std::span<const TimetableFormat::Route> routes_section;
+    std::span<const TimetableFormat::StringRef> stops_section;
+    std::span<const TimetableFormat::Trip> trips_section;
+    std::span<const std::uint32_t> stop_index_section;
+    std::span<const std::uint16_t> arrival_delta_section;
+    std::span<const std::uint16_t> dwell_section;
+    std::string_view string_heap;
+
+    template <typename T>
+    std::span<const T> section(std::uint64_t offset, std::uint64_t count, const std::string &name) const;
+
+    std::string_view resolve(const TimetableFormat::StringRef &ref) const;
+    void validate() const;
+};
@@ -0,0 +1,76 @@
+/**
+ * for details on design, see:
+ * docs/system/timetable.md
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * on-disk layout of data/clean/<system>/timetable.bin, shared by the etl writer and the simulator reader
+ *
+ * every section starts on an 8 byte boundary so it can be used in place from a memory mapping,
+ * values are stored in native byte order and the format is only produced and consumed on little-endian hosts
+ */
+namespace TimetableFormat
+{
+    static_assert(std::endian::native == std::endian::little, "timetable format assumes a little-endian host");
+
+    inline constexpr char MAGIC[4]{'C', 'T', 'T', 'B'};
+    inline constexpr std::uint32_t VERSION{1};
+    inline constexpr std::size_t ALIGNMENT{8};
+
+    struct StringRef
+    {
+        std::uint32_t offset; // into the string heap
+        std::uint32_t length;
+    };
+
+    struct Header
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t route_count;
+        std::uint32_t stop_count;
+        std::uint32_t trip_count;
+        std::uint32_t stop_time_count;
+        std::uint32_t string_heap_size;
+        std::uint32_t reserved;
+
+        std::uint64_t routes_offset;         // Route[route_count], sorted by name
+        std::uint64_t stops_offset;          // StringRef[stop_count], stop codes after the system transform
+        std::uint64_t trips_offset;          // Trip[trip_count], grouped by route and sorted by start time
+        std::uint64_t stop_index_offset;     // uint32_t[stop_time_count], index into stops
+        std::uint64_t arrival_delta_offset;  // uint16_t[stop_time_count], seconds since the previous departure
+        std::uint64_t dwell_offset;          // uint16_t[stop_time_count], seconds between arrival and departure
+        std::uint64_t string_heap_offset;    // char[string_heap_size]
+    };
+
+    struct Route
+    {
+        StringRef name;
+        std::uint32_t first_trip;
+        std::uint32_t trip_count;
+    };
+
+    /**
+     * stop times of a trip occupy [first_stop_time, first_stop_time + stop_time_count) in the stop time columns,
+     * the first arrival is start_time and every later time is recovered by summing deltas from it
+     */
+    struct Trip
+    {
+        StringRef headsign;
+        std::uint32_t route;
+        std::uint32_t first_stop_time;
+        std::uint32_t stop_time_count;
+        std::int32_t start_time; // seconds after midnight of the service day, may exceed 24 hours
+    };
+
+    static_assert(sizeof(StringRef) == 8);
+    static_assert(sizeof(Header) == 88);
+    static_assert(sizeof(Route) == 16);
+    static_assert(sizeof(Trip) == 24);
+}
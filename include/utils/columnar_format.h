@@ -0,0 +1,73 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * on-disk layout of the typed columnar tables in data/clean/<system>/, shared by the etl writer and the simulator reader
+ *
+ * a table is a header, a schema describing each column, the column data and a string heap,
+ * every section starts on an 8 byte boundary so it can be used in place from a memory mapping,
+ * values are stored in native byte order and the format is only produced and consumed on little-endian hosts
+ */
+namespace ColumnarFormat
+{
+    static_assert(std::endian::native == std::endian::little, "columnar format assumes a little-endian host");
+
+    inline constexpr char MAGIC[4]{'C', 'T', 'C', 'F'};
+    inline constexpr std::uint32_t VERSION{1};
+    inline constexpr std::size_t ALIGNMENT{8};
+
+    enum class Type : std::uint32_t
+    {
+        INT32 = 1,
+        FLOAT64 = 2,
+        STRING = 3,
+        INT32_LIST = 4,
+        STRING_LIST = 5
+    };
+
+    struct StringRef
+    {
+        std::uint32_t offset; // into the string heap
+        std::uint32_t length;
+    };
+
+    struct Header
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t column_count;
+        std::uint32_t row_count;
+        std::uint32_t string_heap_size;
+        std::uint32_t reserved;
+
+        std::uint64_t schema_offset;      // Column[column_count]
+        std::uint64_t string_heap_offset; // char[string_heap_size]
+    };
+
+    /**
+     * scalar columns hold one value per row, list columns hold the values of every row back to back
+     * with row i spanning [offsets[i], offsets[i + 1]) of the values
+     */
+    struct Column
+    {
+        StringRef name;
+        Type type;
+        std::uint32_t reserved;
+
+        std::uint64_t values_offset;  // int32_t, double or StringRef
+        std::uint64_t value_count;    // row_count for scalar columns, total elements for list columns
+        std::uint64_t offsets_offset; // uint32_t[row_count + 1] for list columns, 0 otherwise
+    };
+
+    inline constexpr bool is_list(Type type)
+    {
+        return type == Type::INT32_LIST || type == Type::STRING_LIST;
+    }
+
+    static_assert(sizeof(StringRef) == 8);
+    static_assert(sizeof(Header) == 40);
+    static_assert(sizeof(Column) == 40);
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/columnar_format.h"
+#include "utils/mapped_file.h"
+
+namespace Utils
+{
+    /**
+     * read-only view over a columnar table written by the etl, the file is memory mapped and
+     * validated once on construction so columns can be read as spans without parsing
+     */
+    class ColumnarTable
+    {
+    private:
+        MappedFile file;
+        ColumnarFormat::Header header{};
+        std::span<const ColumnarFormat::Column> schema;
+        std::string_view string_heap;
+
+    public:
+        explicit ColumnarTable(const std::string &file_path) : file(file_path)
+        {
+            if (file.size() < sizeof(ColumnarFormat::Header))
+            {
+                throw std::runtime_error("Columnar table is truncated: " + file_path);
+            }
+
+            std::memcpy(&header, file.data(), sizeof(header));
+
+            if (!std::equal(std::begin(ColumnarFormat::MAGIC), std::end(ColumnarFormat::MAGIC), header.magic))
+            {
+                throw std::runtime_error("Not a columnar table: " + file_path);
+            }
+
+            if (header.version != ColumnarFormat::VERSION)
+            {
+                throw std::runtime_error("Unsupported columnar table version " + std::to_string(header.version) + ": " + file_path);
+            }
+
+            schema = section<ColumnarFormat::Column>(header.schema_offset, header.column_count);
+            auto heap{section<char>(header.string_heap_offset, header.string_heap_size)};
+            string_heap = std::string_view(heap.data(), heap.size());
+
+            for (const auto &column : schema)
+            {
+                validate(column, file_path);
+            }
+        }
+
+        std::size_t row_count() const
+        {
+            return header.row_count;
+        }
+
+        /**
+         * @param name column name from the schema
+         * @param type type the caller expects the column to have
+         * @return index of the column, throws std::runtime_error if it is missing or has another type
+         */
+        std::size_t column(std::string_view name, ColumnarFormat::Type type) const
+        {
+            for (std::size_t i{0}; i < schema.size(); ++i)
+            {
+                if (resolve(schema[i].name) == name)
+                {
+                    if (schema[i].type != type)
+                    {
+                        throw std::runtime_error("Column " + std::string(name) + " has an unexpected type");
+                    }
+                    return i;
+                }
+            }
+
+            throw std::runtime_error("Missing column " + std::string(name));
+        }
+
+        std::span<const std::int32_t> int32s(std::size_t column) const
+        {
+            return values<std::int32_t>(schema[column]);
+        }
+
+        std::span<const double> float64s(std::size_t column) const
+        {
+            return values<double>(schema[column]);
+        }
+
+        std::string_view string(std::size_t column, std::size_t row) const
+        {
+            return resolve(values<ColumnarFormat::StringRef>(schema[column])[row]);
+        }
+
+        std::span<const std::int32_t> int32_list(std::size_t column, std::size_t row) const
+        {
+            return list<std::int32_t>(schema[column], row);
+        }
+
+        std::span<const ColumnarFormat::StringRef> string_list(std::size_t column, std::size_t row) const
+        {
+            return list<ColumnarFormat::StringRef>(schema[column], row);
+        }
+
+        std::string_view resolve(const ColumnarFormat::StringRef &ref) const
+        {
+            return string_heap.substr(ref.offset, ref.length);
+        }
+
+    private:
+        template <typename T>
+        std::span<const T> section(std::uint64_t offset, std::uint64_t count) const
+        {
+            if (offset % alignof(T) != 0 || offset > file.size() || count > (file.size() - offset) / sizeof(T))
+            {
+                throw std::runtime_error("Columnar table section is out of bounds");
+            }
+
+            // mappings are page aligned and sections are written on ALIGNMENT boundaries, so the cast is well aligned
+            return std::span<const T>(reinterpret_cast<const T *>(file.data() + offset), static_cast<std::size_t>(count));
+        }
+
+        template <typename T>
+        std::span<const T> values(const ColumnarFormat::Column &column) const
+        {
+            return std::span<const T>(reinterpret_cast<const T *>(file.data() + column.values_offset), static_cast<std::size_t>(column.value_count));
+        }
+
+        template <typename T>
+        std::span<const T> list(const ColumnarFormat::Column &column, std::size_t row) const
+        {
+            const auto *offsets{reinterpret_cast<const std::uint32_t *>(file.data() + column.offsets_offset)};
+            return values<T>(column).subspan(offsets[row], offsets[row + 1] - offsets[row]);
+        }
+
+        bool valid_ref(const ColumnarFormat::StringRef &ref) const
+        {
+            return ref.offset <= string_heap.size() && ref.length <= string_heap.size() - ref.offset;
+        }
+
+        void validate(const ColumnarFormat::Column &column, const std::string &file_path) const
+        {
+            using ColumnarFormat::Type;
+
+            if (!valid_ref(column.name))
+            {
+                throw std::runtime_error("Column name is out of bounds in " + file_path);
+            }
+
+            if (ColumnarFormat::is_list(column.type))
+            {
+                auto offsets{section<std::uint32_t>(column.offsets_offset, std::uint64_t{header.row_count} + 1)};
+                if (offsets.front() != 0 || offsets.back() != column.value_count || !std::is_sorted(offsets.begin(), offsets.end()))
+                {
+                    throw std::runtime_error("Column " + std::string(resolve(column.name)) + " has invalid list offsets in " + file_path);
+                }
+            }
+            else if (column.value_count != header.row_count)
+            {
+                throw std::runtime_error("Column " + std::string(resolve(column.name)) + " does not match the row count in " + file_path);
+            }
+
+            switch (column.type)
+            {
+            case Type::INT32:
+            case Type::INT32_LIST:
+                section<std::int32_t>(column.values_offset, column.value_count);
+                break;
+            case Type::FLOAT64:
+                section<double>(column.values_offset, column.value_count);
+                break;
+            case Type::STRING:
+            case Type::STRING_LIST:
+            {
+                auto refs{section<ColumnarFormat::StringRef>(column.values_offset, column.value_count)};
+                if (!std::all_of(refs.begin(), refs.end(), [&](const auto &ref)
+                                 { return valid_ref(ref); }))
+                {
+                    throw std::runtime_error("Column " + std::string(resolve(column.name)) + " has a string out of bounds in " + file_path);
+                }
+                break;
+            }
+            default:
+                throw std::runtime_error("Column " + std::string(resolve(column.name)) + " has an unknown type in " + file_path);
+            }
+        }
+    };
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "utils/hasher.h"
+
+namespace Utils
+{
+    /**
+     * typed front end of the xxHash Hasher, used to recognise generated files whose inputs have not changed,
+     * values are hashed by their bytes so the result is only stable on one host and build
+     */
+    class Fingerprint
+    {
+    private:
+        Hasher hasher{};
+
+    public:
+        void add_bytes(const void *data, std::size_t size)
+        {
+            hasher.update(data, size);
+        }
+
+        // strings are prefixed with their length so consecutive strings cannot run into each other
+        void add(std::string_view sv)
+        {
+            add(static_cast<std::uint64_t>(sv.size()));
+            add_bytes(sv.data(), sv.size());
+        }
+
+        template <typename T>
+            requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+        void add(T value)
+        {
+            add_bytes(&value, sizeof(value));
+        }
+
+        std::uint64_t value() const
+        {
+            return hasher.digest();
+        }
+    };
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace Utils
+{
+    /**
+     * streaming 64-bit xxHash (XXH64), used by the etl to fingerprint raw inputs and configs
+     * and by the scheduler to fingerprint schedule inputs, so unchanged work can be skipped on subsequent runs
+     */
+    class Hasher
+    {
+    private:
+        static constexpr std::uint64_t PRIME_1{0x9E3779B185EBCA87ULL};
+        static constexpr std::uint64_t PRIME_2{0xC2B2AE3D27D4EB4FULL};
+        static constexpr std::uint64_t PRIME_3{0x165667B19E3779F9ULL};
+        static constexpr std::uint64_t PRIME_4{0x85EBCA77C2B2AE63ULL};
+        static constexpr std::uint64_t PRIME_5{0x27D4EB2F165667C5ULL};
+
+        std::array<std::uint64_t, 4> lanes;
+        std::array<unsigned char, 32> stripe{};
+        std::size_t stripe_size{};
+        std::uint64_t total_size{};
+        std::uint64_t seed;
+
+    public:
+        explicit Hasher(std::uint64_t s = 0)
+            : lanes{s + PRIME_1 + PRIME_2, s + PRIME_2, s, s - PRIME_1}, seed(s) {}
+
+        void update(const void *data, std::size_t size)
+        {
+            const auto *input{static_cast<const unsigned char *>(data)};
+            total_size += size;
+
+            if (stripe_size + size < stripe.size())
+            {
+                std::memcpy(stripe.data() + stripe_size, input, size);
+                stripe_size += size;
+                return;
+            }
+
+            if (stripe_size > 0)
+            {
+                std::size_t fill{stripe.size() - stripe_size};
+                std::memcpy(stripe.data() + stripe_size, input, fill);
+                consume(stripe.data());
+                input += fill;
+                size -= fill;
+                stripe_size = 0;
+            }
+
+            while (size >= stripe.size())
+            {
+                consume(input);
+                input += stripe.size();
+                size -= stripe.size();
+            }
+
+            std::memcpy(stripe.data(), input, size);
+            stripe_size = size;
+        }
+
+        void update(std::string_view sv)
+        {
+            update(sv.data(), sv.size());
+        }
+
+        std::uint64_t digest() const
+        {
+            std::uint64_t hash{};
+
+            if (total_size >= stripe.size())
+            {
+                hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+                for (std::uint64_t lane : lanes)
+                {
+                    hash = merge_round(hash, lane);
+                }
+            }
+            else
+            {
+                hash = seed + PRIME_5;
+            }
+
+            hash += total_size;
+
+            const unsigned char *p{stripe.data()};
+            const unsigned char *end{stripe.data() + stripe_size};
+
+            while (p + 8 <= end)
+            {
+                hash ^= round(0, read_64(p));
+                hash = std::rotl(hash, 27) * PRIME_1 + PRIME_4;
+                p += 8;
+            }
+
+            if (p + 4 <= end)
+            {
+                hash ^= static_cast<std::uint64_t>(read_32(p)) * PRIME_1;
+                hash = std::rotl(hash, 23) * PRIME_2 + PRIME_3;
+                p += 4;
+            }
+
+            while (p < end)
+            {
+                hash ^= (*p) * PRIME_5;
+                hash = std::rotl(hash, 11) * PRIME_1;
+                ++p;
+            }
+
+            hash ^= hash >> 33;
+            hash *= PRIME_2;
+            hash ^= hash >> 29;
+            hash *= PRIME_3;
+            hash ^= hash >> 32;
+
+            return hash;
+        }
+
+    private:
+        static std::uint64_t round(std::uint64_t acc, std::uint64_t input)
+        {
+            acc += input * PRIME_2;
+            acc = std::rotl(acc, 31);
+            return acc * PRIME_1;
+        }
+
+        static std::uint64_t merge_round(std::uint64_t acc, std::uint64_t lane)
+        {
+            acc ^= round(0, lane);
+            return acc * PRIME_1 + PRIME_4;
+        }
+
+        // xxHash is defined over little-endian reads
+        static std::uint64_t read_64(const unsigned char *p)
+        {
+            std::uint64_t value{};
+            for (int i{7}; i >= 0; --i)
+            {
+                value = (value << 8) | p[i];
+            }
+            return value;
+        }
+
+        static std::uint32_t read_32(const unsigned char *p)
+        {
+            std::uint32_t value{};
+            for (int i{3}; i >= 0; --i)
+            {
+                value = (value << 8) | p[i];
+            }
+            return value;
+        }
+
+        void consume(const unsigned char *block)
+        {
+            for (std::size_t i{0}; i < lanes.size(); ++i)
+            {
+                lanes[i] = round(lanes[i], read_64(block + i * 8));
+            }
+        }
+    };
+}
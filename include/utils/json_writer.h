@@ -0,0 +1,221 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Utils
+{
+    /**
+     * streaming json writer, values are emitted in document order straight into a buffered file sink
+     * so no document tree is built, output matches nlohmann::json::dump(indent) for the same key order
+     */
+    class JsonWriter
+    {
+    private:
+        static constexpr std::size_t BUFFER_SIZE{1 << 16};
+
+        struct Scope
+        {
+            bool is_array;
+            bool empty;
+        };
+
+        std::ofstream out;
+        std::string buffer;
+        std::vector<Scope> scopes;
+        int indent;
+        bool after_key{false};
+
+    public:
+        explicit JsonWriter(const std::string &file_path, int indent = 2) : out(file_path, std::ios::out | std::ios::trunc), indent(indent)
+        {
+            if (!out.is_open())
+            {
+                throw std::runtime_error("Failed to open output file: " + file_path);
+            }
+            buffer.reserve(BUFFER_SIZE);
+        }
+
+        JsonWriter(const JsonWriter &) = delete;
+        JsonWriter &operator=(const JsonWriter &) = delete;
+
+        ~JsonWriter()
+        {
+            if (out.is_open())
+            {
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            }
+        }
+
+        void begin_object()
+        {
+            open('{', false);
+        }
+
+        void end_object()
+        {
+            close('}');
+        }
+
+        void begin_array()
+        {
+            open('[', true);
+        }
+
+        void end_array()
+        {
+            close(']');
+        }
+
+        /**
+         * @param name key of the next value, keys are written in the order given
+         */
+        void key(std::string_view name)
+        {
+            separate();
+            write_string(name);
+            buffer.append(": ");
+            after_key = true;
+        }
+
+        void value(std::int64_t number)
+        {
+            separate();
+
+            char digits[24];
+            auto [end, ec]{std::to_chars(digits, digits + sizeof(digits), number)};
+            buffer.append(digits, end);
+
+            flush_if_full();
+        }
+
+        void value(int number)
+        {
+            value(static_cast<std::int64_t>(number));
+        }
+
+        void value(std::string_view text)
+        {
+            separate();
+            write_string(text);
+            flush_if_full();
+        }
+
+        /**
+         * flushes the buffer and closes the file, throws std::runtime_error if any write failed
+         */
+        void finish()
+        {
+            if (!scopes.empty())
+            {
+                throw std::logic_error("Json document finished with open scopes");
+            }
+
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+            out.close();
+
+            if (!out)
+            {
+                throw std::runtime_error("Failed to write json output");
+            }
+        }
+
+    private:
+        void open(char bracket, bool is_array)
+        {
+            separate();
+            buffer.push_back(bracket);
+            scopes.push_back(Scope{is_array, true});
+        }
+
+        void close(char bracket)
+        {
+            bool empty{scopes.back().empty};
+            scopes.pop_back();
+
+            if (!empty)
+            {
+                newline();
+            }
+            buffer.push_back(bracket);
+
+            flush_if_full();
+        }
+
+        // a value either follows its key on the same line or starts a new indented line inside its container
+        void separate()
+        {
+            if (after_key)
+            {
+                after_key = false;
+                return;
+            }
+
+            if (scopes.empty())
+            {
+                return;
+            }
+
+            Scope &scope{scopes.back()};
+            if (!scope.empty)
+            {
+                buffer.push_back(',');
+            }
+            scope.empty = false;
+            newline();
+        }
+
+        void newline()
+        {
+            buffer.push_back('\n');
+            buffer.append(scopes.size() * static_cast<std::size_t>(indent), ' ');
+        }
+
+        void write_string(std::string_view text)
+        {
+            static constexpr char HEX[]{"0123456789abcdef"};
+
+            buffer.push_back('"');
+            for (char c : text)
+            {
+                switch (c)
+                {
+                case '"': buffer.append("\\\""); break;
+                case '\\': buffer.append("\\\\"); break;
+                case '\b': buffer.append("\\b"); break;
+                case '\f': buffer.append("\\f"); break;
+                case '\n': buffer.append("\\n"); break;
+                case '\r': buffer.append("\\r"); break;
+                case '\t': buffer.append("\\t"); break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        buffer.append("\\u00");
+                        buffer.push_back(HEX[(c >> 4) & 0xF]);
+                        buffer.push_back(HEX[c & 0xF]);
+                    }
+                    else
+                    {
+                        buffer.push_back(c);
+                    }
+                }
+            }
+            buffer.push_back('"');
+        }
+
+        void flush_if_full()
+        {
+            if (buffer.size() >= BUFFER_SIZE)
+            {
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+    };
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Utils
+{
+    /**
+     * read-only view of a whole file, memory mapped where the platform supports it
+     * so binary data files can be used in place without being parsed or copied
+     */
+    class MappedFile
+    {
+    private:
+        const char *bytes{nullptr};
+        std::size_t length{0};
+#if defined(_WIN32)
+        std::vector<char> buffer; // no mmap, fall back to a single read
+#endif
+
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::string &file_path)
+        {
+#if defined(_WIN32)
+            std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+            if (!file)
+            {
+                throw std::runtime_error("Failed to open: " + file_path);
+            }
+
+            buffer.resize(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0, std::ios::beg);
+            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+            bytes = buffer.data();
+            length = buffer.size();
+#else
+            int fd{::open(file_path.c_str(), O_RDONLY)};
+            if (fd < 0)
+            {
+                throw std::runtime_error("Failed to open: " + file_path);
+            }
+
+            struct stat info{};
+            if (::fstat(fd, &info) != 0)
+            {
+                ::close(fd);
+                throw std::runtime_error("Failed to stat: " + file_path);
+            }
+
+            length = static_cast<std::size_t>(info.st_size);
+            if (length > 0)
+            {
+                void *mapped{::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0)};
+                if (mapped == MAP_FAILED)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Failed to map: " + file_path);
+                }
+                bytes = static_cast<const char *>(mapped);
+            }
+
+            ::close(fd); // the mapping stays valid after the descriptor is closed
+#endif
+        }
+
+        ~MappedFile()
+        {
+            release();
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept
+        {
+            *this = std::move(other);
+        }
+
+        MappedFile &operator=(MappedFile &&other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+#if defined(_WIN32)
+                buffer = std::move(other.buffer);
+#endif
+                bytes = std::exchange(other.bytes, nullptr);
+                length = std::exchange(other.length, 0);
+            }
+            return *this;
+        }
+
+        const char *data() const
+        {
+            return bytes;
+        }
+
+        std::size_t size() const
+        {
+            return length;
+        }
+
+    private:
+        void release()
+        {
+#if !defined(_WIN32)
+            if (bytes != nullptr)
+            {
+                ::munmap(const_cast<char *>(bytes), length);
+            }
+#endif
+            bytes = nullptr;
+            length = 0;
+        }
+    };
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Utils
+{
+    /**
+     * transparent hash so string keyed containers can be probed with a string_view or c string
+     * without first constructing a std::string
+     */
+    struct StringHash
+    {
+        using is_transparent = void;
+        [[nodiscard]] size_t operator()(std::string_view sv) const noexcept
+        {
+            return std::hash<std::string_view>{}(sv);
+        }
+    };
+
+    /**
+     * bump allocator for character data, memory is handed out from fixed size blocks
+     * and only released when the arena is destroyed, so returned views stay valid for its lifetime
+     */
+    class Arena
+    {
+    private:
+        static constexpr std::size_t BLOCK_SIZE{1 << 16};
+
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char *cursor{};
+        std::size_t remaining{};
+
+    public:
+        Arena() = default;
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+        Arena(Arena &&) noexcept = default;
+        Arena &operator=(Arena &&) noexcept = default;
+
+        std::string_view store(std::string_view sv)
+        {
+            if (sv.empty())
+            {
+                return {};
+            }
+
+            if (sv.size() > remaining)
+            {
+                // oversized strings get a dedicated block so the current one keeps its free space
+                if (sv.size() > BLOCK_SIZE / 4)
+                {
+                    blocks.push_back(std::make_unique<char[]>(sv.size()));
+                    std::memcpy(blocks.back().get(), sv.data(), sv.size());
+                    return std::string_view(blocks.back().get(), sv.size());
+                }
+
+                blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+                cursor = blocks.back().get();
+                remaining = BLOCK_SIZE;
+            }
+
+            std::memcpy(cursor, sv.data(), sv.size());
+            std::string_view stored(cursor, sv.size());
+            cursor += sv.size();
+            remaining -= sv.size();
+
+            return stored;
+        }
+    };
+
+    /**
+     * interns strings into dense 32-bit ids, so containers can be keyed and joined on integers
+     * while each distinct string is copied into the arena exactly once
+     */
+    class StringPool
+    {
+    private:
+        Arena arena;
+        std::vector<std::string_view> strings;
+        std::unordered_map<std::string_view, std::uint32_t, StringHash, std::equal_to<>> ids;
+
+    public:
+        StringPool() = default;
+
+        /**
+         * @param sv string to intern
+         * @return id of the string, assigned in order of first appearance starting at 0
+         */
+        std::uint32_t intern(std::string_view sv)
+        {
+            auto it{ids.find(sv)};
+            if (it != ids.end())
+            {
+                return it->second;
+            }
+
+            std::string_view stored{arena.store(sv)};
+            std::uint32_t id{static_cast<std::uint32_t>(strings.size())};
+
+            strings.push_back(stored);
+            ids.emplace(stored, id);
+
+            return id;
+        }
+
+        /**
+         * @param sv string to look up
+         * @return id of the string, or nullopt if it was never interned
+         */
+        std::optional<std::uint32_t> find(std::string_view sv) const
+        {
+            auto it{ids.find(sv)};
+            return it != ids.end() ? std::make_optional(it->second) : std::nullopt;
+        }
+
+        std::string_view view(std::uint32_t id) const
+        {
+            return strings[id];
+        }
+
+        std::size_t size() const
+        {
+            return strings.size();
+        }
+
+        void reserve(std::size_t count)
+        {
+            strings.reserve(count);
+            ids.reserve(count);
+        }
+    };
+}
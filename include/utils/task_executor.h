@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Utils
+{
+    /**
+     * tasks and the order they have to run in, built once and run as often as needed, a task runs once every
+     * task that precedes it has returned
+     */
+    class TaskGraph
+    {
+    public:
+        using Task = std::function<void()>;
+
+        std::size_t add(Task task)
+        {
+            nodes.emplace_back().task = std::move(task);
+            return nodes.size() - 1;
+        }
+
+        void precede(std::size_t before, std::size_t after)
+        {
+            nodes[before].successors.push_back(after);
+            ++nodes[after].dependencies;
+        }
+
+        std::size_t size() const
+        {
+            return nodes.size();
+        }
+
+    private:
+        friend class TaskExecutor;
+
+        struct Node
+        {
+            Task task;
+            std::vector<std::size_t> successors;
+            int dependencies{0};
+            std::atomic<int> pending{0}; // predecessors that have not returned in the current run
+        };
+
+        std::deque<Node> nodes; // a deque since nodes hold an atomic and cannot move
+    };
+
+    /**
+     * work stealing executor for task graphs, every thread has a deque of ready tasks it takes from the back of
+     * and idle threads steal from the front of the others, tasks made ready by a task go to the deque of the
+     * thread that ran it, the calling thread takes part in every run and threads without work sleep until a
+     * task is queued
+     */
+    class TaskExecutor
+    {
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<TaskGraph::Node *> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues; // by thread, the calling thread is 0
+        std::vector<std::thread> threads;
+
+        std::mutex mutex;
+        std::condition_variable work_cv; // a task was queued, the run ended, or the executor is stopping
+        TaskGraph *graph{nullptr};
+        std::atomic<std::size_t> queued{0};    // tasks in any deque
+        std::atomic<std::size_t> remaining{0}; // tasks of the current run that have not returned
+        bool stopping{false};
+        std::exception_ptr error;
+
+        void push(std::size_t self, TaskGraph::Node *node)
+        {
+            {
+                std::lock_guard lock(queues[self]->mutex);
+                queues[self]->tasks.push_back(node);
+            }
+            queued.fetch_add(1, std::memory_order_release);
+
+            // taking the lock orders the notify after a sleeper checked queued, so the wake up is not lost
+            {
+                std::lock_guard lock(mutex);
+            }
+            work_cv.notify_one();
+        }
+
+        TaskGraph::Node *take(Queue &queue, bool back)
+        {
+            std::lock_guard lock(queue.mutex);
+            if (queue.tasks.empty())
+            {
+                return nullptr;
+            }
+
+            TaskGraph::Node *node{back ? queue.tasks.back() : queue.tasks.front()};
+            if (back)
+            {
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                queue.tasks.pop_front();
+            }
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return node;
+        }
+
+        TaskGraph::Node *next_task(std::size_t self)
+        {
+            if (TaskGraph::Node *node{take(*queues[self], true)})
+            {
+                return node;
+            }
+
+            for (std::size_t offset{1}; offset < queues.size(); ++offset)
+            {
+                if (TaskGraph::Node *node{take(*queues[(self + offset) % queues.size()], false)})
+                {
+                    return node;
+                }
+            }
+
+            return nullptr;
+        }
+
+        void execute(std::size_t self, TaskGraph::Node *node)
+        {
+            try
+            {
+                node->task();
+            }
+            catch (...)
+            {
+                std::lock_guard lock(mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+
+            for (std::size_t successor : node->successors)
+            {
+                TaskGraph::Node *next{&graph->nodes[successor]};
+                if (next->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    push(self, next);
+                }
+            }
+
+            // only after its successors are queued, so the run cannot end while they are in flight
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                {
+                    std::lock_guard lock(mutex);
+                }
+                work_cv.notify_all();
+            }
+        }
+
+        void work(std::size_t self)
+        {
+            while (true)
+            {
+                if (TaskGraph::Node *node{next_task(self)})
+                {
+                    execute(self, node);
+                    continue;
+                }
+
+                std::unique_lock lock(mutex);
+                work_cv.wait(lock, [&]
+                             { return stopping || queued.load(std::memory_order_acquire) > 0; });
+                if (stopping)
+                {
+                    return;
+                }
+            }
+        }
+
+    public:
+        /**
+         * @param thread_count threads that run tasks, the calling thread included, so thread_count - 1 are started
+         */
+        explicit TaskExecutor(std::size_t thread_count)
+        {
+            queues.resize(std::max<std::size_t>(thread_count, 1));
+            for (auto &queue : queues)
+            {
+                queue = std::make_unique<Queue>();
+            }
+
+            for (std::size_t i{1}; i < queues.size(); ++i)
+            {
+                threads.emplace_back([this, i]
+                                     { work(i); });
+            }
+        }
+
+        ~TaskExecutor()
+        {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            work_cv.notify_all();
+
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+        TaskExecutor(const TaskExecutor &) = delete;
+        TaskExecutor &operator=(const TaskExecutor &) = delete;
+
+        std::size_t size() const
+        {
+            return queues.size();
+        }
+
+        /**
+         * runs every task of the graph once in dependency order and returns when all have returned, the first
+         * exception thrown by a task is rethrown here once the run is over, tasks after it still run
+         */
+        void run(TaskGraph &task_graph)
+        {
+            if (task_graph.nodes.empty())
+            {
+                return;
+            }
+
+            {
+                std::lock_guard lock(mutex);
+                graph = &task_graph;
+                error = nullptr;
+            }
+
+            // every counter is reset before the first task is queued, a task taken early would otherwise
+            // release successors whose counters are then overwritten
+            for (auto &node : task_graph.nodes)
+            {
+                node.pending.store(node.dependencies, std::memory_order_relaxed);
+            }
+            remaining.store(task_graph.nodes.size(), std::memory_order_relaxed);
+
+            // tasks without predecessors are dealt out so every thread starts with work, queueing publishes
+            // the counters above to the thread that takes the task
+            std::size_t next_queue{0};
+            for (auto &node : task_graph.nodes)
+            {
+                if (node.dependencies == 0)
+                {
+                    push(next_queue, &node);
+                    next_queue = (next_queue + 1) % queues.size();
+                }
+            }
+
+            while (remaining.load(std::memory_order_acquire) > 0)
+            {
+                if (TaskGraph::Node *node{next_task(0)})
+                {
+                    execute(0, node);
+                    continue;
+                }
+
+                std::unique_lock lock(mutex);
+                work_cv.wait(lock, [&]
+                             { return remaining.load(std::memory_order_acquire) == 0 || queued.load(std::memory_order_acquire) > 0; });
+            }
+
+            std::exception_ptr thrown{};
+            {
+                std::lock_guard lock(mutex);
+                thrown = std::exchange(error, nullptr);
+            }
+
+            if (thrown)
+            {
+                std::rethrow_exception(thrown);
+            }
+        }
+    };
+}
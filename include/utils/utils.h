@@ -35,9 +35,12 @@ namespace Utils
         return std::string_view(begin, end - begin);
     }
 
-    inline std::vector<std::string_view> split(std::string_view sv, char delimiter)
+    /**
+     * split into a caller owned vector, reusing its capacity across rows of a large file
+     */
+    inline void split_into(std::string_view sv, char delimiter, std::vector<std::string_view> &tokens)
     {
-        std::vector<std::string_view> tokens{};
+        tokens.clear();
         size_t start{};
         while (true)
         {
@@ -53,7 +56,12 @@ namespace Utils
             tokens.emplace_back(sv.substr(start, pos - start));
             start = pos + 1;
         }
+    }
 
+    inline std::vector<std::string_view> split(std::string_view sv, char delimiter)
+    {
+        std::vector<std::string_view> tokens{};
+        split_into(sv, delimiter, tokens);
         return tokens;
     }
 
@@ -118,17 +126,28 @@ namespace Utils
         return true;
     }
 
-    inline std::unordered_map<std::string_view, std::string_view> from_tokens(const std::vector<std::string_view> &tokens, const std::unordered_map<std::string_view, int> &column_index)
+    /**
+     * fill a caller owned row, its columns stay the same from row to row so the map only allocates once
+     */
+    inline void from_tokens_into(const std::vector<std::string_view> &tokens, const std::unordered_map<std::string_view, int> &column_index, std::unordered_map<std::string_view, std::string_view> &row)
     {
-        std::unordered_map<std::string_view, std::string_view> row{};
         for (auto &[column, index] : column_index)
         {
             if (index < tokens.size())
             {
                 row[column] = Utils::trim(tokens[index]);
             }
+            else
+            {
+                row.erase(column);
+            }
         }
+    }
 
+    inline std::unordered_map<std::string_view, std::string_view> from_tokens(const std::vector<std::string_view> &tokens, const std::unordered_map<std::string_view, int> &column_index)
+    {
+        std::unordered_map<std::string_view, std::string_view> row{};
+        from_tokens_into(tokens, column_index, row);
         return row;
     }
 
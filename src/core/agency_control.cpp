@@ -1,8 +1,11 @@
+#include <algorithm>
 #include <format>
+#include <limits>
 
 #include "utils/utils.h"
 #include "core/dispatch.h"
 #include "core/agency_control.h"
+#include "system/schedule_validator.h"
 
 AgencyControl::AgencyControl(Constants::System sc, const std::string &sn, const Transit::Map::Graph &g, const Registry &r, CentralLogger &cl)
     : system_code(sc), system_name(sn), current_tick(0), simulation_complete(false)
@@ -21,6 +24,11 @@ std::string AgencyControl::get_system_name() const
     return system_name;
 }
 
+TimingWheel &AgencyControl::get_timers()
+{
+    return timers;
+}
+
 Dispatch *AgencyControl::get_dispatch(TrainLine train_line) const
 {
     auto it{std::ranges::find_if(dispatchers, [train_line](auto &dispatch)
@@ -59,40 +67,105 @@ void AgencyControl::inactivate(Dispatch *dispatch)
     }
 }
 
+std::size_t AgencyControl::get_line_count() const
+{
+    return dispatchers.size();
+}
+
 void AgencyControl::run(int tick)
+{
+    prepare_tick(tick);
+
+    for (std::size_t line{0}; line < running.size(); ++line)
+    {
+        authorize_line(line, tick);
+    }
+
+    finish_tick(tick);
+}
+
+void AgencyControl::prepare_tick(int tick)
 {
     current_tick = tick;
+    running.clear();
 
     if (!simulation_complete)
     {
+        // repairs and dwell that end by this tick, including those of skipped ticks
+        timers.advance(tick);
 
-        std::erase_if(failed_switches, [&](Switch *sw)
-                      {
-                        sw->update_repair();
-                        if (sw->is_functional())
-                        {
-                            logger->critical(std::format("Switch {} restored at tick {}", sw->get_id(), current_tick));
-                            return true;
-                        }
-                        else
-                        {
-                            return false;
-                        } });
-
-        for (auto *dispatch : active_dispatchers)
+        for (const auto &dispatch : dispatchers)
         {
-            dispatch->authorize(tick);
+            if (active_dispatchers.contains(dispatch.get()))
+            {
+                running.push_back(dispatch.get());
+            }
         }
 
-        resolve_switches();
-
-        for (auto *dispatch : active_dispatchers)
+        // spawns occupy platforms other lines may share, so only the train loop of each line runs concurrently
+        for (auto *dispatch : running)
         {
-            dispatch->execute(tick);
+            dispatch->prepare(tick);
         }
     }
 }
 
+void AgencyControl::authorize_line(std::size_t line, int tick)
+{
+    if (line < running.size())
+    {
+        running[line]->authorize_trains(tick);
+    }
+}
+
+void AgencyControl::finish_tick(int tick)
+{
+    if (running.empty())
+    {
+        return;
+    }
+
+    settle_claims();
+
+    for (auto *dispatch : running)
+    {
+        dispatch->submit(tick);
+    }
+
+    resolve_switches();
+
+    for (auto *dispatch : running)
+    {
+        dispatch->execute(tick);
+    }
+}
+
+int AgencyControl::next_event_tick() const
+{
+    if constexpr (!Constants::EVENT_DRIVEN)
+    {
+        return current_tick + 1;
+    }
+
+    int next{std::numeric_limits<int>::max()};
+    if (simulation_complete)
+    {
+        return next;
+    }
+
+    if (auto expiry{timers.next_expiry()})
+    {
+        next = *expiry;
+    }
+
+    for (const auto *dispatch : active_dispatchers)
+    {
+        next = std::min(next, dispatch->next_event_tick(current_tick));
+    }
+
+    return next;
+}
+
 void AgencyControl::request_switch(Train *train, Switch *sw, Track *from, Track *to, int priority, int tick, Dispatch *dispatch)
 {
     auto existing{train_to_request.find(train)};
@@ -131,6 +204,25 @@ void AgencyControl::request_switch(Train *train, Switch *sw, Track *from, Track
     train_to_request[train] = {sw, new_it};
 }
 
+void AgencyControl::fail_signal(int tick, Signal *signal, int time_to_repair, TrainLine train_line)
+{
+    signal->set_failure(time_to_repair);
+
+    // the failure tick counts toward the repair
+    auto [repair, inserted]{signal_repairs.try_emplace(signal, TimingWheel::Handle{}, train_line)};
+    if (!inserted)
+    {
+        timers.cancel(repair->second.first);
+        repair->second.second = train_line;
+    }
+
+    repair->second.first = timers.schedule(tick + time_to_repair - 1, [this, signal](int at)
+                                           {
+        auto node{signal_repairs.extract(signal)};
+        signal->repair();
+        logger->critical(std::format("Signal {} restored on {} line at tick {}", signal->get_id(), trainline_to_string(node.mapped().second), at)); });
+}
+
 void AgencyControl::resolve_switches()
 {
     granted_links.clear();
@@ -154,7 +246,10 @@ void AgencyControl::resolve_switches()
             {
                 int time_to_repair{std::max<int>(1, Utils::random_in_range(Constants::MAX_DELAY))};
                 sw->set_failure(time_to_repair);
-                failed_switches.insert(sw);
+                timers.schedule(current_tick + time_to_repair, [this, sw](int tick)
+                                {
+                                    sw->repair();
+                                    logger->critical(std::format("Switch {} restored at tick {}", sw->get_id(), tick)); });
 
                 logger->critical(std::format("Switch {} failure at tick {}", sw->get_id(), current_tick));
                 continue;
@@ -179,13 +274,102 @@ void AgencyControl::resolve_switches()
     }
 }
 
+void AgencyControl::settle_claims()
+{
+    struct Claim
+    {
+        Track *track;
+        Train *train;
+        Dispatch *dispatch;
+    };
+
+    std::vector<Claim> claims{};
+    for (auto *dispatch : running)
+    {
+        for (const auto &[train, track] : dispatch->get_authorizations())
+        {
+            if (shared_tracks[track->get_id()])
+            {
+                claims.push_back({track, train, dispatch});
+            }
+        }
+    }
+
+    if (claims.size() < 2)
+    {
+        return;
+    }
+
+    std::ranges::sort(claims, [](const Claim &a, const Claim &b)
+                      { return std::pair{a.track->get_id(), a.train->get_slot()} < std::pair{b.track->get_id(), b.train->get_slot()}; });
+
+    for (std::size_t i{1}; i < claims.size(); ++i)
+    {
+        if (claims[i].track == claims[i - 1].track)
+        {
+            claims[i].dispatch->withdraw(claims[i].train);
+        }
+    }
+}
+
 void AgencyControl::run_factory(const Transit::Map::Graph &graph, const Registry &registry)
 {
     factory->build_network(graph, registry, system_code);
 }
 
+void AgencyControl::validate_schedule() const
+{
+    static constexpr const char *conflict_names[]{"platform", "block", "headway"};
+
+    std::vector<ScheduleValidator::Conflict> conflicts{ScheduleValidator(*factory).validate(*schedule_index)};
+    if (conflicts.empty())
+    {
+        logger->info(std::format("Schedule of {} has no conflicts", system_name));
+        return;
+    }
+
+    logger->warn(std::format("Schedule of {} has {} conflicts", system_name, conflicts.size()));
+    for (const auto &conflict : conflicts)
+    {
+        logger->warn(std::format("{} conflict at {} between trains {} and {} at tick {}", conflict_names[static_cast<int>(conflict.type)],
+                                 conflict.resource_id, conflict.first_train, conflict.second_train, conflict.tick));
+    }
+}
+
 void AgencyControl::issue_dispatchers()
 {
+    try
+    {
+        schedule_index = std::make_unique<ScheduleIndex>(std::string(SCHED_DIRECTORY) + "/" + system_name + "/schedule.bin");
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Failed to load schedule for " << system_name << ": " << e.what() << "\n";
+    }
+
+    if constexpr (Constants::VALIDATE_SCHEDULE)
+    {
+        if (schedule_index != nullptr)
+        {
+            validate_schedule();
+        }
+    }
+
+    shared_tracks.assign(factory->get_tracks().size(), 0);
+    std::vector<std::uint8_t> line_count(shared_tracks.size(), 0);
+    for (const LineTopology *topology : factory->get_topologies())
+    {
+        for (Track *track : topology->get_tracks())
+        {
+            std::size_t id{static_cast<std::size_t>(track->get_id())};
+            line_count[id] = static_cast<std::uint8_t>(std::min(line_count[id] + 1, 2));
+            shared_tracks[id] = line_count[id] > 1;
+        }
+    }
+
+    signal_propagator = std::make_unique<SignalPropagator>(factory->get_tracks(), factory->get_topologies(), logger.get());
+    signal_propagator->initialize(factory->get_tracks());
+
     auto issue = [&](const auto &line)
     {
         std::visit([&](const auto &l)
@@ -195,11 +379,14 @@ void AgencyControl::issue_dispatchers()
         {
             auto train_line{static_cast<T>(i)};
 
-            const auto &trains{factory->get_trains(train_line)};
-            const auto &stations{factory->get_stations(train_line)};
+            auto trains{factory->get_trains(train_line)};
+            auto stations{factory->get_stations(train_line)};
 
-            auto& dispatch {dispatchers.emplace_back(std::make_unique<Dispatch>(this, train_line, stations, trains, logger.get()))};
-            dispatch->load_schedule();
+            auto& dispatch {dispatchers.emplace_back(std::make_unique<Dispatch>(this, train_line, stations, trains, factory->get_topology(train_line), signal_propagator.get(), logger.get()))};
+            if (schedule_index != nullptr)
+            {
+                dispatch->load_schedule(*schedule_index);
+            }
 
             active_dispatchers.insert(dispatch.get());
         } }, line);
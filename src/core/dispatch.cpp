@@ -3,22 +3,21 @@
  * docs/dispatch.md
  */
 
-#include <fstream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <ranges>
 #include <algorithm>
 #include <format>
-
-#include <nlohmann/json.hpp>
+#include <limits>
 
 #include "utils/utils.h"
 #include "core/agency_control.h"
 #include "core/dispatch.h"
 #include "constants/constants.h"
 
-Dispatch::Dispatch(AgencyControl *ac, TrainLine tl, const std::vector<Station *> &st, const std::vector<Train *> &tn, Logger *log)
-    : agency_control(ac), train_line(tl), trains(tn), logger(log)
+Dispatch::Dispatch(AgencyControl *ac, TrainLine tl, std::span<Station *const> st, std::span<Train *const> tn, const LineTopology &topo, SignalPropagator *sp, Logger *log)
+    : agency_control(ac), train_line(tl), trains(tn.begin(), tn.end()), logger(log), topology(&topo), signal_propagator(sp)
 {
     authorized.reserve(tn.size());
 
@@ -29,11 +28,46 @@ Dispatch::Dispatch(AgencyControl *ac, TrainLine tl, const std::vector<Station *>
         if (station->is_yard())
         {
             yards.push_back(station);
+            yard_departures.emplace(station->get_id(), std::multimap<int, Event>{});
+        }
+    }
+
+    train_schedules.resize(trains.size());
+
+    // the factory keeps the trains of a line in consecutive slots of one store, so their dwell is counted down in one sweep
+    if (!trains.empty())
+    {
+        train_state = trains.front()->get_state_store();
+        train_slots = {trains.front()->get_slot(), trains.front()->get_slot() + trains.size()};
+
+        for (std::size_t i{0}; i < trains.size(); ++i)
+        {
+            if (trains[i]->get_state_store() != train_state || trains[i]->get_slot() != train_slots.first + i)
+            {
+                throw std::logic_error("Trains of train line " + trainline_to_string(train_line) + " do not occupy consecutive state slots");
+            }
         }
-        schedule.emplace(station->get_id(), EventQueues{});
     }
 
-    schedule.reserve(st.size());
+    // ids of a line only differ in direction and instance, which are small and dense, see docs/system/registry.md
+    for (std::size_t i{0}; i < trains.size(); ++i)
+    {
+        TrainId id{trains[i]->get_id()};
+        std::size_t direction_code{static_cast<std::size_t>(Registry::direction_code_of(id))};
+        std::size_t instance{static_cast<std::size_t>(Registry::instance_of(id))};
+
+        if (direction_code >= train_index.size())
+        {
+            train_index.resize(direction_code + 1);
+        }
+        if (instance >= train_index[direction_code].size())
+        {
+            train_index[direction_code].resize(instance + 1, UINT32_MAX);
+        }
+        train_index[direction_code][instance] = static_cast<std::uint32_t>(i);
+    }
+
+    active_trains.reserve(trains.size());
 }
 
 TrainLine Dispatch::get_train_line() const
@@ -51,99 +85,88 @@ const std::vector<Train *> &Dispatch::get_trains() const
     return trains;
 }
 
+const std::vector<Train *> &Dispatch::get_active_trains() const
+{
+    return active_trains;
+}
+
 const std::vector<std::pair<Train *, Track *>> &Dispatch::get_authorizations() const
 {
     return authorized;
 }
 
-const std::unordered_map<int, EventQueues> &Dispatch::get_station_schedules() const
+const std::vector<TrainSchedule> &Dispatch::get_train_schedules() const
 {
-    return schedule;
+    return train_schedules;
 }
 
-void Dispatch::load_schedule()
+const std::unordered_map<int, std::multimap<int, Event>> &Dispatch::get_yard_departures() const
 {
-    using json = nlohmann::json;
-
-    std::string file_path{std::string(SCHED_DIRECTORY) + "/" + agency_control->get_system_name() + "/schedule.json"};
-
-    std::ifstream file(file_path);
-    if (!file.is_open())
-    {
-        std::cerr << "Failed to open schedule file for " << agency_control->get_system_name() << " at " << train_line << " dispatch\n";
-        return;
-    }
+    return yard_departures;
+}
 
-    json input_json{};
-    try
-    {
-        file >> input_json;
-    }
-    catch (const json::parse_error &e)
+void Dispatch::load_schedule(const ScheduleIndex &index)
+{
+    auto trips{index.get_trips(train_line)};
+    if (trips.empty())
     {
-        std::cerr << "Failed to parse JSON file " << file_path << ": " << e.what() << "\n";
+        std::cerr << "Train line " << trainline_to_string(train_line) << " not found in schedule\n";
         return;
     }
 
-    std::string train_line_name{trainline_to_string(train_line)};
+    schedule_index = &index;
 
-    if (!input_json.contains("train_lines") || !input_json["train_lines"].contains(train_line_name))
+    pending_trips.clear();
+    pending_trips.reserve(trips.size());
+    remaining_trips.clear();
+    for (const auto &trip : trips)
     {
-        std::cerr << "Train line " << train_line_name << " not found in schedule\n";
+        pending_trips.push_back(&trip);
+        ++remaining_trips[trip.train_id];
     }
 
-    auto trains_json = input_json["train_lines"][train_line_name]["trains"];
-    for (const auto &t_json : trains_json)
-    {
-        int train_id{t_json["train_id"]};
-        std::string headsign{t_json["headsign"]};
-        std::optional<Direction> dir_opt{direction_from_string(t_json["direction"])};
-        if (!dir_opt.has_value())
-        {
-            std::cerr << "Invalid direction for train " << train_id << "\n";
-            continue;
-        }
-        Direction direction{*dir_opt};
-
-        for (const auto &s_json : t_json["schedule"])
-        {
-            int station_id{s_json["station_id"]};
-            int arrival_tick{s_json["arrival_tick"]};
-            int departure_tick{s_json["departure_tick"]};
-
-            if (arrival_tick != -1)
-            {
-                schedule[station_id].arrivals.emplace(
-                    arrival_tick,
-                    Event{arrival_tick, train_id, station_id, direction, EventType::ARRIVAL});
-            }
-
-            if (departure_tick != -1)
-            {
-                schedule[station_id].departures.emplace(
-                    departure_tick,
-                    Event{departure_tick, train_id, station_id, direction, EventType::DEPARTURE});
-            }
-        }
-    }
+    std::ranges::stable_sort(pending_trips, {}, [](const ScheduleFormat::Trip *trip)
+                             { return trip->start_tick; });
+    next_trip = 0;
 }
 
 void Dispatch::authorize(int tick)
+{
+    prepare(tick);
+    authorize_trains(tick);
+    submit(tick);
+}
+
+void Dispatch::prepare(int tick)
 {
     authorized.clear();
+    switch_claims.clear();
+    signal_failures.clear();
+
+    release_trips(tick);
     handle_spawns(tick);
+}
 
-    for (Train *train : trains)
+void Dispatch::authorize_trains(int tick)
+{
+    if constexpr (Constants::EVENT_DRIVEN)
     {
-        if (train == nullptr || !train->is_active())
-        {
-            continue;
-        }
+        collect_ready_trains();
+    }
+    else if (!active_trains.empty())
+    {
+        // trains parked in a yard are not counted down, so the sweep only spans the trains in service
+        train_state->count_down_dwell(active_trains.front()->get_slot(), active_trains.back()->get_slot() + 1);
+    }
 
-        if (train->request_movement())
+    // tick by tick every train in service is visited and the ready flag skips those still dwelling
+    const std::vector<Train *> &candidates{Constants::EVENT_DRIVEN ? ready_trains : active_trains};
+    for (Train *train : candidates)
+    {
+        if (train->is_ready())
         {
             Track *current{train->get_current_track()};
-            Track *next{current->get_next_track(train_line)};
+            Track *next{topology->get_next_track(current)};
 
             if (!next)
             {
@@ -160,8 +183,7 @@ void Dispatch::authorize(int tick)
 
             if (sw != nullptr)
             {
-                int priority{calculate_switch_priority(tick, train)};
-                agency_control->request_switch(train, sw, current, next, priority, tick, this);
+                switch_claims.emplace_back(train, next);
                 continue;
             }
 
@@ -169,60 +191,63 @@ void Dispatch::authorize(int tick)
             auto signal_delay{randomize_delay(Constants::SIGNAL_FAILURE_PROBABILITY)};
             if (signal_delay.first == true)
             {
-                int time_to_repair{signal_delay.second};
-                signal->set_failure(time_to_repair);
-                failed_signals.insert(signal);
-
-                logger->critical(std::format("Signal {} failed on {} line at tick {}", signal->get_id(), trainline_to_string(train_line), tick));
+                signal_failures.emplace_back(signal, signal_delay.second);
                 continue;
             }
 
-            handle_signal_state(tick, signal);
             authorized.emplace_back(train, next);
         }
     }
 }
 
-void Dispatch::execute(int tick)
+void Dispatch::submit(int tick)
 {
-    std::erase_if(failed_signals, [&](Signal *signal)
-                  {
-    signal->update_repair();
-    if (signal->is_functional())
+    for (const auto &[signal, time_to_repair] : signal_failures)
     {
-        logger->critical(std::format("Signal {} restored on {} line at tick {}", signal->get_id(), trainline_to_string(train_line), tick));
-        return true;
+        agency_control->fail_signal(tick, signal, time_to_repair, train_line);
+        logger->critical(std::format("Signal {} failed on {} line at tick {}", signal->get_id(), trainline_to_string(train_line), tick));
     }
-    else
+
+    for (const auto &[train, next] : switch_claims)
     {
-        return false;
-    } });
+        int priority{calculate_switch_priority(tick, train)};
+        agency_control->request_switch(train, next->get_inbound_switch(), train->get_current_track(), next, priority, tick, this);
+    }
+}
 
+void Dispatch::withdraw(Train *train)
+{
+    std::erase_if(authorized, [train](const auto &entry)
+                  { return entry.first == train; });
+}
+
+void Dispatch::execute(int tick)
+{
     std::vector<std::pair<Train *, Track *>> switch_granted{agency_control->get_granted_links(this)};
 
     for (const auto &[train, next_track] : switch_granted)
     {
         authorized.emplace_back(train, next_track);
-        Signal *signal{next_track->get_signal()};
-        handle_signal_state(tick, signal);
     }
 
+    moved_trains.clear();
     for (const auto &[train, next_track] : authorized)
     {
+        Track *previous_track{train->get_current_track()};
         bool moved{train->move_to_track(next_track)};
-        Signal *signal{next_track->get_signal()};
-
-        handle_signal_state(tick, signal, true);
 
         if (moved)
         {
+            moved_trains.push_back(train);
+            signal_propagator->on_occupancy_change(tick, previous_track);
+            signal_propagator->on_occupancy_change(tick, next_track);
+
             if (train->is_arriving())
             {
                 Platform *arrival_platform{static_cast<Platform *>(train->get_current_track())};
                 const Station *arrival_station{arrival_platform->get_station()};
 
-                auto &arrivals{schedule[arrival_station->get_id()].arrivals};
-                std::optional<Event> event_opt{process_event(tick, arrivals, train)};
+                std::optional<Event> event_opt{process_event(train, arrival_station->get_id(), EventType::ARRIVAL)};
 
                 if (event_opt.has_value())
                 {
@@ -262,7 +287,7 @@ void Dispatch::execute(int tick)
             }
             else if (train->is_departing())
             {
-                Platform *departure_platform{static_cast<Platform *>(train->get_current_track()->get_prev_track(train_line))};
+                Platform *departure_platform{static_cast<Platform *>(topology->get_prev_track(train->get_current_track()))};
                 const Station *departure_station{departure_platform->get_station()};
 
                 if (departure_station->is_yard())
@@ -270,8 +295,7 @@ void Dispatch::execute(int tick)
                     continue;
                 }
 
-                auto &departures{schedule[departure_station->get_id()].departures};
-                std::optional<Event> event_opt{process_event(tick, departures, train)};
+                std::optional<Event> event_opt{process_event(train, departure_station->get_id(), EventType::DEPARTURE)};
 
                 if (event_opt.has_value())
                 {
@@ -291,69 +315,200 @@ void Dispatch::execute(int tick)
             }
         }
     }
+
+    if constexpr (Constants::EVENT_DRIVEN)
+    {
+        // scheduled once platform delays are added, dwell counts down from the next tick
+        for (Train *train : moved_trains)
+        {
+            train_state->ready[train->get_slot()] = 0;
+            if (train->is_active())
+            {
+                schedule_wakeup(tick, tick + 1, train);
+            }
+        }
+    }
 }
 
-void Dispatch::handle_signal_state(int tick, Signal *signal, bool set_red)
+int Dispatch::next_event_tick(int tick) const
 {
-    Track *track{signal->get_track()};
-    SignalState new_state{};
+    // trains held by an occupied block, a switch, or a failed signal try again every tick
+    if (!ready_trains.empty())
+    {
+        return tick + 1;
+    }
+
+    int next{std::numeric_limits<int>::max()};
 
-    if (set_red == true || track->is_occupied())
+    if (next_trip < pending_trips.size())
     {
-        new_state = SignalState::RED;
+        next = std::min(next, pending_trips[next_trip]->start_tick);
     }
-    else if (needs_yellow_signal(track))
+
+    for (Station *yard : yards)
     {
-        new_state = SignalState::YELLOW;
+        const auto &departures{yard_departures.at(yard->get_id())};
+        if (!departures.empty())
+        {
+            next = std::min(next, departures.begin()->first);
+        }
     }
-    else
+
+    // overdue spawns wait for a free yard platform
+    return std::max(next, tick + 1);
+}
+
+Train *Dispatch::find_train(TrainId train_id) const
+{
+    std::size_t direction_code{static_cast<std::size_t>(Registry::direction_code_of(train_id))};
+    std::size_t instance{static_cast<std::size_t>(Registry::instance_of(train_id))};
+
+    if (train_id < 0 || direction_code >= train_index.size() || instance >= train_index[direction_code].size())
+    {
+        return nullptr;
+    }
+
+    // the index only decodes direction and instance, ids of other lines can land on a train of this one
+    std::uint32_t index{train_index[direction_code][instance]};
+    if (index == UINT32_MAX || trains[index]->get_id() != train_id)
     {
-        new_state = SignalState::GREEN;
+        return nullptr;
     }
 
-    signal->change_state(new_state);
-    logger->info(std::format("Signal {} changed state to {} at tick {}", signal->get_id(), signal_state_to_string(signal->get_state()), tick));
+    return trains[index];
 }
 
-bool Dispatch::needs_yellow_signal(Track *track)
+void Dispatch::activate(Train *train)
 {
-    if (track == nullptr)
+    // kept in slot order so trains in service are visited in the order of the full fleet
+    auto position{std::ranges::lower_bound(active_trains, train->get_slot(), {}, &Train::get_slot)};
+    if (position == active_trains.end() || *position != train)
     {
-        return false;
+        active_trains.insert(position, train);
     }
+}
 
-    Track *next{track->get_next_track(train_line)};
-    if (next == nullptr)
+void Dispatch::deactivate(Train *train)
+{
+    auto position{std::ranges::lower_bound(active_trains, train->get_slot(), {}, &Train::get_slot)};
+    if (position != active_trains.end() && *position == train)
     {
-        return false;
+        active_trains.erase(position);
     }
+}
+
+void Dispatch::collect_ready_trains()
+{
+    // trains whose dwell ended were added by their timers, those that moved since are dropped
+    std::erase_if(ready_trains, [](Train *train)
+                  { return !train->is_active() || !train->is_ready(); });
+
+    // visited in slot order like the tick by tick sweep, so both modes resolve conflicts the same way
+    std::ranges::sort(ready_trains, {}, &Train::get_slot);
+    auto duplicates{std::ranges::unique(ready_trains)};
+    ready_trains.erase(duplicates.begin(), duplicates.end());
+}
+
+void Dispatch::schedule_wakeup(int tick, int from_tick, Train *train)
+{
+    int ready_tick{from_tick + train->get_dwell()};
+    if (ready_tick <= tick)
+    {
+        set_ready(train);
+        return;
+    }
+
+    agency_control->get_timers().schedule(ready_tick, [this, train](int)
+                                          { set_ready(train); });
+}
 
-    Track *next_next{next->get_next_track(train_line)};
-    return next->is_occupied() || (next_next && next_next->is_occupied());
+void Dispatch::set_ready(Train *train)
+{
+    if (train->is_active())
+    {
+        // the state the tick by tick count down would have reached
+        train_state->dwell_timer[train->get_slot()] = 0;
+        train_state->ready[train->get_slot()] = 1;
+        ready_trains.push_back(train);
+    }
 }
 
-std::optional<Event> Dispatch::process_event(int tick, std::multimap<int, Event> &event_map, Train *train)
+std::optional<Event> Dispatch::process_event(Train *train, int station_id, EventType type)
 {
-    int train_id = train->get_id();
+    TrainSchedule &train_schedule{train_schedules[train->get_slot() - train_slots.first]};
 
-    for (auto it = event_map.begin(); it != event_map.end(); ++it)
+    // a train on time is at the stop under its cursor, stops it passed without one are skipped
+    for (std::size_t i{train_schedule.cursor}; i < train_schedule.stops.size(); ++i)
     {
-        if (it->second.train_id == train_id)
+        const Event &stop{train_schedule.stops[i]};
+        if (stop.station_id == station_id && stop.type == type)
         {
-            Event found_event = it->second;
-            event_map.erase(it);
-            return found_event;
+            train_schedule.cursor = i + 1;
+            return stop;
         }
     }
 
     return std::nullopt;
 }
 
+void Dispatch::release_trips(int tick)
+{
+    while (next_trip < pending_trips.size() && pending_trips[next_trip]->start_tick <= tick)
+    {
+        const ScheduleFormat::Trip &trip{*pending_trips[next_trip++]};
+        Direction direction{schedule_index->get_direction(trip)};
+
+        Train *train{find_train(trip.train_id)};
+        if (train == nullptr)
+        {
+            std::cerr << "No matching train found for trip train id: " << trip.train_id << " in release trips\n";
+            continue;
+        }
+
+        // trips start in order, so appending keeps the stops of a train sorted by tick
+        TrainSchedule &train_schedule{train_schedules[train->get_slot() - train_slots.first]};
+        if (train_schedule.cursor == train_schedule.stops.size())
+        {
+            train_schedule.stops.clear();
+            train_schedule.cursor = 0;
+        }
+
+        train_schedule.runs.push_back(&trip);
+
+        std::span<const ScheduleFormat::Stop> stops{schedule_index->get_stops(trip)};
+        train_schedule.stops.reserve(train_schedule.stops.size() + 2 * stops.size());
+
+        for (const auto &stop : stops)
+        {
+            if (stop.arrival_tick != -1)
+            {
+                int arrival_tick{trip.start_tick + stop.arrival_tick};
+                train_schedule.stops.emplace_back(arrival_tick, trip.train_id, stop.station_id, direction, EventType::ARRIVAL);
+            }
+
+            if (stop.departure_tick != -1)
+            {
+                int departure_tick{trip.start_tick + stop.departure_tick};
+                Event departure{departure_tick, trip.train_id, stop.station_id, direction, EventType::DEPARTURE};
+
+                if (auto yard_it{yard_departures.find(stop.station_id)}; yard_it != yard_departures.end())
+                {
+                    yard_it->second.emplace(departure_tick, departure);
+                }
+                else
+                {
+                    train_schedule.stops.push_back(departure);
+                }
+            }
+        }
+    }
+}
+
 void Dispatch::handle_spawns(int tick)
 {
     for (Station *yard : yards)
     {
-        auto &departures{schedule[yard->get_id()].departures};
+        auto &departures{yard_departures[yard->get_id()]};
 
         auto it{departures.begin()};
         while (it != departures.end() && it->first <= tick)
@@ -377,7 +532,7 @@ bool Dispatch::spawn_train(int tick, const Event &event)
 {
     Station *station{stations[event.station_id]};
 
-    std::vector<Platform *> platforms{station->select_platforms(event.direction, train_line)};
+    std::span<Platform *const> platforms{topology->get_platforms(station, event.direction)};
     if (platforms.empty())
     {
         std::cerr << "No platform found at yard " << event.station_id << " for direction " << event.direction << "\n";
@@ -392,17 +547,12 @@ bool Dispatch::spawn_train(int tick, const Event &event)
     }
     Platform *platform{*platform_it};
 
-    Signal *signal{platform->get_signal()};
-    handle_signal_state(tick, signal);
-
-    auto train_it{std::ranges::find_if(trains, [&event](Train *t)
-                                       { return t->get_id() == event.train_id; })};
-    if (train_it == trains.end())
+    Train *train{find_train(event.train_id)};
+    if (train == nullptr)
     {
         std::cerr << "No matching train found for event train id: " << event.train_id << " in spawn train\n";
         return false;
     }
-    Train *train{*train_it};
 
     if (train->is_idle())
     {
@@ -412,8 +562,16 @@ bool Dispatch::spawn_train(int tick, const Event &event)
             return false;
         }
 
+        begin_run(train);
         logger->info(std::format("Train {} is leaving the yard {} (actual tick {}, planned tick {})", train->get_id(), station->get_name(), tick, event.tick));
-        handle_signal_state(tick, signal);
+        signal_propagator->on_occupancy_change(tick, platform);
+        activate(train);
+
+        if constexpr (Constants::EVENT_DRIVEN)
+        {
+            // dwell left from the last trip counts down from the spawn tick
+            schedule_wakeup(tick, tick, train);
+        }
 
         return true;
     }
@@ -423,14 +581,47 @@ bool Dispatch::spawn_train(int tick, const Event &event)
     }
 }
 
+void Dispatch::begin_run(Train *train)
+{
+    auto &runs{train_schedules[train->get_slot() - train_slots.first].runs};
+    if (runs.empty())
+    {
+        return;
+    }
+
+    const ScheduleFormat::Trip &trip{*runs.front()};
+    runs.pop_front();
+
+    // a train turning around at a yard runs the other way, under the headsign and stations of its next trip
+    std::span<const ScheduleFormat::Stop> stops{schedule_index->get_stops(trip)};
+    std::vector<const Station *> route{};
+    route.reserve(stops.size());
+    for (const auto &stop : stops.subspan(1))
+    {
+        if (auto station_it{stations.find(stop.station_id)}; station_it != stations.end())
+        {
+            route.push_back(station_it->second);
+        }
+    }
+
+    train->begin_run(schedule_index->get_direction(trip), schedule_index->get_headsign(trip), std::move(route));
+}
+
 void Dispatch::despawn_train(int tick, const Event &event, Train *train, const Station *yard)
 {
-    train->despawn();
+    // trains with runs left wait in the yard for their next trip
+    auto remaining_it{remaining_trips.find(train->get_id())};
+    bool in_service{remaining_it != remaining_trips.end() && --remaining_it->second > 0};
+
+    Track *yard_platform{train->get_current_track()};
+    train->despawn(in_service);
+    deactivate(train);
+    signal_propagator->on_occupancy_change(tick, yard_platform);
     logger->info(std::format("Train {} is arriving at yard {} (actual tick {}, planned tick {})", train->get_id(), yard->get_name(), tick, event.tick));
 
     if (train->is_out_of_service())
     {
-        finished_trains.insert(train);
+        ++finished_trains;
     }
 
     check_completion(tick);
@@ -438,7 +629,7 @@ void Dispatch::despawn_train(int tick, const Event &event, Train *train, const S
 
 void Dispatch::check_completion(int tick)
 {
-    if (finished_trains.size() == trains.size())
+    if (finished_trains == trains.size())
     {
         agency_control->inactivate(this);
     }
@@ -0,0 +1,127 @@
+/**
+ * for details on design, see:
+ * docs/core/line_topology.md
+ */
+
+#include "core/line_topology.h"
+#include "core/platform.h"
+#include "core/station.h"
+#include "core/track.h"
+
+LineTopology::LineTopology(TrainLine tl, std::span<Track *const> all_tracks, std::span<Station *const> stations) : train_line(tl)
+{
+    successors.offsets.reserve(all_tracks.size() + 1);
+    predecessors.offsets.reserve(all_tracks.size() + 1);
+
+    for (Track *track : all_tracks)
+    {
+        if (track->supports_train_line(train_line))
+        {
+            tracks.push_back(track);
+        }
+
+        // only the candidates are filtered, a track of another line may still lead onto this one
+        for (Track *next : track->get_next_tracks())
+        {
+            if (next->supports_train_line(train_line))
+            {
+                successors.targets.push_back(next);
+            }
+        }
+
+        for (Track *prev : track->get_prev_tracks())
+        {
+            if (prev->supports_train_line(train_line))
+            {
+                predecessors.targets.push_back(prev);
+            }
+        }
+
+        successors.offsets.push_back(static_cast<std::uint32_t>(successors.targets.size()));
+        predecessors.offsets.push_back(static_cast<std::uint32_t>(predecessors.targets.size()));
+    }
+
+    for (const Station *station : stations)
+    {
+        for (Platform *platform : station->get_platforms())
+        {
+            if (platform->supports_train_line(train_line))
+            {
+                platforms[platform_key(station->get_id(), platform->get_direction())].push_back(platform);
+            }
+        }
+    }
+}
+
+std::span<Track *const> LineTopology::Adjacency::of(const Track *track) const
+{
+    auto id{static_cast<std::size_t>(track->get_id())};
+    if (id + 1 >= offsets.size())
+    {
+        return {};
+    }
+    return std::span<Track *const>{targets}.subspan(offsets[id], offsets[id + 1] - offsets[id]);
+}
+
+std::int64_t LineTopology::platform_key(int station_id, const Direction &direction)
+{
+    auto code{std::visit([](const auto &d)
+                         { return static_cast<std::int64_t>(d); }, direction)};
+    return (static_cast<std::int64_t>(station_id) << 8) | code;
+}
+
+Track *LineTopology::select(std::span<Track *const> candidates)
+{
+    Track *fallback{nullptr};
+
+    for (Track *candidate : candidates)
+    {
+        if (!candidate->is_occupied())
+        {
+            return candidate;
+        }
+        fallback = candidate;
+    }
+
+    return fallback;
+}
+
+TrainLine LineTopology::get_train_line() const
+{
+    return train_line;
+}
+
+std::span<Track *const> LineTopology::get_tracks() const
+{
+    return tracks;
+}
+
+std::span<Track *const> LineTopology::get_next_tracks(const Track *track) const
+{
+    return successors.of(track);
+}
+
+std::span<Track *const> LineTopology::get_prev_tracks(const Track *track) const
+{
+    return predecessors.of(track);
+}
+
+Track *LineTopology::get_next_track(const Track *track) const
+{
+    return select(successors.of(track));
+}
+
+Track *LineTopology::get_prev_track(const Track *track) const
+{
+    return select(predecessors.of(track));
+}
+
+std::span<Platform *const> LineTopology::get_platforms(const Station *station, const Direction &direction) const
+{
+    auto it{platforms.find(platform_key(station->get_id(), direction))};
+    if (it == platforms.end())
+    {
+        return {};
+    }
+    return it->second;
+}
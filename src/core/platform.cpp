@@ -1,8 +1,8 @@
 #include "core/signal.h"
 #include "core/platform.h"
 
-Platform::Platform(int i, Signal *si, const Station *st, Direction dir, int dw, std::unordered_set<TrainLine> lines)
-    : Track(i, si, dw, lines), station(st), direction(dir) {}
+Platform::Platform(int i, Signal *si, const Station *st, Direction dir, int dw, std::unordered_set<TrainLine> lines, StateStore *ss)
+    : Track(i, si, dw, lines, ss), station(st), direction(dir) {}
 
 const Station *Platform::get_station() const
 {
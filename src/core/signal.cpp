@@ -1,6 +1,14 @@
 #include "core/signal.h"
 
-Signal::Signal(int i) : id(i), track(nullptr), state(SignalState::RED), functional(true), failure_timer(0) {}
+Signal::Signal(int i, StateStore *st) : id(i), track(nullptr), state(st)
+{
+    if (state == nullptr)
+    {
+        own_state = std::make_unique<StateStore>();
+        state = own_state.get();
+    }
+    slot = state->add_signal();
+}
 
 int Signal::get_id() const
 {
@@ -21,52 +29,44 @@ void Signal::set_failure(int failure)
 {
     if (failure > 0)
     {
-        failure_timer = failure;
-        functional = false;
+        state->failure_timer[slot] = failure;
     }
 }
 
-void Signal::update_repair()
+void Signal::repair()
 {
-    if (failure_timer > 0)
-    {
-        --failure_timer;
-
-        if (failure_timer == 0)
-        {
-            functional = true;
-        }
-    }
+    state->failure_timer[slot] = 0;
 }
 
 bool Signal::is_red() const
 {
-    return state == SignalState::RED;
+    return state->aspect[slot] == SignalState::RED;
 }
 
 bool Signal::is_yellow() const
 {
-    return state == SignalState::YELLOW;
+    return state->aspect[slot] == SignalState::YELLOW;
 }
 
 bool Signal::is_green() const
 {
-    return state == SignalState::GREEN;
+    return state->aspect[slot] == SignalState::GREEN;
 }
 
 bool Signal::is_functional() const
 {
-    return functional;
+    return state->failure_timer[slot] == 0;
 }
 
 SignalState Signal::get_state() const
 {
-    return state;
+    return state->aspect[slot];
 }
 
 bool Signal::change_state(SignalState new_state)
 {
-    bool changed{state != new_state};
-    state = new_state;
+    SignalState &aspect{state->aspect[slot]};
+    bool changed{aspect != new_state};
+    aspect = new_state;
     return changed;
 }
@@ -0,0 +1,96 @@
+/**
+ * for details on design, see:
+ * docs/core/signal_propagator.md
+ */
+
+#include <format>
+
+#include "core/signal.h"
+#include "core/signal_propagator.h"
+#include "core/track.h"
+
+SignalPropagator::SignalPropagator(std::span<Track *const> tracks, std::span<const LineTopology *const> topologies, Logger *log)
+    : track_lines(tracks.size()), logger(log)
+{
+    for (const LineTopology *topology : topologies)
+    {
+        for (const Track *track : topology->get_tracks())
+        {
+            track_lines[track->get_id()].push_back(topology);
+        }
+    }
+}
+
+SignalState SignalPropagator::aspect_of(const Track *track) const
+{
+    if (track->is_occupied())
+    {
+        return SignalState::RED;
+    }
+
+    // a block served by several lines shows the most restrictive aspect of any of them
+    for (const LineTopology *topology : track_lines[track->get_id()])
+    {
+        const Track *next{topology->get_next_track(track)};
+        if (next == nullptr)
+        {
+            continue;
+        }
+
+        const Track *next_next{topology->get_next_track(next)};
+        if (next->is_occupied() || (next_next != nullptr && next_next->is_occupied()))
+        {
+            return SignalState::YELLOW;
+        }
+    }
+
+    return SignalState::GREEN;
+}
+
+void SignalPropagator::update(int tick, Track *track)
+{
+    Signal *signal{track->get_signal()};
+    if (signal == nullptr)
+    {
+        return;
+    }
+
+    if (signal->change_state(aspect_of(track)))
+    {
+        logger->info(std::format("Signal {} changed state to {} at tick {}", signal->get_id(), signal_state_to_string(signal->get_state()), tick));
+    }
+}
+
+void SignalPropagator::update_behind(int tick, const Track *track, int depth)
+{
+    if (depth == 0)
+    {
+        return;
+    }
+
+    for (const LineTopology *topology : track_lines[track->get_id()])
+    {
+        for (Track *prev : topology->get_prev_tracks(track))
+        {
+            update(tick, prev);
+            update_behind(tick, prev, depth - 1);
+        }
+    }
+}
+
+void SignalPropagator::initialize(std::span<Track *const> tracks)
+{
+    for (Track *track : tracks)
+    {
+        if (Signal *signal{track->get_signal()}; signal != nullptr)
+        {
+            signal->change_state(aspect_of(track));
+        }
+    }
+}
+
+void SignalPropagator::on_occupancy_change(int tick, Track *track)
+{
+    update(tick, track);
+    update_behind(tick, track, LOOKAHEAD);
+}
@@ -0,0 +1,40 @@
+/**
+ * for details on design, see:
+ * docs/core/state_store.md
+ */
+
+#include "core/state_store.h"
+
+std::size_t StateStore::add_track()
+{
+    occupied.push_back(0);
+    occupant.push_back(nullptr);
+    return occupied.size() - 1;
+}
+
+std::size_t StateStore::add_signal()
+{
+    aspect.push_back(SignalState::RED);
+    failure_timer.push_back(0);
+    return aspect.size() - 1;
+}
+
+std::size_t StateStore::add_train()
+{
+    dwell_timer.push_back(0);
+    status.push_back(TrainStatus::IDLE);
+    ready.push_back(0);
+    return status.size() - 1;
+}
+
+void StateStore::count_down_dwell(std::size_t first, std::size_t last)
+{
+    for (std::size_t i{first}; i < last; ++i)
+    {
+        bool active{status[i] != TrainStatus::IDLE && status[i] != TrainStatus::OUTOFSERVICE};
+        bool dwelling{active && dwell_timer[i] > 0};
+
+        ready[i] = static_cast<std::uint8_t>(active && !dwelling);
+        dwell_timer[i] -= static_cast<int>(dwelling);
+    }
+}
@@ -56,17 +56,10 @@ void Switch::set_failure(int failure)
     }
 }
 
-void Switch::update_repair()
+void Switch::repair()
 {
-    if (failure_timer > 0)
-    {
-        --failure_timer;
-    }
-
-    if (failure_timer == 0)
-    {
-        functional = true;
-    }
+    failure_timer = 0;
+    functional = true;
 }
 
 bool Switch::is_functional() const
@@ -0,0 +1,224 @@
+/**
+ * for details on design, see:
+ * docs/core/timing_wheel.md
+ */
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "core/timing_wheel.h"
+
+TimingWheel::TimingWheel(int start_tick) : current_tick(start_tick) {}
+
+TimingWheel::Slot &TimingWheel::slot_of(const Timer &timer)
+{
+    auto expire{static_cast<std::uint32_t>(timer.expire_tick)};
+    return slots[timer.level][(expire >> (timer.level * SLOT_BITS)) & (SLOTS - 1)];
+}
+
+void TimingWheel::link(std::uint32_t index)
+{
+    Timer &timer{timers[index]};
+
+    // the level is picked by the highest bit the expiry does not share with the current tick, so a timer is
+    // cascaded down exactly when the wheel reaches the slot it waits in
+    auto differing{static_cast<std::uint32_t>(timer.expire_tick) ^ static_cast<std::uint32_t>(current_tick)};
+    timer.level = static_cast<std::uint8_t>(differing == 0 ? 0 : (std::bit_width(differing) - 1) / SLOT_BITS);
+
+    Slot &slot{slot_of(timer)};
+    timer.prev = slot.tail;
+    timer.next = NONE;
+    if (slot.tail != NONE)
+    {
+        timers[slot.tail].next = index;
+    }
+    else
+    {
+        slot.head = index;
+    }
+    slot.tail = index;
+}
+
+void TimingWheel::unlink(std::uint32_t index)
+{
+    Timer &timer{timers[index]};
+    Slot &slot{slot_of(timer)};
+
+    if (timer.prev != NONE)
+    {
+        timers[timer.prev].next = timer.next;
+    }
+    else
+    {
+        slot.head = timer.next;
+    }
+
+    if (timer.next != NONE)
+    {
+        timers[timer.next].prev = timer.prev;
+    }
+    else
+    {
+        slot.tail = timer.prev;
+    }
+}
+
+void TimingWheel::release(std::uint32_t index)
+{
+    Timer &timer{timers[index]};
+    timer.callback = nullptr;
+    timer.state = TimerState::FREE;
+    ++timer.generation;
+
+    free_timers.push_back(index);
+    --count;
+}
+
+void TimingWheel::cascade(int tick)
+{
+    auto bits{static_cast<std::uint32_t>(tick)};
+
+    // every level whose lower levels just wrapped around, highest first so its timers can fall through
+    int top{0};
+    while (top + 1 < LEVELS && (bits & ((1u << ((top + 1) * SLOT_BITS)) - 1)) == 0)
+    {
+        ++top;
+    }
+
+    for (int level{top}; level > 0; --level)
+    {
+        std::uint32_t index{std::exchange(slots[level][(bits >> (level * SLOT_BITS)) & (SLOTS - 1)], Slot{}).head};
+        while (index != NONE)
+        {
+            std::uint32_t next{timers[index].next};
+            link(index);
+            index = next;
+        }
+    }
+}
+
+TimingWheel::Handle TimingWheel::schedule(int expire_tick, Callback callback)
+{
+    std::uint32_t index{};
+    if (!free_timers.empty())
+    {
+        index = free_timers.back();
+        free_timers.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(timers.size());
+        timers.emplace_back();
+    }
+
+    Timer &timer{timers[index]};
+    timer.expire_tick = std::max(expire_tick, current_tick + 1);
+    timer.callback = std::move(callback);
+    timer.state = TimerState::SCHEDULED;
+
+    link(index);
+    ++count;
+
+    return {index, timer.generation};
+}
+
+bool TimingWheel::cancel(Handle handle)
+{
+    if (handle.index >= timers.size() || timers[handle.index].generation != handle.generation)
+    {
+        return false;
+    }
+
+    Timer &timer{timers[handle.index]};
+    switch (timer.state)
+    {
+    case TimerState::SCHEDULED:
+        unlink(handle.index);
+        release(handle.index);
+        return true;
+    case TimerState::EXPIRING:
+        // already taken out of its slot by advance, which releases it without calling it
+        timer.callback = nullptr;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void TimingWheel::advance(int tick)
+{
+    while (current_tick < tick)
+    {
+        if (count == 0)
+        {
+            current_tick = tick;
+            break;
+        }
+
+        ++current_tick;
+        cascade(current_tick);
+
+        expired.clear();
+        std::uint32_t index{std::exchange(slots[0][static_cast<std::uint32_t>(current_tick) & (SLOTS - 1)], Slot{}).head};
+        while (index != NONE)
+        {
+            timers[index].state = TimerState::EXPIRING;
+            expired.push_back(index);
+            index = timers[index].next;
+        }
+
+        for (std::uint32_t expiring : expired)
+        {
+            Callback callback{std::move(timers[expiring].callback)};
+            release(expiring);
+            if (callback)
+            {
+                callback(current_tick);
+            }
+        }
+    }
+}
+
+std::optional<int> TimingWheel::next_expiry() const
+{
+    if (count == 0)
+    {
+        return std::nullopt;
+    }
+
+    auto bits{static_cast<std::uint32_t>(current_tick)};
+
+    // a level only holds timers in slots after the one of the current tick, lower levels expire first
+    for (int level{0}; level < LEVELS; ++level)
+    {
+        std::size_t current_slot{(bits >> (level * SLOT_BITS)) & (SLOTS - 1)};
+        for (std::size_t slot{current_slot + 1}; slot < SLOTS; ++slot)
+        {
+            std::uint32_t index{slots[level][slot].head};
+            if (index == NONE)
+            {
+                continue;
+            }
+
+            int earliest{timers[index].expire_tick};
+            for (; index != NONE; index = timers[index].next)
+            {
+                earliest = std::min(earliest, timers[index].expire_tick);
+            }
+            return earliest;
+        }
+    }
+
+    return std::nullopt;
+}
+
+int TimingWheel::get_tick() const
+{
+    return current_tick;
+}
+
+std::size_t TimingWheel::size() const
+{
+    return count;
+}
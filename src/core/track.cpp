@@ -4,8 +4,16 @@
 #include "core/signal.h"
 #include "core/track.h"
 
-Track::Track(int i, Signal *s, int d, std::unordered_set<TrainLine> lines)
-    : id(i), duration(std::max(1, d)), occupied(false), signal(s), current_train(nullptr), train_lines(std::move(lines)), outbound_switch(nullptr), inbound_switch(nullptr) {}
+Track::Track(int i, Signal *s, int d, std::unordered_set<TrainLine> lines, StateStore *st)
+    : id(i), duration(std::max(1, d)), signal(s), train_lines(std::move(lines)), outbound_switch(nullptr), inbound_switch(nullptr), state(st)
+{
+    if (state == nullptr)
+    {
+        own_state = std::make_unique<StateStore>();
+        state = own_state.get();
+    }
+    slot = state->add_track();
+}
 
 int Track::get_id() const
 {
@@ -31,7 +39,7 @@ Signal *Track::get_signal() const
 
 const Train *Track::get_occupying_train() const
 {
-    return current_train;
+    return state->occupant[slot];
 }
 
 const std::vector<Track *> &Track::get_next_tracks() const
@@ -56,7 +64,7 @@ Switch *Track::get_inbound_switch() const
 
 bool Track::is_occupied() const
 {
-    return occupied;
+    return state->occupied[slot] != 0;
 }
 
 bool Track::supports_train_line(TrainLine line) const
@@ -121,20 +129,20 @@ bool Track::accept_entry(Train *train)
         return false;
     }
 
-    if (occupied || signal->is_red())
+    if (is_occupied() || signal->is_red())
     {
         return false;
     }
 
-    occupied = true;
-    current_train = train;
+    state->occupied[slot] = 1;
+    state->occupant[slot] = train;
     return true;
 }
 
 void Track::release_train()
 {
-    current_train = nullptr;
-    occupied = false;
+    state->occupant[slot] = nullptr;
+    state->occupied[slot] = 0;
 }
 
 void Track::add_train_line(TrainLine line)
@@ -1,23 +1,40 @@
 #include "core/train.h"
 
-Train::Train(int i, const std::string& h, TrainLine l, ServiceType t, Direction d, std::vector<const Station *> r)
-    : id(i), dwell_timer(0), punctuality_delta(0), headsign(h), train_line(l), service_type(t),
-      status(TrainStatus::IDLE), direction(d), current_track(nullptr) 
+Train::Train(TrainId i, const std::string& h, TrainLine l, ServiceType t, Direction d, std::vector<const Station *> r, StateStore *st)
+    : id(i), punctuality_delta(0), headsign(h), train_line(l), service_type(t),
+      direction(d), current_track(nullptr), state(st)
       {
         for (const Station* station : r)
         {
             route.push(station);
         }
+
+        if (state == nullptr)
+        {
+            own_state = std::make_unique<StateStore>();
+            state = own_state.get();
+        }
+        slot = state->add_train();
       }
 
-int Train::get_id() const
+TrainId Train::get_id() const
 {
     return id;
 }
 
+StateStore *Train::get_state_store() const
+{
+    return state;
+}
+
+std::size_t Train::get_slot() const
+{
+    return slot;
+}
+
 int Train::get_dwell() const
 {
-    return dwell_timer;
+    return state->dwell_timer[slot];
 }
 
 int Train::get_lateness() const
@@ -42,7 +59,7 @@ ServiceType Train::get_service_type() const
 
 TrainStatus Train::get_status() const
 {
-    return status;
+    return state->status[slot];
 }
 
 Direction Train::get_direction() const
@@ -76,33 +93,34 @@ void Train::add_dwell(int additional_dwell)
 {
     if (additional_dwell > 0)
     {
-        dwell_timer += additional_dwell;
+        state->dwell_timer[slot] += additional_dwell;
     }
 }
 
 bool Train::is_idle() const
 {
-    return status == TrainStatus::IDLE;
+    return get_status() == TrainStatus::IDLE;
 }
 
 bool Train::is_active() const
 {
+    TrainStatus status{get_status()};
     return status != TrainStatus::IDLE && status != TrainStatus::OUTOFSERVICE;
 }
 
 bool Train::is_arriving() const
 {
-    return status == TrainStatus::ARRIVING;
+    return get_status() == TrainStatus::ARRIVING;
 }
 
 bool Train::is_departing() const
 {
-    return status == TrainStatus::DEPARTING;
+    return get_status() == TrainStatus::DEPARTING;
 }
 
 bool Train::is_out_of_service() const
 {
-    return status == TrainStatus::OUTOFSERVICE;
+    return get_status() == TrainStatus::OUTOFSERVICE;
 }
 
 bool Train::is_late() const
@@ -110,17 +128,9 @@ bool Train::is_late() const
     return punctuality_delta > 0;
 }
 
-bool Train::request_movement()
+bool Train::is_ready() const
 {
-    if (dwell_timer <= 0)
-    {
-        return true;
-    }
-    else
-    {
-        --dwell_timer;
-        return false;
-    }
+    return state->ready[slot] != 0;
 }
 
 bool Train::move_to_track(Track *to)
@@ -145,6 +155,7 @@ bool Train::move_to_track(Track *to)
 
     current_track = to;
 
+    TrainStatus &status{state->status[slot]};
     if (to->is_platform())
     {
         status = TrainStatus::ARRIVING;
@@ -159,25 +170,32 @@ bool Train::move_to_track(Track *to)
         status = TrainStatus::MOVING;
     }
 
-    dwell_timer = to->get_duration() - 1;
+    state->dwell_timer[slot] = to->get_duration() - 1;
     return true;
 }
 
+void Train::begin_run(Direction d, std::string_view h, std::vector<const Station *> r)
+{
+    direction = d;
+    headsign = h;
+    route = std::queue<const Station *>{std::deque<const Station *>(r.begin(), r.end())};
+}
+
 bool Train::spawn(Platform *yard_platform)
 {
     bool spawned{yard_platform->accept_entry(this)};
     if (spawned)
     {
         current_track = yard_platform;
-        status = TrainStatus::READY;
+        state->status[slot] = TrainStatus::READY;
     }
 
     return spawned;
 }
 
-void Train::despawn()
+void Train::despawn(bool in_service)
 {
     current_track->release_train();
     current_track = nullptr;
-    status = TrainStatus::OUTOFSERVICE;
+    state->status[slot] = in_service ? TrainStatus::IDLE : TrainStatus::OUTOFSERVICE;
 }
\ No newline at end of file
@@ -1,10 +1,15 @@
+#include <algorithm>
+#include <chrono>
 #include <vector>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <thread>
-#include <atomic>
-#include <condition_variable>
-#include <mutex>
 #include <iostream>
+#include <type_traits>
+#include <variant>
 
 #include "config.h"
 
@@ -14,8 +19,66 @@
 #include "system/scheduler.h"
 #include "system/central_logger.h"
 #include "core/agency_control.h"
+#include "utils/task_executor.h"
+#include "utils/utils.h"
 
-int main()
+namespace
+{
+    /**
+     * applies --fleet <train line>=<trains> options to the registry before anything is scheduled, train lines
+     * are named as in the transit data, e.g. "4", "Harlem" or "Babylon Branch"
+     * @return false if an option is unknown or its fleet size cannot be set
+     */
+    bool apply_options(int argc, char *argv[], Registry &registry)
+    {
+        for (int i{1}; i < argc; ++i)
+        {
+            std::string_view option{argv[i]};
+            if (option != "--fleet" || i + 1 >= argc)
+            {
+                std::cerr << "[ERROR] Unknown option " << option << ", usage: app [--fleet <train line>=<trains>]...\n";
+                return false;
+            }
+
+            std::string_view setting{argv[++i]};
+            std::size_t separator{setting.rfind('=')};
+            if (separator == std::string_view::npos)
+            {
+                std::cerr << "[ERROR] Expected <train line>=<trains> after --fleet, got " << setting << "\n";
+                return false;
+            }
+
+            TrainLine train_line{trainline_from_string(std::string(setting.substr(0, separator)))};
+            std::optional<Constants::System> system_code{std::visit([](const auto &line) -> std::optional<Constants::System>
+                                                                    {
+                using T = std::decay_t<decltype(line)>;
+                if constexpr (std::is_same_v<T, SUB::TrainLine>) return Constants::System::SUBWAY;
+                else if constexpr (std::is_same_v<T, MNR::TrainLine>) return Constants::System::METRO_NORTH;
+                else if constexpr (std::is_same_v<T, LIRR::TrainLine>) return Constants::System::LIRR;
+                else return std::nullopt; }, train_line)};
+
+            if (!system_code.has_value())
+            {
+                std::cerr << "[ERROR] Unknown train line " << setting.substr(0, separator) << " in --fleet\n";
+                return false;
+            }
+
+            try
+            {
+                registry.set_fleet_size(*system_code, train_line, Utils::string_view_to_numeric<int>(setting.substr(separator + 1)));
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "[ERROR] Cannot apply --fleet " << setting << ": " << e.what() << "\n";
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char *argv[])
 {
     std::filesystem::create_directories(LOG_DIRECTORY);
     std::filesystem::create_directories(DATA_DIRECTORY);
@@ -26,90 +89,130 @@ int main()
     Transit::Map::LongIslandRailroad &lirr{Transit::Map::LongIslandRailroad::get_instance()};
 
     Registry &registry{Registry::get_instance()};
+    if (!apply_options(argc, argv, registry))
+    {
+        return 1;
+    }
+
     Scheduler scheduler{};
     CentralLogger &central_logger{CentralLogger::get_instance()};
 
-    std::atomic<int> global_tick{0};
-    std::mutex tick_mutex{};
-    std::condition_variable tick_cv{};
     const int max_tick{500};
 
-    std::atomic<int> ready_threads{0};
-    const int total_threads{Constants::SYSTEMS.size()};
+    std::size_t worker_count{Constants::WORKER_THREADS > 0 ? static_cast<std::size_t>(Constants::WORKER_THREADS) : std::max(1u, std::thread::hardware_concurrency())};
+    Utils::TaskExecutor executor{worker_count};
 
-    std::vector<std::thread> threads{};
-    for (const auto &[system_name, system_code] : Constants::SYSTEMS)
+    // systems are scheduled one after another with their lines side by side on the executor, then built side by
+    // side, a system that fails to schedule or build is left out of the simulation
+    std::vector<const Transit::Map::Graph *> graphs(Constants::SYSTEMS.size(), nullptr);
+    for (std::size_t i{0}; i < Constants::SYSTEMS.size(); ++i)
     {
-        threads.emplace_back([&, system_name, system_code]()
-                             {
-        try
+        const auto &[system_name, system_code] = Constants::SYSTEMS[i];
+        const Transit::Map::Graph *graph{nullptr};
+        switch (system_code)
         {
-            const Transit::Map::Graph *graph{nullptr};
-            switch (system_code)
-            {
-            case Constants::System::SUBWAY: graph = &subway; break;
-            case Constants::System::METRO_NORTH: graph = &mnr; break;
-            case Constants::System::LIRR: graph = &lirr; break;
-            }
+        case Constants::System::SUBWAY: graph = &subway; break;
+        case Constants::System::METRO_NORTH: graph = &mnr; break;
+        case Constants::System::LIRR: graph = &lirr; break;
+        }
 
-            if (graph != nullptr)
-            {
-                scheduler.write_schedule(*graph, registry, system_name, system_code);
-                AgencyControl agency{system_code, system_name, *graph, registry, central_logger};
+        if (graph == nullptr)
+        {
+            continue;
+        }
 
-                while (true)
-                {
-                    int tick{};
-                    {
-                        std::unique_lock lock(tick_mutex);
-                        tick = global_tick.load();
-                    }
-                
-                    agency.run(tick);
-                
-                    {
-                        std::unique_lock lock(tick_mutex);
-                        if (ready_threads.fetch_add(1) + 1 == total_threads)
-                        {
-                            ready_threads.store(0);
-                            ++global_tick;
-                            tick_cv.notify_all();
-                        }
-                        else
-                        {
-                            tick_cv.wait(lock, [&]{ return tick != global_tick.load(); });
-                            if (global_tick.load() >= max_tick)
-                            {
-                                break;
-                            }
-                        }
-
-                    }
-                }
-            }
+        try
+        {
+            scheduler.write_schedule(*graph, registry, system_name, system_code, &executor);
+            graphs[i] = graph;
         }
         catch (const std::exception &e)
         {
             std::cerr << "[ERROR] Simulation failed for system " << system_name << ": " << e.what() << "\n";
-        } });
+        }
     }
 
-    while (global_tick.load() < max_tick)
+    std::vector<std::unique_ptr<AgencyControl>> agencies(Constants::SYSTEMS.size());
+    Utils::TaskGraph setup{};
+    for (std::size_t i{0}; i < Constants::SYSTEMS.size(); ++i)
     {
-        central_logger.process();
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (graphs[i] == nullptr)
+        {
+            continue;
+        }
+
+        setup.add([&, i]()
+                  {
+            const auto &[system_name, system_code] = Constants::SYSTEMS[i];
+            try
+            {
+                agencies[i] = std::make_unique<AgencyControl>(system_code, system_name, *graphs[i], registry, central_logger);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "[ERROR] Simulation failed for system " << system_name << ": " << e.what() << "\n";
+            } });
     }
+    executor.run(setup);
 
+    // every tick the lines of all systems are authorized as separate tasks, each system prepares its lines
+    // before and resolves switches and moves trains after, systems do not wait for each other within a tick
+    int tick{0};
+    Utils::TaskGraph tick_graph{};
+    for (const auto &agency : agencies)
     {
-        std::unique_lock lock(tick_mutex);
-        tick_cv.notify_all();
+        if (agency == nullptr)
+        {
+            continue;
+        }
+
+        AgencyControl *ac{agency.get()};
+        std::size_t prepare{tick_graph.add([ac, &tick]
+                                           { ac->prepare_tick(tick); })};
+        std::size_t finish{tick_graph.add([ac, &tick]
+                                          { ac->finish_tick(tick); })};
+        tick_graph.precede(prepare, finish);
+
+        for (std::size_t line{0}; line < ac->get_line_count(); ++line)
+        {
+            std::size_t authorize{tick_graph.add([ac, line, &tick]
+                                                 { ac->authorize_line(line, tick); })};
+            tick_graph.precede(prepare, authorize);
+            tick_graph.precede(authorize, finish);
+        }
     }
 
+    auto last_report{std::chrono::steady_clock::now()};
+    try
+    {
+        while (tick < max_tick)
+        {
+            executor.run(tick_graph);
 
-    for (auto &t : threads)
+            // ticks no system has work at are skipped
+            int next_tick{max_tick};
+            for (const auto &agency : agencies)
+            {
+                if (agency != nullptr)
+                {
+                    next_tick = std::min(next_tick, agency->next_event_tick());
+                }
+            }
+            tick = next_tick;
+
+            if (std::chrono::steady_clock::now() - last_report >= std::chrono::milliseconds(50))
+            {
+                central_logger.process();
+                last_report = std::chrono::steady_clock::now();
+            }
+        }
+    }
+    catch (const std::exception &e)
     {
-        t.join();
+        std::cerr << "[ERROR] Simulation failed at tick " << tick << ": " << e.what() << "\n";
     }
 
+    central_logger.process();
+
     return 0;
 }
\ No newline at end of file
@@ -4,9 +4,12 @@
  */
 
 #include <queue>
+#include <iostream>
 
 #include "config.h"
 #include "utils/utils.h"
+#include "utils/string_pool.h"
+#include "utils/columnar_table.h"
 #include "constants/railroad_constants.h"
 #include "map/metro_north.h"
 
@@ -14,75 +17,77 @@ using namespace Transit::Map;
 
 MetroNorth::MetroNorth()
 {
-    load_stations(std::string(DATA_DIRECTORY) + "/clean/mnr/stations.csv");
-    load_connections(std::string(DATA_DIRECTORY) + "/clean/mnr/routes.csv");
+    load_stations(std::string(DATA_DIRECTORY) + "/clean/mnr/stations.bin");
+    load_connections(std::string(DATA_DIRECTORY) + "/clean/mnr/routes.bin");
 }
 
-void MetroNorth::load_stations(const std::string &csv)
+void MetroNorth::load_stations(const std::string &file_path)
 {
-    const std::vector<std::string_view> needed_columns{
-        "stop_id",
-        "stop_code",
-        "stop_name",
-        "latitude",
-        "longitude"};
-
-    Utils::open_and_parse(csv, needed_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
-                          {
-        auto tokens {Utils::split(line, ',')};
-        if (tokens.size() < column_index.size())
-        {
-            Utils::log_malformed_line("metro north", "load stations", line_num, line);
-            return;
-        }
+    using ColumnarFormat::Type;
+
+    try
+    {
+        Utils::ColumnarTable table{file_path};
 
-        const auto row {Utils::from_tokens(tokens, column_index)};
+        auto stop_ids{table.int32s(table.column("stop_id", Type::INT32))};
+        std::size_t stop_code_column{table.column("stop_code", Type::STRING)};
+        std::size_t stop_name_column{table.column("stop_name", Type::STRING)};
+        auto latitudes{table.float64s(table.column("latitude", Type::FLOAT64))};
+        auto longitudes{table.float64s(table.column("longitude", Type::FLOAT64))};
 
-        int stop_id {Utils::string_view_to_numeric<int>(row.at("stop_id"))};
-        std::string stop_code {row.at("stop_code")};
-        std::string stop_name {row.at("stop_name")};
-        double latitude {Utils::string_view_to_numeric<double>(row.at("latitude"))};
-        double longitude {Utils::string_view_to_numeric<double>(row.at("longitude"))};
+        for (std::size_t row{0}; row < table.row_count(); ++row)
+        {
+            std::string stop_code{table.string(stop_code_column, row)};
+            std::string stop_name{table.string(stop_name_column, row)};
 
-        // will add train lines in load_connections()
-        add_node(stop_id, stop_name, {}, {stop_code}, latitude, longitude); });
+            // will add train lines in load_connections()
+            add_node(stop_ids[row], stop_name, {}, {stop_code}, latitudes[row], longitudes[row]);
+        }
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Failed to load metro north stations from " << file_path << ": " << e.what() << "\n";
+    }
 }
 
-void MetroNorth::load_connections(const std::string &csv)
+void MetroNorth::load_connections(const std::string &file_path)
 {
-    const std::vector<std::string_view> needed_columns{
-        "route_id",
-        "ordered_stops"};
-
-    std::unordered_map<std::string_view, std::vector<std::vector<int>>> route_segments{};
-
-    Utils::open_and_parse(csv, needed_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
-                          {
+    using ColumnarFormat::Type;
 
-        auto tokens {Utils::split(line, ',')};
-        if (tokens.size() < column_index.size())
-        {
-            Utils::log_malformed_line("metro north", "load connections", line_num, line);
-            return;
-        }
-
-        const auto row {Utils::from_tokens(tokens, column_index)};
+    // route names are interned so segments of the same route are grouped by a dense index
+    Utils::StringPool route_names{};
+    std::vector<std::vector<std::vector<int>>> route_segments{}; // indexed by interned route name
 
-        std::string_view route_sv {row.at("route_id")};
-        std::string_view ordered_stops_sv{row.at("ordered_stops")};
+    try
+    {
+        Utils::ColumnarTable table{file_path};
 
-        auto stop_tokens {Utils::split(ordered_stops_sv, ' ')};
+        std::size_t route_column{table.column("route_id", Type::STRING)};
+        std::size_t ordered_stops_column{table.column("ordered_stops", Type::INT32_LIST)};
 
-        std::vector<int> stop_ids{};
-        stop_ids.reserve(stop_tokens.size());
-        for (const auto &stop_sv : stop_tokens)
+        for (std::size_t row{0}; row < table.row_count(); ++row)
         {
-            stop_ids.push_back(Utils::string_view_to_numeric<int>(stop_sv));
+            auto stop_ids{table.int32_list(ordered_stops_column, row)};
+
+            std::uint32_t route_index{route_names.intern(table.string(route_column, row))};
+            if (route_index == route_segments.size())
+            {
+                route_segments.emplace_back();
+            }
+            route_segments[route_index].emplace_back(stop_ids.begin(), stop_ids.end());
         }
-        route_segments[route_sv].push_back(std::move(stop_ids)); });
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Failed to load metro north connections from " << file_path << ": " << e.what() << "\n";
+        return;
+    }
 
-    for (const auto &[route_sv, segments] : route_segments)
+    for (std::uint32_t route_index{0}; route_index < route_segments.size(); ++route_index)
     {
+        std::string_view route_sv{route_names.view(route_index)};
+        const auto &segments{route_segments[route_index]};
+
         std::string route_str{std::string(route_sv)};
         if (route_sv == "Harlem" || route_sv == "Hudson" || route_sv == "New Haven")
         {
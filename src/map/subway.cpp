@@ -3,7 +3,7 @@
  * docs/map/subway.md
  */
 
-#include <fstream>
+#include <iostream>
 #include <string_view>
 #include <unordered_set>
 #include <ranges>
@@ -11,6 +11,7 @@
 
 #include "map/subway.h"
 #include "utils/utils.h"
+#include "utils/columnar_table.h"
 #include "enum/transit_types.h"
 #include "config.h"
 
@@ -18,132 +19,138 @@ using namespace Transit::Map;
 
 Subway::Subway()
 {
-    load_stations(std::string(DATA_DIRECTORY) + "/clean/subway/stations.csv");
-    load_connections(std::string(DATA_DIRECTORY) + "/clean/subway/routes.csv");
+    load_stations(std::string(DATA_DIRECTORY) + "/clean/subway/stations.bin");
+    load_connections(std::string(DATA_DIRECTORY) + "/clean/subway/routes.bin");
 }
 
-void Subway::load_stations(const std::string &csv)
+void Subway::load_stations(const std::string &file_path)
 {
-    const std::vector<std::string_view> needed_columns{
-        "complex_id",
-        "gtfs_id",
-        "stop_name",
-        "train_lines",
-        "latitude",
-        "longitude"};
-
-    Utils::open_and_parse(csv, needed_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
-                          {              
-        auto tokens {Utils::split(line, ',')};
-        if (tokens.size() < column_index.size())
-        {
-            Utils::log_malformed_line("subway", "load stations", line_num, line);
-            return;
-        }
+    using ColumnarFormat::Type;
 
-        const auto row {Utils::from_tokens(tokens, column_index)};
+    try
+    {
+        Utils::ColumnarTable table{file_path};
 
-        int complex_id {Utils::string_view_to_numeric<int>(row.at("complex_id"))};
-        std::string gtfs {row.at("gtfs_id")};
-        std::string stop_name {row.at("stop_name")};
-        std::string_view train_lines_sv {row.at("train_lines")};
-        double latitude {Utils::string_view_to_numeric<double>(row.at("latitude"))};
-        double longitude {Utils::string_view_to_numeric<double>(row.at("longitude"))};
+        auto complex_ids{table.int32s(table.column("complex_id", Type::INT32))};
+        std::size_t gtfs_column{table.column("gtfs_id", Type::STRING)};
+        std::size_t stop_name_column{table.column("stop_name", Type::STRING)};
+        std::size_t train_lines_column{table.column("train_lines", Type::STRING_LIST)};
+        auto latitudes{table.float64s(table.column("latitude", Type::FLOAT64))};
+        auto longitudes{table.float64s(table.column("longitude", Type::FLOAT64))};
 
-        auto train_line_tokens {Utils::split(train_lines_sv, ' ')};
-        std::unordered_set<TrainLine> train_lines{};
-        train_lines.reserve(train_line_tokens.size());
+        gtfs_ids.reserve(table.row_count());
+        gtfs_to_id.reserve(table.row_count());
 
-        for (const auto &token : train_line_tokens)
+        for (std::size_t row{0}; row < table.row_count(); ++row)
         {
-            train_lines.insert(trainline_from_string(std::string(token)));
-        }
+            int complex_id{complex_ids[row]};
+            std::string gtfs{table.string(gtfs_column, row)};
+            std::string stop_name{table.string(stop_name_column, row)};
 
-        try
-        {
-            add_node(complex_id, stop_name, train_lines, {gtfs}, latitude, longitude);
-        }
-        catch (const std::invalid_argument &e)
-        {
-            update_node(complex_id, train_lines, {gtfs});
-        }
-
-        gtfs_to_id[gtfs] = complex_id; });
-}
+            auto train_line_refs{table.string_list(train_lines_column, row)};
+            std::unordered_set<TrainLine> train_lines{};
+            train_lines.reserve(train_line_refs.size());
 
-void Subway::load_connections(const std::string &csv)
-{
-    const std::vector<std::string_view> needed_columns{
-        "route_id",
-        "headsign",
-        "ordered_stops"};
-
-    Utils::open_and_parse(csv, needed_columns, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
-                          {                          
-        auto tokens {Utils::split(line, ',')};
-        if (tokens.size() < column_index.size())
-        {
-            Utils::log_malformed_line("subway", "load connections", line_num, line);
-            return;
-        }
-
-        const auto row {Utils::from_tokens(tokens, column_index)};
-
-        std::string route_str {row.at("route_id")};
-        std::string headsign {row.at("headsign")};
-        std::string ordered_stops {row.at("ordered_stops")};
-
-        TrainLine route {trainline_from_string(std::string(route_str))};
-
-        auto stop_ids {Utils::split(ordered_stops, ' ')};
+            for (const auto &ref : train_line_refs)
+            {
+                train_lines.insert(trainline_from_string(std::string(table.resolve(ref))));
+            }
 
-        auto sequence_view = stop_ids
-            | std::views::all
-            | std::views::transform([&](std::string_view gtfs_id) -> std::optional<int>
+            try
             {
-                auto it = gtfs_to_id.find(gtfs_id);
-                return (it != gtfs_to_id.end() ? std::make_optional(it->second) : std::nullopt);
-            })
-            | std::views::filter([](const auto& opt)
+                add_node(complex_id, stop_name, train_lines, {gtfs}, latitudes[row], longitudes[row]);
+            }
+            catch (const std::invalid_argument &e)
             {
-                return opt.has_value();
-            })
-            | std::views::transform([](const auto& opt)
+                update_node(complex_id, train_lines, {gtfs});
+            }
+
+            std::uint32_t gtfs_index{gtfs_ids.intern(gtfs)};
+            if (gtfs_index == gtfs_to_id.size())
             {
-                return *opt;
-            });
+                gtfs_to_id.push_back(complex_id);
+            }
+            else
+            {
+                gtfs_to_id[gtfs_index] = complex_id;
+            }
+        }
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Failed to load subway stations from " << file_path << ": " << e.what() << "\n";
+    }
+}
 
-        std::vector<int> raw_sequence {sequence_view.begin(), sequence_view.end()};
+void Subway::load_connections(const std::string &file_path)
+{
+    using ColumnarFormat::Type;
 
-        if (raw_sequence.empty())
-        {
-            return;
-        }
+    try
+    {
+        Utils::ColumnarTable table{file_path};
 
-        std::vector<int> sequence{};
-        std::vector<int> distances{};
-        sequence.reserve(raw_sequence.size());
-        distances.reserve(raw_sequence.size() - 1);
+        std::size_t route_column{table.column("route_id", Type::STRING)};
+        std::size_t headsign_column{table.column("headsign", Type::STRING)};
+        std::size_t ordered_stops_column{table.column("ordered_stops", Type::STRING_LIST)};
 
-        for (int u : raw_sequence)
+        for (std::size_t row{0}; row < table.row_count(); ++row)
         {
-            const Node* node {get_node(u)};
-            if (!node)
+            TrainLine route{trainline_from_string(std::string(table.string(route_column, row)))};
+            std::string headsign{table.string(headsign_column, row)};
+
+            auto sequence_view = table.string_list(ordered_stops_column, row)
+                | std::views::transform([&](const ColumnarFormat::StringRef &ref) -> std::optional<int>
+                {
+                    auto gtfs_index {gtfs_ids.find(table.resolve(ref))};
+                    return (gtfs_index.has_value() ? std::make_optional(gtfs_to_id[*gtfs_index]) : std::nullopt);
+                })
+                | std::views::filter([](const auto& opt)
+                {
+                    return opt.has_value();
+                })
+                | std::views::transform([](const auto& opt)
+                {
+                    return *opt;
+                });
+
+            std::vector<int> raw_sequence {sequence_view.begin(), sequence_view.end()};
+
+            if (raw_sequence.empty())
             {
                 continue;
             }
 
-            if (node->train_lines.contains(route))
+            std::vector<int> sequence{};
+            std::vector<int> distances{};
+            sequence.reserve(raw_sequence.size());
+            distances.reserve(raw_sequence.size() - 1);
+
+            for (int u : raw_sequence)
             {
-                if (!sequence.empty())
+                const Node* node {get_node(u)};
+                if (!node)
                 {
-                    int v {sequence.back()};
-                    auto *edge {add_edge(u, v)};
-                    distances.push_back(static_cast<int>(std::ceil(edge->weight)));
+                    continue;
+                }
+
+                if (node->train_lines.contains(route))
+                {
+                    if (!sequence.empty())
+                    {
+                        int v {sequence.back()};
+                        auto *edge {add_edge(u, v)};
+                        distances.push_back(static_cast<int>(std::ceil(edge->weight)));
+                    }
+                    sequence.push_back(u);
                 }
-                sequence.push_back(u);
             }
-        }
 
-        add_route(route, headsign, sequence, distances); });
-    }
\ No newline at end of file
+            add_route(route, headsign, sequence, distances);
+        }
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Failed to load subway connections from " << file_path << ": " << e.what() << "\n";
+    }
+}
\ No newline at end of file
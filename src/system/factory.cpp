@@ -42,8 +42,8 @@ void Factory::build_network(const Transit::Map::Graph &graph, const Registry &re
                 int from_id{route.sequence[i - 1]};
                 int to_id{route.sequence[i]};
 
-                Station *from{stations.at(from_id).get()};
-                Station *to{stations.at(to_id).get()};
+                Station *from{station_ids.at(from_id)};
+                Station *to{station_ids.at(to_id)};
                 int duration{route.distances[i - 1]};
 
                 create_track(from, to, train_line, route.direction, duration);
@@ -52,147 +52,144 @@ void Factory::build_network(const Transit::Map::Graph &graph, const Registry &re
             int start_id{};
             int end_id{};
 
-            Info first{registry.decode(yard_pair.first)};
             Info second{registry.decode(yard_pair.second)};
 
             if (directions_equal(route.direction, second.direction))
             {
-                start_id = first.id;
-                end_id = second.id;
+                start_id = yard_pair.first;
+                end_id = yard_pair.second;
             }
             else
             {
-                start_id = second.id;
-                end_id = first.id;
+                start_id = yard_pair.second;
+                end_id = yard_pair.first;
             }
 
-            Station *start_yard{stations.at(start_id).get()};
-            Station *end_yard{stations.at(end_id).get()};
+            Station *start_yard{station_ids.at(start_id)};
+            Station *end_yard{station_ids.at(end_id)};
 
-            Station *first_station{stations.at(route.sequence.front()).get()};
-            Station *last_station{stations.at(route.sequence.back()).get()};
+            Station *first_station{station_ids.at(route.sequence.front())};
+            Station *last_station{station_ids.at(route.sequence.back())};
 
             create_track(start_yard, first_station, train_line, route.direction, Constants::DEFAULT_TRAVEL_TIME);
             create_track(last_station, end_yard, train_line, route.direction, Constants::DEFAULT_TRAVEL_TIME);
         }
     }
+
+    index_lines();
 }
 
-std::vector<Train *> Factory::get_trains() const
+std::span<Train *const> Factory::get_trains() const
 {
-    std::vector<Train *> output{};
-    output.reserve(trains.size());
-
-    std::ranges::transform(trains, std::back_inserter(output), [](const auto &pair)
-                           { return pair.second.get(); });
-
-    return output;
+    return train_index;
 }
 
-std::vector<Train *> Factory::get_trains(TrainLine train_line) const
+std::span<Train *const> Factory::get_trains(TrainLine train_line) const
 {
-    std::vector<Train *> output{};
-    output.reserve(trains.size());
-
-    for (auto &[id, train] : trains)
+    auto it{line_trains.find(train_line)};
+    if (it == line_trains.end())
     {
-        if (trainlines_equal(train->get_train_line(), train_line))
-        {
-            output.push_back(train.get());
-        }
+        return {};
     }
-    return output;
+    return it->second;
 }
 
-std::vector<Station *> Factory::get_stations() const
+std::span<Station *const> Factory::get_stations() const
 {
-    std::vector<Station *> output{};
-    output.reserve(stations.size());
-
-    std::ranges::transform(stations, std::back_inserter(output), [](const auto &pair)
-                           { return pair.second.get(); });
-
-    return output;
+    return station_index;
 }
 
-std::vector<Station *> Factory::get_stations(TrainLine train_line) const
+std::span<Station *const> Factory::get_stations(TrainLine train_line) const
 {
-    std::vector<Station *> output{};
-    output.reserve(stations.size());
-
-    for (auto &[id, station] : stations)
+    auto it{line_stations.find(train_line)};
+    if (it == line_stations.end())
     {
-        if (station->get_train_lines().contains(train_line))
-        {
-            output.push_back(station.get());
-        }
+        return {};
     }
-    return output;
+    return it->second;
 }
 
-std::vector<Signal *> Factory::get_signals() const
+std::span<const LineTopology *const> Factory::get_topologies() const
 {
-    std::vector<Signal *> output{};
-    output.reserve(signals.size());
-
-    std::ranges::transform(signals, std::back_inserter(output), [](const auto &pair)
-                           { return pair.second.get(); });
-
-    return output;
+    return topology_index;
 }
 
-std::vector<Platform *> Factory::get_platforms() const
+std::span<Signal *const> Factory::get_signals() const
 {
-    std::vector<Platform *> output{};
-    output.reserve(platforms.size());
-
-    std::ranges::transform(platforms, std::back_inserter(output), [](const auto &pair)
-                           { return pair.second.get(); });
-
-    return output;
+    return signal_index;
 }
 
-std::vector<Track *> Factory::get_tracks() const
+std::span<Platform *const> Factory::get_platforms() const
 {
-    std::vector<Track *> output{};
-    output.reserve(tracks.size());
-
-    std::ranges::transform(tracks, std::back_inserter(output), [](const auto &pair)
-                           { return pair.second.get(); });
+    return platform_index;
+}
 
-    return output;
+std::span<Track *const> Factory::get_tracks() const
+{
+    return track_index;
 }
 
-std::vector<Switch *> Factory::get_switches() const
+std::span<Switch *const> Factory::get_switches() const
 {
-    std::vector<Switch *> output{};
-    output.reserve(switches.size());
+    return switch_index;
+}
 
-    std::ranges::transform(switches, std::back_inserter(output), [](const auto &pair)
-                           { return pair.second.get(); });
+StateStore &Factory::get_state_store()
+{
+    return state;
+}
 
-    return output;
+const LineTopology &Factory::get_topology(TrainLine train_line) const
+{
+    auto it{line_topologies.find(train_line)};
+    if (it == line_topologies.end())
+    {
+        return empty_topology;
+    }
+    return it->second;
 }
 
-int Factory::generate_signal_id()
+Signal *Factory::allocate_signal()
 {
-    return next_signal_id++;
+    Signal *signal{&signals.emplace_back(static_cast<int>(signal_index.size()), &state)};
+    signal_index.push_back(signal);
+    return signal;
 }
 
-int Factory::generate_track_id()
+Switch *Factory::allocate_switch()
 {
-    return next_track_id++;
+    Switch *sw{&switches.emplace_back(static_cast<int>(switch_index.size()))};
+    switch_index.push_back(sw);
+    return sw;
 }
 
-int Factory::generate_switch_id()
+void Factory::index_lines()
 {
-    return next_switch_id++;
+    for (Train *train : train_index)
+    {
+        line_trains[train->get_train_line()].push_back(train);
+    }
+
+    for (Station *station : station_index)
+    {
+        for (const auto &train_line : station->get_train_lines())
+        {
+            line_stations[train_line].push_back(station);
+        }
+    }
+
+    // the topology is static from here on, so the connections each line uses are resolved once
+    for (const auto &[train_line, stations] : line_stations)
+    {
+        auto [it, inserted]{line_topologies.try_emplace(train_line, train_line, track_index, stations)};
+        topology_index.push_back(&it->second);
+    }
 }
 
 void Factory::create_trains(const Registry &registry, Constants::System system_code)
 {
     const auto &train_registry{registry.get_train_registry(system_code)};
-    trains.reserve(train_registry.size());
+    train_index.reserve(train_registry.size());
 
     for (const auto &encoded : train_registry)
     {
@@ -209,19 +206,17 @@ void Factory::create_trains(const Registry &registry, Constants::System system_c
 
             for (const auto &stop : train_route.sequence)
             {
-                const auto &station{stations.at(stop)};
-                train_route_stops.push_back(station.get());
+                train_route_stops.push_back(station_ids.at(stop));
             }
 
-            trains.emplace(
+            train_index.push_back(&trains.emplace_back(
                 info.id,
-                std::make_unique<Train>(
-                    info.id,
-                    train_route.headsign,
-                    info.train_line,
-                    ServiceType::BOTH,
-                    info.direction,
-                    train_route_stops));
+                train_route.headsign,
+                info.train_line,
+                ServiceType::BOTH,
+                info.direction,
+                train_route_stops,
+                &state));
         }
     }
 }
@@ -232,7 +227,7 @@ void Factory::create_stations(const Transit::Map::Graph &graph, const Registry &
     const auto &yard_registry{registry.get_yard_registry(system_code)};
     auto directions{Constants::get_directions_by_system_code(system_code)};
 
-    stations.reserve(adj_list.size() + (yard_registry.size() * 2));
+    station_index.reserve(adj_list.size() + (yard_registry.size() * 2));
 
     auto create_platforms = [&](const std::array<Direction, 2> &directions, Station *station_ptr, int count = 1)
     {
@@ -240,38 +235,41 @@ void Factory::create_stations(const Transit::Map::Graph &graph, const Registry &
         {
             for (int i{0}; i < count; ++i)
             {
-                int signal_id{generate_signal_id()};
-                int track_id{generate_track_id()};
-
-                auto signal{std::make_unique<Signal>(signal_id)};
-                Signal *signal_ptr{signal.get()};
-                signals.emplace(signal_id, std::move(signal));
-
+                Signal *signal_ptr{allocate_signal()};
                 int duration{station_ptr->is_yard() ? 0 : Constants::DEFAULT_DWELL_TIME};
 
-                auto platform{std::make_unique<Platform>(
-                    track_id,
+                Platform *platform{&platforms.emplace_back(
+                    static_cast<int>(track_index.size()),
                     signal_ptr,
                     station_ptr,
                     direction,
                     duration,
-                    station_ptr->get_train_lines())};
+                    station_ptr->get_train_lines(),
+                    &state)};
+                platform_index.push_back(platform);
+                track_index.push_back(platform);
 
-                station_ptr->add_platform(platform.get());
-                signal_ptr->set_track(static_cast<Track *>(platform.get()));
-                platforms.emplace(track_id, std::move(platform));
+                station_ptr->add_platform(platform);
+                signal_ptr->set_track(static_cast<Track *>(platform));
             }
         }
     };
 
+    auto add_station = [&](int id, const std::string &name, bool yard, const std::unordered_set<TrainLine> &train_lines)
+    {
+        Station *station{&stations.emplace_back(id, name, yard, train_lines)};
+        station_index.push_back(station);
+        station_ids.emplace(id, station);
+        return station;
+    };
+
     for (const auto &[id, edges] : adj_list)
     {
         const Transit::Map::Node *node{graph.get_node(id)};
 
-        auto station{std::make_unique<Station>(id, node->name, false, node->train_lines)};
+        Station *station{add_station(id, node->name, false, node->train_lines)};
         int count{std::clamp((static_cast<int>(node->train_lines.size()) + 2) / 3, 1, 3)};
-        create_platforms(directions, station.get(), count);
-        stations.emplace(id, std::move(station));
+        create_platforms(directions, station, count);
     }
 
     for (const auto &[start_id, end_id] : yard_registry)
@@ -279,14 +277,11 @@ void Factory::create_stations(const Transit::Map::Graph &graph, const Registry &
         Info start{registry.decode(start_id)};
         Info end{registry.decode(end_id)};
 
-        auto start_yard{std::make_unique<Station>(start_id, Utils::generate_yard_name(start), true, std::unordered_set<TrainLine>{start.train_line})};
-        auto end_yard{std::make_unique<Station>(end_id, Utils::generate_yard_name(end), true, std::unordered_set<TrainLine>{end.train_line})};
+        Station *start_yard{add_station(start_id, Utils::generate_yard_name(start), true, std::unordered_set<TrainLine>{start.train_line})};
+        Station *end_yard{add_station(end_id, Utils::generate_yard_name(end), true, std::unordered_set<TrainLine>{end.train_line})};
 
-        create_platforms(directions, start_yard.get());
-        create_platforms(directions, end_yard.get());
-
-        stations.emplace(start_id, std::move(start_yard));
-        stations.emplace(end_id, std::move(end_yard));
+        create_platforms(directions, start_yard);
+        create_platforms(directions, end_yard);
     }
 }
 
@@ -344,16 +339,10 @@ void Factory::create_track(Station *from, Station *to, TrainLine train_line, Dir
     Track *current{nullptr};
     for (int i{0}; i < duration_subparts.size(); ++i)
     {
-        int signal_id{generate_signal_id()};
-        int track_id{generate_track_id()};
-
-        auto signal{std::make_unique<Signal>(signal_id)};
-        Signal *signal_ptr{signal.get()};
-        signals.emplace(signal_id, std::move(signal));
+        Signal *signal_ptr{allocate_signal()};
 
-        auto track{std::make_unique<Track>(track_id, signal_ptr, duration_subparts[i], std::unordered_set<TrainLine>{train_line})};
-        Track *track_ptr{track.get()};
-        tracks.emplace(track_id, std::move(track));
+        Track *track_ptr{&tracks.emplace_back(static_cast<int>(track_index.size()), signal_ptr, duration_subparts[i], std::unordered_set<TrainLine>{train_line}, &state)};
+        track_index.push_back(track_ptr);
 
         signal_ptr->set_track(track_ptr);
 
@@ -410,10 +399,7 @@ void Factory::create_switch(const std::vector<Platform *> &from_platforms, const
 
         if (sw == nullptr)
         {
-            int switch_id{generate_switch_id()};
-            auto new_sw{std::make_unique<Switch>(switch_id)};
-            sw = new_sw.get();
-            switches.emplace(switch_id, std::move(new_sw));
+            sw = allocate_switch();
 
             for (Platform *from : from_platforms)
             {
@@ -440,10 +426,7 @@ void Factory::create_switch(const std::vector<Platform *> &from_platforms, const
 
         if (sw == nullptr)
         {
-            int switch_id{generate_switch_id()};
-            auto new_sw{std::make_unique<Switch>(switch_id)};
-            sw = new_sw.get();
-            switches.emplace(switch_id, std::move(new_sw));
+            sw = allocate_switch();
 
             for (Platform *to : to_platforms)
             {
@@ -3,6 +3,9 @@
  * docs/system/registry.md
  */
 
+#include <stdexcept>
+#include <string>
+
 #include "system/registry.h"
 
 Registry::Registry()
@@ -10,45 +13,86 @@ Registry::Registry()
     build_registry();
 }
 
-const std::vector<int> &Registry::get_train_registry(Constants::System system_code) const
+const std::vector<TrainId> &Registry::get_train_registry(Constants::System system_code) const
 {
-    auto it{train_registry.find(system_code)};
-    if (it == train_registry.end())
-    {
-        return {};
-    }
-    else
+    return get_system(system_code).trains;
+}
+
+const std::vector<std::pair<int, int>> &Registry::get_yard_registry(Constants::System system_code) const
+{
+    return get_system(system_code).yards;
+}
+
+int Registry::get_fleet_size(Constants::System system_code, const TrainLine &train_line) const
+{
+    const SystemRegistry &system{get_system(system_code)};
+    int train_line_code{std::visit([](auto tl) { return static_cast<int>(tl); }, train_line)};
+
+    if (train_line_code < 0 || train_line_code >= system.fleet_sizes.size())
     {
-        return it->second;
+        throw std::invalid_argument("Unknown train line " + trainline_to_string(train_line) + " for system " + std::to_string(static_cast<int>(system_code)));
     }
+
+    return system.fleet_sizes[train_line_code];
 }
 
-const std::vector<std::pair<int, int>> &Registry::get_yard_registry(Constants::System system_code) const
+void Registry::set_fleet_size(Constants::System system_code, const TrainLine &train_line, int trains)
 {
-    auto it{yard_registry.find(system_code)};
-    if (it == yard_registry.end())
+    SystemRegistry &system{get_system(system_code)};
+    int train_line_code{std::visit([](auto tl) { return static_cast<int>(tl); }, train_line)};
+
+    if (system.frozen.load(std::memory_order_relaxed))
     {
-        return {};
+        throw std::logic_error("Cannot change the fleet of a frozen registry");
     }
-    else
+
+    if (train_line_code < 0 || train_line_code >= system.fleet_sizes.size())
     {
-        return it->second;
+        throw std::invalid_argument("Unknown train line " + trainline_to_string(train_line) + " for system " + std::to_string(static_cast<int>(system_code)));
     }
+
+    if (trains < 0)
+    {
+        throw std::invalid_argument("Invalid fleet size " + std::to_string(trains) + " for train line " + trainline_to_string(train_line));
+    }
+
+    system.fleet_sizes[train_line_code] = trains;
+    generate_trains(system_code);
+}
+
+//[ unused (1 bit) | instance (31 bits) | system (4 bits) | train_line_code (8 bits) | direction_code (12 bits) | unused (8 bits) ]
+TrainId Registry::encode(Constants::System system_code, int train_line_code, int direction_code, int instance)
+{
+    TrainId code{static_cast<int>(system_code)};
+    return (static_cast<TrainId>(instance & 0x7FFFFFFF) << 32) | ((code & 0xF) << 28) | ((train_line_code & 0xFF) << 20) | ((direction_code & 0xFFF) << 8);
+}
+
+int Registry::system_code_of(TrainId encoded_id)
+{
+    return static_cast<int>((encoded_id >> 28) & 0xF);
+}
+
+int Registry::train_line_code_of(TrainId encoded_id)
+{
+    return static_cast<int>((encoded_id >> 20) & 0xFF);
+}
+
+int Registry::direction_code_of(TrainId encoded_id)
+{
+    return static_cast<int>((encoded_id >> 8) & 0xFFF);
 }
 
-//[ system (4 bits) | train_line_code (8 bits) | direction_code (12 bits) | order (8 bits) ]
-int Registry::encode(Constants::System system_code, int train_line_code, int direction_code, int instance)
+int Registry::instance_of(TrainId encoded_id)
 {
-    int code {static_cast<int>(system_code)};
-    return ((code & 0xF) << 28) | ((train_line_code & 0xFF) << 20) | ((direction_code & 0xFFF) << 8) | (instance & 0xFF);
+    return static_cast<int>((encoded_id >> 32) & 0x7FFFFFFF);
 }
 
-Info Registry::decode(int encoded_id) const
+Info Registry::decode(TrainId encoded_id) const
 {
-    int code{(encoded_id >> 28) & 0xF};
-    int train_line_code{(encoded_id >> 20) & 0xFF};
-    int direction_code{(encoded_id >> 8) & 0xFFF};
-    int instance{encoded_id & 0xFF};
+    int code{system_code_of(encoded_id)};
+    int train_line_code{train_line_code_of(encoded_id)};
+    int direction_code{direction_code_of(encoded_id)};
+    int instance{instance_of(encoded_id)};
 
     TrainLine train_line{};
     Direction direction{};
@@ -84,23 +128,112 @@ Info Registry::decode(int encoded_id) const
     return {encoded_id, system_code, train_line, direction, instance};
 }
 
-void Registry::register_route(int train_id, const Transit::Map::Route& route)
+void Registry::register_route(TrainId train_id, const Transit::Map::Route& route)
 {
-    route_registry.insert({train_id, route});
+    auto location{locate(train_id)};
+    if (!location.has_value())
+    {
+        throw std::invalid_argument("Cannot register a route for unknown train " + std::to_string(train_id));
+    }
+
+    SystemRegistry &system{systems[location->first]};
+    const Transit::Map::Route *&registered{system.routes[location->second]};
+
+    if (system.frozen.load(std::memory_order_relaxed))
+    {
+        if (registered != &route)
+        {
+            throw std::logic_error("Cannot change the route of train " + std::to_string(train_id) + " in a frozen registry");
+        }
+        return;
+    }
+
+    registered = &route;
 }
 
-std::optional<std::reference_wrapper<const Transit::Map::Route>> Registry::get_registered_route(int train_id) const
+std::optional<std::reference_wrapper<const Transit::Map::Route>> Registry::get_registered_route(TrainId train_id) const
 {
-    auto it {route_registry.find(train_id)};
+    auto location{locate(train_id)};
+    if (!location.has_value())
+    {
+        return std::nullopt;
+    }
 
-    if (it == route_registry.end())
+    const Transit::Map::Route *route{systems[location->first].routes[location->second]};
+    if (route == nullptr)
     {
         return std::nullopt;
     }
     else
     {
-        return it->second;
+        return *route;
+    }
+}
+
+void Registry::freeze(Constants::System system_code)
+{
+    // release publishes the routes written during setup to readers that see the system frozen
+    get_system(system_code).frozen.store(true, std::memory_order_release);
+}
+
+bool Registry::is_frozen(Constants::System system_code) const
+{
+    return get_system(system_code).frozen.load(std::memory_order_acquire);
+}
+
+std::optional<std::pair<std::size_t, std::size_t>> Registry::locate(TrainId train_id) const
+{
+    std::size_t shard{static_cast<std::size_t>(system_code_of(train_id)) - 1};
+    if (train_id < 0 || shard >= systems.size())
+    {
+        return std::nullopt;
+    }
+
+    const SystemRegistry &registry{systems[shard]};
+
+    // the acquire pairs with the release in freeze, so lookups from other threads see the trains and routes written during setup
+    registry.frozen.load(std::memory_order_acquire);
+
+    std::size_t train_line_code{static_cast<std::size_t>(train_line_code_of(train_id))};
+    std::size_t direction_code{static_cast<std::size_t>(direction_code_of(train_id))};
+    std::size_t instance{static_cast<std::size_t>(instance_of(train_id))};
+
+    if (train_line_code >= registry.fleet_sizes.size() || direction_code >= registry.direction_count || (train_id & 0xFF) != 0)
+    {
+        return std::nullopt;
+    }
+
+    // trains of a line and direction are stored contiguously by instance
+    std::size_t slot{train_line_code * registry.direction_count + direction_code};
+    std::size_t index{registry.first_train[slot] + instance};
+    if (index >= registry.first_train[slot + 1])
+    {
+        return std::nullopt;
+    }
+
+    return std::make_pair(shard, index);
+}
+
+std::size_t Registry::system_index(Constants::System system_code)
+{
+    // system codes are numbered from 1 in the order of Constants::SYSTEMS
+    std::size_t index{static_cast<std::size_t>(system_code) - 1};
+    if (index >= Constants::SYSTEMS.size())
+    {
+        throw std::invalid_argument("Invalid system code: " + std::to_string(static_cast<int>(system_code)));
     }
+
+    return index;
+}
+
+Registry::SystemRegistry &Registry::get_system(Constants::System system_code)
+{
+    return systems[system_index(system_code)];
+}
+
+const Registry::SystemRegistry &Registry::get_system(Constants::System system_code) const
+{
+    return systems[system_index(system_code)];
 }
 
 void Registry::build_registry()
@@ -136,41 +269,69 @@ void Registry::build_registry()
         }
         }
 
-        generate_trains(system, tl_count, dir_count);
-        generate_yards(system, tl_count);
+        SystemRegistry &registry{get_system(system)};
+        registry.direction_count = dir_count;
+        registry.fleet_sizes.assign(tl_count, Constants::DEFAULT_TRAINS_PER_LINE);
+
+        generate_trains(system);
+        generate_yards(system);
     }
 }
 
-void Registry::generate_trains(Constants::System system_code, int tl_count, int dir_count)
+void Registry::generate_trains(Constants::System system_code)
 {
-    int trains_per_dir{Constants::DEFAULT_TRAINS_PER_LINE / 2};
-    int total_trains{tl_count * dir_count * trains_per_dir};
+    SystemRegistry &registry{get_system(system_code)};
+    int dir_count{registry.direction_count};
+
+    std::size_t total_trains{0};
+    for (int fleet_size : registry.fleet_sizes)
+    {
+        total_trains += fleet_size;
+    }
 
-    train_registry[system_code].reserve(total_trains);
+    registry.trains.clear();
+    registry.trains.reserve(total_trains);
+    registry.first_train.clear();
+    registry.first_train.reserve(registry.fleet_sizes.size() * dir_count + 1);
 
-    for (int i{0}; i < total_trains; ++i)
+    for (int train_line_code{0}; train_line_code < registry.fleet_sizes.size(); ++train_line_code)
     {
-        train_registry[system_code].push_back(encode(
-            system_code,
-            i / (dir_count * trains_per_dir) /* TrainLine enumertion */,
-            (i / trains_per_dir) % dir_count /* Direction enumeration */,
-            i % trains_per_dir /* instance */
-            ));
+        int fleet_size{registry.fleet_sizes[train_line_code]};
+
+        for (int direction_code{0}; direction_code < dir_count; ++direction_code)
+        {
+            registry.first_train.push_back(registry.trains.size());
+
+            // trains that do not split evenly go to the first directions
+            int trains_per_dir{fleet_size / dir_count + (direction_code < fleet_size % dir_count ? 1 : 0)};
+            for (int instance{0}; instance < trains_per_dir; ++instance)
+            {
+                registry.trains.push_back(encode(system_code, train_line_code, direction_code, instance));
+            }
+        }
     }
+
+    registry.first_train.push_back(registry.trains.size());
+    registry.routes.assign(registry.trains.size(), nullptr);
 }
 
-void Registry::generate_yards(Constants::System system_code, int tl_count)
+void Registry::generate_yards(Constants::System system_code)
 {
-    yard_registry[system_code].reserve(tl_count);
+    SystemRegistry &registry{get_system(system_code)};
+    int tl_count{static_cast<int>(registry.fleet_sizes.size())};
+
+    registry.yards.clear();
+    registry.yards.reserve(tl_count);
 
     auto directions{Constants::get_directions_by_system_code(system_code)};
     int dir_one{std::visit([](auto d) { return static_cast<int>(d); }, directions[0])};
     int dir_two{std::visit([](auto d) { return static_cast<int>(d); }, directions[1])};
 
+    // yards are instance 0 of their line and direction, so their ids fit the int station ids
     for (int i{0}; i < tl_count; ++i)
     {
-        yard_registry[system_code].emplace_back(
-            encode(system_code, i /* TrainLine enumeration */, dir_one /* Direction enumeration */, 0 /* instance */),
-            encode(system_code, i /* TrainLine enumeration */, dir_two /* Direction enumeration */, 0 /* instance */));
+        registry.yards.emplace_back(
+            static_cast<int>(encode(system_code, i /* TrainLine enumeration */, dir_one /* Direction enumeration */, 0 /* instance */)),
+            static_cast<int>(encode(system_code, i /* TrainLine enumeration */, dir_two /* Direction enumeration */, 0 /* instance */)));
     }
-}
\ No newline at end of file
+}
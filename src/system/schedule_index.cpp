@@ -0,0 +1,236 @@
+/**
+ * for details on design, see:
+ * docs/system/schedule_index.md
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "constants/constants.h"
+#include "system/schedule_index.h"
+#include "utils/json_writer.h"
+
+ScheduleIndex::ScheduleIndex(const std::string &file_path) : file(file_path)
+{
+    if (file.size() < sizeof(ScheduleFormat::Header))
+    {
+        throw std::runtime_error("Schedule is truncated: " + file_path);
+    }
+
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (!std::equal(std::begin(ScheduleFormat::MAGIC), std::end(ScheduleFormat::MAGIC), header.magic))
+    {
+        throw std::runtime_error("Not a schedule file: " + file_path);
+    }
+
+    if (header.version != ScheduleFormat::VERSION)
+    {
+        throw std::runtime_error("Unsupported schedule version " + std::to_string(header.version) + ": " + file_path);
+    }
+
+    lines_section = section<ScheduleFormat::Line>(header.lines_offset, header.line_count, "lines");
+    trips_section = section<ScheduleFormat::Trip>(header.trips_offset, header.trip_count, "trips");
+    patterns_section = section<ScheduleFormat::Pattern>(header.patterns_offset, header.pattern_count, "patterns");
+    stops_section = section<ScheduleFormat::Stop>(header.stops_offset, header.stop_count, "stops");
+    stations_section = section<ScheduleFormat::Station>(header.stations_offset, header.station_count, "stations");
+
+    auto heap{section<char>(header.string_heap_offset, header.string_heap_size, "string heap")};
+    string_heap = std::string_view(heap.data(), heap.size());
+
+    validate();
+}
+
+std::span<const ScheduleFormat::Trip> ScheduleIndex::get_trips(TrainLine train_line) const
+{
+    std::string line_name{trainline_to_string(train_line)};
+
+    auto it{std::ranges::lower_bound(lines_section, std::string_view(line_name), {}, [&](const ScheduleFormat::Line &line)
+                                     { return resolve(line.name); })};
+    if (it == lines_section.end() || resolve(it->name) != line_name)
+    {
+        return {};
+    }
+
+    return trips_section.subspan(it->first_trip, it->trip_count);
+}
+
+std::span<const ScheduleFormat::Stop> ScheduleIndex::get_stops(const ScheduleFormat::Trip &trip) const
+{
+    const ScheduleFormat::Pattern &pattern{patterns_section[trip.pattern]};
+    return stops_section.subspan(pattern.first_stop, pattern.stop_count);
+}
+
+Direction ScheduleIndex::get_direction(const ScheduleFormat::Trip &trip) const
+{
+    switch (static_cast<Constants::System>(header.system_code))
+    {
+    case Constants::System::SUBWAY:
+        return static_cast<SUB::Direction>(trip.direction);
+    case Constants::System::METRO_NORTH:
+        return static_cast<MNR::Direction>(trip.direction);
+    case Constants::System::LIRR:
+        return static_cast<LIRR::Direction>(trip.direction);
+    }
+
+    return static_cast<Generic::Direction>(trip.direction);
+}
+
+std::string_view ScheduleIndex::get_headsign(const ScheduleFormat::Trip &trip) const
+{
+    return resolve(trip.headsign);
+}
+
+std::string_view ScheduleIndex::get_station_name(int station_id) const
+{
+    auto it{std::ranges::lower_bound(stations_section, station_id, {}, &ScheduleFormat::Station::station_id)};
+    if (it == stations_section.end() || it->station_id != station_id)
+    {
+        return {};
+    }
+
+    return resolve(it->name);
+}
+
+Constants::System ScheduleIndex::get_system_code() const
+{
+    return static_cast<Constants::System>(header.system_code);
+}
+
+std::size_t ScheduleIndex::get_trip_count() const
+{
+    return trips_section.size();
+}
+
+std::size_t ScheduleIndex::get_pattern_count() const
+{
+    return patterns_section.size();
+}
+
+void ScheduleIndex::write_json(const std::string &file_path) const
+{
+    // keys are written in sorted order to keep the layout of the previous nlohmann::json output,
+    // patterns are expanded back into absolute ticks for every trip
+    Utils::JsonWriter writer{file_path};
+
+    writer.begin_object();
+    writer.key("train_lines");
+    writer.begin_object();
+
+    for (const auto &line : lines_section)
+    {
+        writer.key(resolve(line.name));
+        writer.begin_object();
+        writer.key("trains");
+        writer.begin_array();
+
+        for (const auto &trip : trips_section.subspan(line.first_trip, line.trip_count))
+        {
+            writer.begin_object();
+            writer.key("direction");
+            writer.value(direction_to_string(get_direction(trip)));
+            writer.key("headsign");
+            writer.value(get_headsign(trip));
+            writer.key("schedule");
+            writer.begin_array();
+
+            for (const auto &stop : get_stops(trip))
+            {
+                writer.begin_object();
+                writer.key("arrival_tick");
+                writer.value(stop.arrival_tick == -1 ? -1 : trip.start_tick + stop.arrival_tick);
+                writer.key("departure_tick");
+                writer.value(stop.departure_tick == -1 ? -1 : trip.start_tick + stop.departure_tick);
+                writer.key("station_id");
+                writer.value(stop.station_id);
+                writer.key("station_name");
+                writer.value(get_station_name(stop.station_id));
+                writer.end_object();
+            }
+
+            writer.end_array();
+            writer.key("train_id");
+            writer.value(trip.train_id);
+            writer.end_object();
+        }
+
+        writer.end_array();
+        writer.end_object();
+    }
+
+    writer.end_object();
+    writer.end_object();
+    writer.finish();
+}
+
+template <typename T>
+std::span<const T> ScheduleIndex::section(std::uint64_t offset, std::uint64_t count, const std::string &name) const
+{
+    if (offset % alignof(T) != 0 || offset > file.size() || count > (file.size() - offset) / sizeof(T))
+    {
+        throw std::runtime_error("Schedule " + name + " section is out of bounds");
+    }
+
+    // mappings are page aligned and sections are written on ALIGNMENT boundaries, so the cast is well aligned
+    return std::span<const T>(reinterpret_cast<const T *>(file.data() + offset), static_cast<std::size_t>(count));
+}
+
+std::string_view ScheduleIndex::resolve(const ScheduleFormat::StringRef &ref) const
+{
+    return string_heap.substr(ref.offset, ref.length);
+}
+
+void ScheduleIndex::validate() const
+{
+    auto valid_ref = [&](const ScheduleFormat::StringRef &ref)
+    {
+        return ref.offset <= string_heap.size() && ref.length <= string_heap.size() - ref.offset;
+    };
+
+    std::uint32_t direction_count{0};
+    switch (static_cast<Constants::System>(header.system_code))
+    {
+    case Constants::System::SUBWAY: direction_count = static_cast<std::uint32_t>(SUB::Direction::COUNT); break;
+    case Constants::System::METRO_NORTH: direction_count = static_cast<std::uint32_t>(MNR::Direction::COUNT); break;
+    case Constants::System::LIRR: direction_count = static_cast<std::uint32_t>(LIRR::Direction::COUNT); break;
+    default: throw std::runtime_error("Schedule has an unknown system code " + std::to_string(header.system_code));
+    }
+
+    for (const auto &line : lines_section)
+    {
+        if (!valid_ref(line.name) || line.first_trip > trips_section.size() || line.trip_count > trips_section.size() - line.first_trip)
+        {
+            throw std::runtime_error("Schedule line entry is out of bounds");
+        }
+    }
+
+    if (!std::ranges::is_sorted(lines_section, {}, [&](const ScheduleFormat::Line &line)
+                                { return resolve(line.name); }))
+    {
+        throw std::runtime_error("Schedule lines are not sorted by name");
+    }
+
+    for (const auto &pattern : patterns_section)
+    {
+        if (pattern.first_stop > stops_section.size() || pattern.stop_count > stops_section.size() - pattern.first_stop)
+        {
+            throw std::runtime_error("Schedule pattern entry is out of bounds");
+        }
+    }
+
+    for (const auto &trip : trips_section)
+    {
+        if (!valid_ref(trip.headsign) || trip.direction >= direction_count || trip.pattern >= patterns_section.size())
+        {
+            throw std::runtime_error("Schedule trip entry is out of bounds");
+        }
+    }
+
+    if (!std::all_of(stations_section.begin(), stations_section.end(), [&](const ScheduleFormat::Station &station)
+                     { return valid_ref(station.name); }) ||
+        !std::ranges::is_sorted(stations_section, {}, &ScheduleFormat::Station::station_id))
+    {
+        throw std::runtime_error("Schedule station table is invalid");
+    }
+}
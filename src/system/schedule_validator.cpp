@@ -0,0 +1,283 @@
+/**
+ * for details on design, see:
+ * docs/system/schedule_validator.md
+ */
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+#include "core/platform.h"
+#include "core/station.h"
+#include "core/track.h"
+#include "system/schedule_validator.h"
+
+namespace
+{
+    std::uint32_t direction_code(const Direction &direction)
+    {
+        return std::visit([](const auto &d)
+                          { return static_cast<std::uint32_t>(d); }, direction);
+    }
+}
+
+ScheduleValidator::ScheduleValidator(const Factory &factory, int mh) : minimum_headway(mh)
+{
+    for (const Station *station : factory.get_stations())
+    {
+        stations.emplace(station->get_id(), station);
+
+        for (const Platform *platform : station->get_platforms())
+        {
+            platform_capacity[platform_key(station->get_id(), direction_code(platform->get_direction()))] += 1;
+        }
+    }
+}
+
+std::vector<ScheduleValidator::Conflict> ScheduleValidator::validate(const ScheduleIndex &index) const
+{
+    std::vector<Occupancy> platforms{};
+    std::vector<Occupancy> blocks{};
+    std::vector<Occupancy> entries{};
+
+    auto collect_lines = [&](auto line)
+    {
+        using T = decltype(line);
+        for (int i{0}; i < static_cast<int>(T::COUNT); ++i)
+        {
+            collect(index, static_cast<T>(i), platforms, blocks, entries);
+        }
+    };
+
+    switch (index.get_system_code())
+    {
+    case Constants::System::SUBWAY:
+        collect_lines(SUB::TrainLine{});
+        break;
+    case Constants::System::METRO_NORTH:
+        collect_lines(MNR::TrainLine{});
+        break;
+    case Constants::System::LIRR:
+        collect_lines(LIRR::TrainLine{});
+        break;
+    }
+
+    std::vector<Conflict> conflicts{};
+    sweep(platforms, ConflictType::PLATFORM, &platform_capacity, conflicts);
+    sweep(blocks, ConflictType::BLOCK, nullptr, conflicts);
+    check_headways(entries, conflicts);
+
+    std::ranges::stable_sort(conflicts, {}, &Conflict::tick);
+    return conflicts;
+}
+
+std::int64_t ScheduleValidator::platform_key(int station_id, std::uint32_t direction)
+{
+    return (static_cast<std::int64_t>(station_id) << 8) | direction;
+}
+
+std::vector<const Track *> ScheduleValidator::find_block(int from_id, int to_id, const Direction &direction, TrainLine train_line) const
+{
+    auto from{stations.find(from_id)};
+    if (from == stations.end())
+    {
+        return {};
+    }
+
+    // tracks between two stations are one chain from the platforms of the first to the platforms of the second,
+    // the platforms of a station share their outgoing chains so the first one is enough
+    std::vector<Platform *> platforms{from->second->select_platforms(direction, train_line)};
+    if (platforms.empty())
+    {
+        return {};
+    }
+
+    for (const Track *first : platforms.front()->get_next_tracks())
+    {
+        if (first->is_platform() || !first->supports_train_line(train_line))
+        {
+            continue;
+        }
+
+        std::vector<const Track *> block{first};
+        const Track *current{first->get_next_tracks().empty() ? nullptr : first->get_next_tracks().front()};
+        while (current != nullptr && !current->is_platform())
+        {
+            block.push_back(current);
+            current = current->get_next_tracks().empty() ? nullptr : current->get_next_tracks().front();
+        }
+
+        if (current != nullptr && static_cast<const Platform *>(current)->get_station()->get_id() == to_id)
+        {
+            return block;
+        }
+    }
+
+    return {};
+}
+
+void ScheduleValidator::collect(const ScheduleIndex &index, TrainLine train_line, std::vector<Occupancy> &platforms, std::vector<Occupancy> &blocks, std::vector<Occupancy> &entries) const
+{
+    struct PatternOccupancy
+    {
+        std::vector<Occupancy> platforms;
+        std::vector<Occupancy> blocks;
+        std::vector<Occupancy> entries;
+    };
+
+    // trips of a pattern only differ in their start, so occupancies are derived once per pattern and shifted
+    std::unordered_map<std::uint64_t, PatternOccupancy> patterns{};
+
+    auto build = [&](const ScheduleFormat::Trip &trip)
+    {
+        PatternOccupancy occupancy{};
+        Direction direction{index.get_direction(trip)};
+        auto stops{index.get_stops(trip)};
+
+        for (std::size_t i{0}; i < stops.size(); ++i)
+        {
+            const auto &stop{stops[i]};
+            if (stop.arrival_tick != -1 && stop.departure_tick != -1 && stop.arrival_tick < stop.departure_tick)
+            {
+                occupancy.platforms.push_back(Occupancy{platform_key(stop.station_id, trip.direction), stop.arrival_tick, stop.departure_tick, 0});
+            }
+
+            if (i + 1 == stops.size())
+            {
+                continue;
+            }
+
+            const auto &next{stops[i + 1]};
+            std::vector<const Track *> block{find_block(stop.station_id, next.station_id, direction, train_line)};
+            if (block.empty() || stop.departure_tick == -1 || next.arrival_tick <= stop.departure_tick)
+            {
+                continue;
+            }
+
+            // travel ticks of a leg are shared out over its track parts by their durations
+            int total{0};
+            for (const Track *track : block)
+            {
+                total += track->get_duration();
+            }
+
+            int travel{next.arrival_tick - stop.departure_tick};
+            int elapsed{0};
+            for (const Track *track : block)
+            {
+                int start{stop.departure_tick + travel * elapsed / total};
+                elapsed += track->get_duration();
+                int end{stop.departure_tick + travel * elapsed / total};
+
+                if (start < end)
+                {
+                    occupancy.blocks.push_back(Occupancy{track->get_id(), start, end, 0});
+                }
+            }
+
+            occupancy.entries.push_back(Occupancy{block.front()->get_id(), stop.departure_tick, stop.departure_tick, 0});
+        }
+
+        return occupancy;
+    };
+
+    auto shift = [](const std::vector<Occupancy> &pattern, const ScheduleFormat::Trip &trip, std::vector<Occupancy> &out)
+    {
+        for (Occupancy occupancy : pattern)
+        {
+            occupancy.start_tick += trip.start_tick;
+            occupancy.end_tick += trip.start_tick;
+            occupancy.train_id = trip.train_id;
+            out.push_back(occupancy);
+        }
+    };
+
+    for (const auto &trip : index.get_trips(train_line))
+    {
+        std::uint64_t key{(static_cast<std::uint64_t>(trip.pattern) << 32) | trip.direction};
+
+        auto it{patterns.find(key)};
+        if (it == patterns.end())
+        {
+            it = patterns.emplace(key, build(trip)).first;
+        }
+
+        shift(it->second.platforms, trip, platforms);
+        shift(it->second.blocks, trip, blocks);
+        shift(it->second.entries, trip, entries);
+    }
+}
+
+void ScheduleValidator::sweep(std::vector<Occupancy> &occupancies, ConflictType type, const std::unordered_map<std::int64_t, int> *capacity, std::vector<Conflict> &conflicts)
+{
+    std::ranges::sort(occupancies, {}, [](const Occupancy &o)
+                      { return std::tie(o.resource, o.start_tick, o.end_tick); });
+
+    // occupancies of the current resource that have not ended yet, in order of their start
+    std::vector<const Occupancy *> active{};
+    std::vector<const Occupancy *> others{};
+
+    std::size_t limit{1};
+    for (std::size_t i{0}; i < occupancies.size(); ++i)
+    {
+        const Occupancy &current{occupancies[i]};
+
+        if (i == 0 || current.resource != occupancies[i - 1].resource)
+        {
+            active.clear();
+
+            if (capacity != nullptr)
+            {
+                auto it{capacity->find(current.resource)};
+                limit = (it == capacity->end()) ? 0 : static_cast<std::size_t>(it->second);
+            }
+        }
+
+        if (limit == 0)
+        {
+            continue;
+        }
+
+        std::erase_if(active, [&](const Occupancy *o)
+                      { return o->end_tick <= current.start_tick; });
+
+        // every overlapping occupancy of another train counts, occupancies of the same train do not
+        others.clear();
+        for (const Occupancy *o : active)
+        {
+            if (o->train_id != current.train_id)
+            {
+                others.push_back(o);
+            }
+        }
+
+        // the current train is paired with as many of the others as it brings the resource over its limit by
+        if (others.size() >= limit)
+        {
+            int resource_id{static_cast<int>(type == ConflictType::PLATFORM ? current.resource >> 8 : current.resource)};
+            for (std::size_t j{0}; j < others.size() - limit + 1; ++j)
+            {
+                conflicts.push_back(Conflict{type, resource_id, others[j]->train_id, current.train_id, current.start_tick});
+            }
+        }
+
+        active.push_back(&current);
+    }
+}
+
+void ScheduleValidator::check_headways(std::vector<Occupancy> &entries, std::vector<Conflict> &conflicts) const
+{
+    std::ranges::sort(entries, {}, [](const Occupancy &o)
+                      { return std::tie(o.resource, o.start_tick); });
+
+    for (std::size_t i{1}; i < entries.size(); ++i)
+    {
+        const Occupancy &previous{entries[i - 1]};
+        const Occupancy &current{entries[i]};
+
+        if (current.resource == previous.resource && current.train_id != previous.train_id && current.start_tick - previous.start_tick < minimum_headway)
+        {
+            conflicts.push_back(Conflict{ConflictType::HEADWAY, static_cast<int>(current.resource), previous.train_id, current.train_id, current.start_tick});
+        }
+    }
+}
@@ -0,0 +1,213 @@
+/**
+ * for details on design, see:
+ * docs/system/schedule_index.md
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include "system/schedule_writer.h"
+
+namespace
+{
+    std::size_t padded(std::size_t bytes)
+    {
+        return (bytes + ScheduleFormat::ALIGNMENT - 1) / ScheduleFormat::ALIGNMENT * ScheduleFormat::ALIGNMENT;
+    }
+
+    void write_padded(std::ofstream &out, const void *data, std::size_t bytes)
+    {
+        static constexpr char padding[ScheduleFormat::ALIGNMENT]{};
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+        out.write(padding, static_cast<std::streamsize>(padded(bytes) - bytes));
+    }
+}
+
+ScheduleWriter::ScheduleWriter(Constants::System sc) : system_code(sc) {}
+
+std::uint32_t ScheduleWriter::add_pattern(std::span<const ScheduleFormat::Stop> pattern_stops)
+{
+    // stops are three packed int32 values, so their bytes identify the pattern
+    std::string_view key(reinterpret_cast<const char *>(pattern_stops.data()), pattern_stops.size_bytes());
+
+    auto it{pattern_ids.find(key)};
+    if (it != pattern_ids.end())
+    {
+        return it->second;
+    }
+
+    std::uint32_t pattern{static_cast<std::uint32_t>(patterns.size())};
+    patterns.push_back(ScheduleFormat::Pattern{static_cast<std::uint32_t>(stops.size()), static_cast<std::uint32_t>(pattern_stops.size())});
+    stops.insert(stops.end(), pattern_stops.begin(), pattern_stops.end());
+    pattern_ids.emplace(std::string(key), pattern);
+
+    return pattern;
+}
+
+void ScheduleWriter::add_station(int station_id, std::string_view station_name)
+{
+    if (!station_names.contains(station_id))
+    {
+        station_names.emplace(station_id, store(station_name));
+    }
+}
+
+void ScheduleWriter::add_trip(const TrainLine &train_line, TrainId train_id, const Direction &direction, std::string_view headsign, std::uint32_t pattern, int start_tick)
+{
+    if (pattern >= patterns.size())
+    {
+        throw std::logic_error("Schedule trip refers to an unknown pattern");
+    }
+
+    std::uint32_t direction_code{std::visit([](const auto &d)
+                                            { return static_cast<std::uint32_t>(d); }, direction)};
+
+    line_for(trainline_to_string(train_line)).trips.push_back(ScheduleFormat::Trip{train_id, store(headsign), direction_code, pattern, start_tick, 0});
+}
+
+void ScheduleWriter::append(const ScheduleWriter &other)
+{
+    if (other.system_code != system_code)
+    {
+        throw std::logic_error("Cannot append a schedule of another system");
+    }
+
+    for (const auto &[station_id, name] : other.station_names)
+    {
+        add_station(station_id, other.resolve(name));
+    }
+
+    // pattern ids are local to each writer, so they are re-added and remapped
+    std::vector<std::uint32_t> pattern_map{};
+    pattern_map.reserve(other.patterns.size());
+    for (const auto &pattern : other.patterns)
+    {
+        pattern_map.push_back(add_pattern(std::span(other.stops).subspan(pattern.first_stop, pattern.stop_count)));
+    }
+
+    for (const auto &[line_name, other_line] : other.lines)
+    {
+        Line &line{line_for(line_name)};
+        line.trips.reserve(line.trips.size() + other_line.trips.size());
+        for (ScheduleFormat::Trip trip : other_line.trips)
+        {
+            trip.headsign = store(other.resolve(trip.headsign));
+            trip.pattern = pattern_map[trip.pattern];
+            line.trips.push_back(trip);
+        }
+    }
+}
+
+std::size_t ScheduleWriter::get_trip_count() const
+{
+    std::size_t count{0};
+    for (const auto &[name, line] : lines)
+    {
+        count += line.trips.size();
+    }
+    return count;
+}
+
+std::size_t ScheduleWriter::get_pattern_count() const
+{
+    return patterns.size();
+}
+
+std::span<const ScheduleFormat::Stop> ScheduleWriter::get_stops(std::uint32_t pattern) const
+{
+    const ScheduleFormat::Pattern &p{patterns.at(pattern)};
+    return std::span(stops).subspan(p.first_stop, p.stop_count);
+}
+
+void ScheduleWriter::write(const std::string &file_path) const
+{
+    std::vector<ScheduleFormat::Line> lines_section{};
+    std::vector<ScheduleFormat::Trip> trips_section{};
+
+    for (const auto &[name, line] : lines)
+    {
+        lines_section.push_back(ScheduleFormat::Line{line.name, static_cast<std::uint32_t>(trips_section.size()), static_cast<std::uint32_t>(line.trips.size())});
+        trips_section.insert(trips_section.end(), line.trips.begin(), line.trips.end());
+    }
+
+    std::vector<ScheduleFormat::Station> stations_section{};
+    stations_section.reserve(station_names.size());
+    for (const auto &[station_id, name] : station_names)
+    {
+        stations_section.push_back(ScheduleFormat::Station{station_id, name});
+    }
+
+    ScheduleFormat::Header header{};
+    std::copy(std::begin(ScheduleFormat::MAGIC), std::end(ScheduleFormat::MAGIC), header.magic);
+    header.version = ScheduleFormat::VERSION;
+    header.system_code = static_cast<std::uint32_t>(system_code);
+    header.line_count = static_cast<std::uint32_t>(lines_section.size());
+    header.trip_count = static_cast<std::uint32_t>(trips_section.size());
+    header.pattern_count = static_cast<std::uint32_t>(patterns.size());
+    header.stop_count = static_cast<std::uint32_t>(stops.size());
+    header.station_count = static_cast<std::uint32_t>(stations_section.size());
+    header.string_heap_size = static_cast<std::uint32_t>(heap.size());
+
+    std::uint64_t cursor{sizeof(ScheduleFormat::Header)};
+    auto place = [&](std::size_t bytes)
+    {
+        std::uint64_t offset{cursor};
+        cursor += padded(bytes);
+        return offset;
+    };
+
+    header.lines_offset = place(lines_section.size() * sizeof(ScheduleFormat::Line));
+    header.trips_offset = place(trips_section.size() * sizeof(ScheduleFormat::Trip));
+    header.patterns_offset = place(patterns.size() * sizeof(ScheduleFormat::Pattern));
+    header.stops_offset = place(stops.size() * sizeof(ScheduleFormat::Stop));
+    header.stations_offset = place(stations_section.size() * sizeof(ScheduleFormat::Station));
+    header.string_heap_offset = place(heap.size());
+
+    std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("Failed to open output file: " + file_path);
+    }
+
+    write_padded(out, &header, sizeof(header));
+    write_padded(out, lines_section.data(), lines_section.size() * sizeof(ScheduleFormat::Line));
+    write_padded(out, trips_section.data(), trips_section.size() * sizeof(ScheduleFormat::Trip));
+    write_padded(out, patterns.data(), patterns.size() * sizeof(ScheduleFormat::Pattern));
+    write_padded(out, stops.data(), stops.size() * sizeof(ScheduleFormat::Stop));
+    write_padded(out, stations_section.data(), stations_section.size() * sizeof(ScheduleFormat::Station));
+    write_padded(out, heap.data(), heap.size());
+
+    out.flush();
+    if (!out)
+    {
+        throw std::runtime_error("Failed to write schedule file: " + file_path);
+    }
+}
+
+ScheduleFormat::StringRef ScheduleWriter::store(std::string_view sv)
+{
+    std::uint32_t id{heap_strings.intern(sv)};
+    if (id == heap_offsets.size())
+    {
+        heap_offsets.push_back(static_cast<std::uint32_t>(heap.size()));
+        heap.append(sv);
+    }
+    return ScheduleFormat::StringRef{heap_offsets[id], static_cast<std::uint32_t>(sv.size())};
+}
+
+std::string_view ScheduleWriter::resolve(const ScheduleFormat::StringRef &ref) const
+{
+    return std::string_view(heap).substr(ref.offset, ref.length);
+}
+
+ScheduleWriter::Line &ScheduleWriter::line_for(std::string line_name)
+{
+    auto it{lines.find(line_name)};
+    if (it == lines.end())
+    {
+        ScheduleFormat::StringRef name_ref{store(line_name)};
+        it = lines.emplace(std::move(line_name), Line{name_ref}).first;
+    }
+    return it->second;
+}
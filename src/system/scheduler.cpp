@@ -5,35 +5,110 @@
 
 #include <string>
 #include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <unordered_set>
+#include <vector>
+#include <limits>
+#include <span>
+#include <tuple>
 
 #include "config.h"
 #include "constants/constants.h"
 #include "constants/railroad_constants.h"
 #include "enum/transit_types.h"
 #include "system/scheduler.h"
+#include "system/schedule_index.h"
+#include "utils/fingerprint.h"
+#include "utils/mapped_file.h"
 
-void Scheduler::write_schedule(const Transit::Map::Graph &graph, Registry &registry, const std::string &outfile_subfolder, Constants::System system_code)
+namespace
 {
-    using json = nlohmann::json;
+    /**
+     * routes.bin next to schedule.bin, the route index of every scheduled train so a cached schedule
+     * restores the same routes into the registry without being generated again
+     */
+    inline constexpr char ROUTE_CACHE_MAGIC[4]{'C', 'T', 'R', 'C'};
+    inline constexpr std::uint32_t ROUTE_CACHE_VERSION{1};
+
+    struct RouteCacheHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t fingerprint;   // of the scheduler inputs the schedule was generated from
+        std::uint64_t schedule_size; // bytes of the schedule.bin written with it
+        std::uint64_t route_count;
+    };
+
+    struct RouteCacheEntry
+    {
+        std::int64_t train_id;
+        std::uint32_t route; // index into the graph routes of the train line
+        std::uint32_t reserved;
+    };
 
-    json output{};
-    output["train_lines"] = json::object();
+    static_assert(sizeof(RouteCacheHeader) == 32);
+    static_assert(sizeof(RouteCacheEntry) == 16);
 
-    std::string file_path{std::string(SCHED_DIRECTORY) + "/" + outfile_subfolder + "/schedule.json"};
+    std::string timetable_file(Constants::System system_code)
+    {
+        std::string folder{};
+        switch (system_code)
+        {
+        case Constants::System::SUBWAY: folder = "subway"; break;
+        case Constants::System::METRO_NORTH: folder = "mnr"; break;
+        case Constants::System::LIRR: folder = "lirr"; break;
+        }
+
+        return std::string(DATA_DIRECTORY) + "/clean/" + folder + "/timetable.bin";
+    }
+}
+
+void Scheduler::write_schedule(const Transit::Map::Graph &graph, Registry &registry, const std::string &outfile_subfolder, Constants::System system_code, Utils::TaskExecutor *executor)
+{
+    std::string folder{std::string(SCHED_DIRECTORY) + "/" + outfile_subfolder};
+    std::string file_path{folder + "/schedule.bin"};
+    std::string routes_path{folder + "/routes.bin"};
+    std::string json_path{folder + "/schedule.json"};
 
     try
     {
-        process_system(output["train_lines"], graph, registry, system_code);
+        std::uint64_t inputs{fingerprint(graph, registry, system_code)};
 
-        std::ofstream outfile(file_path, std::ios::out | std::ios::trunc);
-        if (!outfile.is_open())
+        if constexpr (Constants::CACHE_SCHEDULE)
         {
-            throw std::runtime_error("Failed to open output file: " + file_path);
+            if (restore_routes(routes_path, file_path, inputs, graph, registry, system_code))
+            {
+                registry.freeze(system_code);
+
+                if constexpr (Constants::WRITE_SCHEDULE_JSON)
+                {
+                    if (!std::filesystem::exists(json_path))
+                    {
+                        ScheduleIndex{file_path}.write_json(json_path);
+                    }
+                }
+                return;
+            }
         }
 
-        outfile << output.dump(2);
-        outfile.flush();
-        outfile.close();
+        // a sidecar only describes the schedule it was written with, so it goes before the schedule is replaced
+        std::filesystem::remove(routes_path);
+
+        ScheduleWriter writer{system_code};
+        process_system(writer, graph, registry, system_code, executor);
+        writer.write(file_path);
+        write_routes(routes_path, file_path, inputs, graph, registry, system_code);
+
+        // routes are only written while scheduling, afterwards the system is read from every thread
+        registry.freeze(system_code);
+
+        if constexpr (Constants::WRITE_SCHEDULE_JSON)
+        {
+            ScheduleIndex{file_path}.write_json(json_path);
+        }
     }
     catch (const std::exception &e)
     {
@@ -41,127 +116,574 @@ void Scheduler::write_schedule(const Transit::Map::Graph &graph, Registry &regis
     }
 }
 
-void Scheduler::process_system(nlohmann::json &train_lines_json, const Transit::Map::Graph &graph, Registry &registry, Constants::System system_code)
+void Scheduler::process_system(ScheduleWriter &writer, const Transit::Map::Graph &graph, Registry &registry, Constants::System system_code, Utils::TaskExecutor *executor)
 {
-    using json = nlohmann::json;
+    if constexpr (Constants::SCHEDULE_FROM_TIMETABLE)
+    {
+        std::string timetable_path{timetable_file(system_code)};
+        if (std::filesystem::exists(timetable_path))
+        {
+            process_timetable(writer, graph, registry, system_code, Timetable{timetable_path});
+            return;
+        }
+    }
 
     const auto &train_registry{registry.get_train_registry(system_code)};
-    const auto &yard_registry{registry.get_yard_registry(system_code)};
 
-    const auto &routes_map{graph.get_routes()};
+    YardMap yard_map{build_yard_map(registry, system_code)};
+    RouteTable route_table{build_route_table(graph, system_code)};
 
-    // TO-DO: prepares trainline to yard pair mapping, consider this being default in registry
-    std::unordered_map<TrainLine, std::pair<int, int>> yard_map{};
-    for (const auto &yard_pair : yard_registry)
+    // lines keep the order of their first train in the registry so the merged schedule does not depend on thread timing
+    std::vector<std::vector<TrainId>> line_trains{};
+    std::unordered_map<TrainLine, std::size_t> line_index{};
+    for (TrainId train_id : train_registry)
     {
-        Info yard_info{registry.decode(yard_pair.first)};
-        yard_map[yard_info.train_line] = yard_pair;
+        auto [it, inserted]{line_index.try_emplace(registry.decode(train_id).train_line, line_trains.size())};
+        if (inserted)
+        {
+            line_trains.emplace_back();
+        }
+        line_trains[it->second].push_back(train_id);
     }
 
-    for (int i{0}; i < train_registry.size(); ++i)
+    // writers own an arena backed string pool and cannot be moved, so they are built in place
+    std::deque<ScheduleWriter> line_writers{};
+    for (std::size_t i{0}; i < line_trains.size(); ++i)
+    {
+        line_writers.emplace_back(system_code);
+    }
+
+    std::vector<std::vector<std::pair<TrainId, const Transit::Map::Route *>>> line_routes(line_trains.size());
+    std::vector<std::exception_ptr> line_errors(line_trains.size());
+
+    // lines are tasks of the caller's executor, without one they are scheduled on this thread
+    Utils::TaskGraph line_graph{};
+    for (std::size_t i{0}; i < line_trains.size(); ++i)
+    {
+        line_graph.add([&, i]()
+                       {
+            try
+            {
+                process_line(line_writers[i], line_routes[i], graph, registry, route_table, yard_map, line_trains[i]);
+            }
+            catch (...)
+            {
+                line_errors[i] = std::current_exception();
+            } });
+    }
+
+    if (executor != nullptr)
+    {
+        executor->run(line_graph);
+    }
+    else
+    {
+        Utils::TaskExecutor{1}.run(line_graph);
+    }
+
+    for (std::size_t i{0}; i < line_trains.size(); ++i)
+    {
+        if (line_errors[i])
+        {
+            std::rethrow_exception(line_errors[i]);
+        }
+
+        writer.append(line_writers[i]);
+
+        // routes are registered in line order so the registry does not depend on which task finished first
+        for (const auto &[train_id, route] : line_routes[i])
+        {
+            registry.register_route(train_id, *route);
+        }
+    }
+}
+
+void Scheduler::process_line(ScheduleWriter &writer, std::vector<std::pair<TrainId, const Transit::Map::Route *>> &assigned_routes, const Transit::Map::Graph &graph, const Registry &registry, const RouteTable &route_table, const YardMap &yard_map, const std::vector<TrainId> &train_ids)
+{
+    if constexpr (Constants::SCHEDULE_SERVICE_DAY)
+    {
+        plan_service_day(writer, assigned_routes, graph, registry, route_table, yard_map, train_ids);
+        return;
+    }
+
+    // trains of a route only differ in their start, so each route builds its stopping pattern once
+    std::unordered_map<const Transit::Map::Route *, std::uint32_t> route_patterns{};
+
+    for (TrainId train_id : train_ids)
     {
-        int train_id{train_registry[i]};
         Info train_info{registry.decode(train_id)};
 
-        auto yard_map_it{yard_map.find(train_info.train_line)};
-        if (yard_map_it == yard_map.end())
+        auto yards{find_yards(registry, yard_map, train_info)};
+        if (!yards.has_value())
         {
             continue;
         }
 
-        Info first_yard_info{registry.decode(yard_map_it->second.first)};   // uptown and manhattan
-        Info second_yard_info{registry.decode(yard_map_it->second.second)}; // downtown and away from manhattan
+        const auto &[origin_yard_info, destination_yard_info]{*yards};
 
-        Info origin_yard_info{};
-        Info destination_yard_info{};
+        auto table_it{route_table.find(train_info.train_line)};
+        std::size_t direction{static_cast<std::size_t>(std::visit([](const auto &d)
+                                                                  { return static_cast<int>(d); }, train_info.direction))};
+        if (table_it == route_table.end() || direction >= table_it->second.size())
+        {
+            continue;
+        }
 
-        if (directions_equal(train_info.direction, second_yard_info.direction))
+        const Transit::Map::Route *matching_route{table_it->second[direction][train_info.instance % 2]};
+        if (matching_route == nullptr)
         {
-            origin_yard_info = first_yard_info;
-            destination_yard_info = second_yard_info;
+            continue;
         }
-        else
+
+        assigned_routes.emplace_back(train_id, matching_route);
+
+        auto [pattern_it, inserted]{route_patterns.try_emplace(matching_route, 0)};
+        if (inserted)
         {
-            origin_yard_info = second_yard_info;
-            destination_yard_info = first_yard_info;
+            pattern_it->second = generate_stopping_pattern(writer, graph, *matching_route, origin_yard_info, destination_yard_info);
         }
 
-        auto routes_it{routes_map.find(train_info.train_line)};
-        if (routes_it == routes_map.end())
+        writer.add_trip(train_info.train_line, train_id, train_info.direction, matching_route->headsign, pattern_it->second, train_info.instance * Constants::DEFAULT_YARD_HEADWAY);
+    }
+}
+
+void Scheduler::plan_service_day(ScheduleWriter &writer, std::vector<std::pair<TrainId, const Transit::Map::Route *>> &assigned_routes, const Transit::Map::Graph &graph, const Registry &registry, const RouteTable &route_table, const YardMap &yard_map, const std::vector<TrainId> &train_ids)
+{
+    if (train_ids.empty())
+    {
+        return;
+    }
+
+    Info line_info{registry.decode(train_ids.front())};
+    auto directions{Constants::get_directions_by_system_code(line_info.system_code)};
+
+    auto table_it{route_table.find(line_info.train_line)};
+    if (table_it == route_table.end())
+    {
+        return;
+    }
+
+    // a side of the line runs from one yard to the other, with a stopping pattern for every route it alternates between
+    struct Variant
+    {
+        const Transit::Map::Route *route;
+        std::uint32_t pattern;
+    };
+
+    std::array<std::vector<Variant>, 2> variants{};
+    std::array<std::vector<int>, 2> run_ticks{};
+
+    for (int side{0}; side < 2; ++side)
+    {
+        Info side_info{line_info};
+        side_info.direction = directions[side];
+
+        auto yards{find_yards(registry, yard_map, side_info)};
+        if (!yards.has_value())
         {
             continue;
         }
 
-        const Transit::Map::Route *matching_route{nullptr};
-        for (const auto &route : routes_it->second)
+        const auto &[origin_yard_info, destination_yard_info]{*yards};
+        std::size_t direction{static_cast<std::size_t>(std::visit([](const auto &d)
+                                                                  { return static_cast<int>(d); }, directions[side]))};
+
+        for (const Transit::Map::Route *route : table_it->second[direction])
+        {
+            if (route == nullptr || std::ranges::any_of(variants[side], [route](const Variant &v)
+                                                        { return v.route == route; }))
+            {
+                continue;
+            }
+
+            std::uint32_t pattern{generate_stopping_pattern(writer, graph, *route, origin_yard_info, destination_yard_info)};
+            variants[side].push_back(Variant{route, pattern});
+            run_ticks[side].push_back(writer.get_stops(pattern).back().arrival_tick);
+        }
+    }
+
+    std::vector<std::pair<TrainId, int>> fleet{};
+    fleet.reserve(train_ids.size());
+    for (TrainId train_id : train_ids)
+    {
+        int side{directions_equal(registry.decode(train_id).direction, directions[0]) ? 0 : 1};
+        fleet.emplace_back(train_id, side);
+    }
+
+    std::unordered_set<TrainId> routed_trains{};
+    for (const auto &run : ServicePlanner::plan(ServiceProfile::default_for(line_info.system_code), run_ticks, fleet))
+    {
+        const Variant &variant{variants[run.side][run.variant]};
+        writer.add_trip(line_info.train_line, run.train_id, directions[run.side], variant.route->headsign, variant.pattern, run.start_tick);
+
+        // trains are built on the route of their first run, dispatch loads the route of every later run as the train spawns
+        if (routed_trains.insert(run.train_id).second)
         {
-            if (directions_equal(route.direction, train_info.direction))
+            assigned_routes.emplace_back(run.train_id, variant.route);
+        }
+    }
+}
+
+Scheduler::RouteTable Scheduler::build_route_table(const Transit::Map::Graph &graph, Constants::System system_code)
+{
+    RouteTable route_table{};
+    for (const auto &[train_line, routes] : graph.get_routes())
+    {
+        auto &line_table{route_table[train_line]};
+        for (std::size_t parity{0}; parity < 2; ++parity)
+        {
+            // a train takes the first route of its direction
+            for (const auto &route : routes)
             {
+                std::size_t direction{static_cast<std::size_t>(std::visit([](const auto &d)
+                                                                          { return static_cast<int>(d); }, route.direction))};
+                if (direction >= line_table.size() || line_table[direction][parity] != nullptr)
+                {
+                    continue;
+                }
+
                 // alternate penn station and grand central terminal in routes if applicable
-                if (system_code == Constants::System::LIRR)
+                if (system_code == Constants::System::LIRR && (route.headsign == "Penn Station" || route.headsign == "Grand Central") &&
+                    route.headsign != ((parity == 0) ? "Grand Central" : "Penn Station"))
                 {
-                    const std::string &headsign{route.headsign};
-                    if (headsign == "Penn Station" || headsign == "Grand Central")
-                    {
-                        if (headsign != ((train_info.instance % 2 == 0) ? "Grand Central" : "Penn Station"))
-                        {
-                            continue;
-                        }
+                    continue;
+                }
 
-                        matching_route = &route;
-                        break;
-                    }
-                    else
+                line_table[direction][parity] = &route;
+            }
+        }
+    }
+
+    return route_table;
+}
+
+std::unordered_map<TrainLine, std::pair<int, int>> Scheduler::build_yard_map(const Registry &registry, Constants::System system_code)
+{
+    // TO-DO: prepares trainline to yard pair mapping, consider this being default in registry
+    std::unordered_map<TrainLine, std::pair<int, int>> yard_map{};
+    for (const auto &yard_pair : registry.get_yard_registry(system_code))
+    {
+        Info yard_info{registry.decode(yard_pair.first)};
+        yard_map[yard_info.train_line] = yard_pair;
+    }
+
+    return yard_map;
+}
+
+std::optional<std::pair<Info, Info>> Scheduler::find_yards(const Registry &registry, const std::unordered_map<TrainLine, std::pair<int, int>> &yard_map, const Info &train_info)
+{
+    auto yard_map_it{yard_map.find(train_info.train_line)};
+    if (yard_map_it == yard_map.end())
+    {
+        return std::nullopt;
+    }
+
+    Info first_yard_info{registry.decode(yard_map_it->second.first)};   // uptown and manhattan
+    Info second_yard_info{registry.decode(yard_map_it->second.second)}; // downtown and away from manhattan
+
+    if (directions_equal(train_info.direction, second_yard_info.direction))
+    {
+        return std::make_pair(first_yard_info, second_yard_info);
+    }
+    else
+    {
+        return std::make_pair(second_yard_info, first_yard_info);
+    }
+}
+
+void Scheduler::process_timetable(ScheduleWriter &writer, const Transit::Map::Graph &graph, Registry &registry, Constants::System system_code, const Timetable &timetable)
+{
+    const auto &routes_map{graph.get_routes()};
+    std::unordered_map<TrainLine, std::pair<int, int>> yard_map{build_yard_map(registry, system_code)};
+
+    // subway timetables name stops by gtfs id, the railroads by the stop id that is also the node id
+    std::unordered_map<std::string, int> code_to_node{};
+    for (const auto &[train_line, routes] : routes_map)
+    {
+        for (const auto &route : routes)
+        {
+            for (int node_id : route.sequence)
+            {
+                const Transit::Map::Node *node{graph.get_node(node_id)};
+                if (node == nullptr)
+                {
+                    continue;
+                }
+
+                if (system_code == Constants::System::SUBWAY)
+                {
+                    for (const auto &code : node->codes)
                     {
-                        matching_route = &route;
-                        break;
+                        code_to_node.emplace(code, node_id);
                     }
                 }
                 else
                 {
-                    matching_route = &route;
-                    break;
+                    code_to_node.emplace(std::to_string(node_id), node_id);
                 }
             }
         }
+    }
 
-        if (matching_route == nullptr)
+    std::vector<int> stop_to_node(timetable.stop_count(), -1);
+    for (std::uint32_t stop{0}; stop < timetable.stop_count(); ++stop)
+    {
+        auto it{code_to_node.find(std::string(timetable.stop_code(stop)))};
+        if (it != code_to_node.end())
+        {
+            stop_to_node[stop] = it->second;
+        }
+    }
+
+    struct Candidate
+    {
+        int start_time;
+        const TimetableFormat::Trip *trip;
+        const Transit::Map::Route *route;
+    };
+
+    std::unordered_map<TrainLine, std::vector<Candidate>> candidates{};
+    std::vector<Timetable::StopTime> stop_times{};
+
+    // a trip runs on the graph route that visits its first and last stops in order and covers most of its stops
+    for (std::uint32_t r{0}; r < timetable.route_count(); ++r)
+    {
+        TrainLine train_line{trainline_from_string(std::string(timetable.route_name(r)))};
+        auto routes_it{routes_map.find(train_line)};
+        if (routes_it == routes_map.end())
+        {
+            continue;
+        }
+
+        std::vector<std::unordered_map<int, int>> positions{};
+        for (const auto &route : routes_it->second)
+        {
+            auto &position{positions.emplace_back()};
+            for (std::size_t i{0}; i < route.sequence.size(); ++i)
+            {
+                position.emplace(route.sequence[i], static_cast<int>(i));
+            }
+        }
+
+        for (const auto &trip : timetable.trips(r))
+        {
+            timetable.decode(trip, stop_times);
+
+            const Transit::Map::Route *best_route{nullptr};
+            int best_coverage{0};
+
+            for (std::size_t k{0}; k < routes_it->second.size(); ++k)
+            {
+                auto first{positions[k].find(stop_to_node[stop_times.front().stop])};
+                auto last{positions[k].find(stop_to_node[stop_times.back().stop])};
+                if (first == positions[k].end() || last == positions[k].end() || first->second >= last->second)
+                {
+                    continue;
+                }
+
+                int coverage{static_cast<int>(std::count_if(stop_times.begin(), stop_times.end(), [&](const Timetable::StopTime &stop)
+                                                            { return positions[k].contains(stop_to_node[stop.stop]); }))};
+                if (coverage > best_coverage)
+                {
+                    best_coverage = coverage;
+                    best_route = &routes_it->second[k];
+                }
+            }
+
+            if (best_route != nullptr)
+            {
+                candidates[train_line].push_back(Candidate{trip.start_time, &trip, best_route});
+            }
+        }
+    }
+
+    struct ScheduledStop
+    {
+        int station_id;
+        std::string station_name;
+        int arrival_tick;
+        int departure_tick;
+    };
+
+    struct ScheduledTrain
+    {
+        TrainId train_id;
+        Info train_info;
+        std::string headsign;
+        std::vector<ScheduledStop> stops;
+    };
+
+    std::vector<ScheduledTrain> scheduled{};
+    int origin_tick{std::numeric_limits<int>::max()};
+
+    std::unordered_map<TrainLine, std::vector<Info>> trains_by_line{};
+    for (TrainId train_id : registry.get_train_registry(system_code))
+    {
+        Info train_info{registry.decode(train_id)};
+        trains_by_line[train_info.train_line].push_back(train_info);
+    }
+
+    for (auto &[train_line, trains] : trains_by_line)
+    {
+        auto candidates_it{candidates.find(train_line)};
+        if (candidates_it == candidates.end())
         {
             continue;
         }
 
-        // store chosen route to registry for continuity)
-        registry.register_route(train_id, *matching_route);
+        auto &line_candidates{candidates_it->second};
+        std::ranges::stable_sort(line_candidates, {}, &Candidate::start_time);
+        std::ranges::sort(trains, {}, &Info::instance);
+
+        // each train takes the earliest trip still open in its direction
+        std::vector<bool> taken(line_candidates.size(), false);
+
+        for (const Info &train_info : trains)
+        {
+            auto yards{find_yards(registry, yard_map, train_info)};
+            if (!yards.has_value())
+            {
+                continue;
+            }
+
+            const auto &[origin_yard_info, destination_yard_info]{*yards};
+
+            std::size_t c{0};
+            while (c < line_candidates.size() && (taken[c] || !directions_equal(line_candidates[c].route->direction, train_info.direction)))
+            {
+                ++c;
+            }
+
+            if (c == line_candidates.size())
+            {
+                continue;
+            }
 
-        json trains_json{};
-        trains_json["train_id"] = train_id;
-        trains_json["direction"] = direction_to_string(train_info.direction);
-        trains_json["headsign"] = matching_route->headsign;
-        trains_json["schedule"] = json::array();
+            taken[c] = true;
+            const Candidate &candidate{line_candidates[c]};
+            const Transit::Map::Route &route{*candidate.route};
 
-        generate_train_schedule(trains_json["schedule"], graph, *matching_route, train_info, origin_yard_info, destination_yard_info);
+            timetable.decode(*candidate.trip, stop_times);
 
-        std::string line_name{trainline_to_string(train_info.train_line)};
-        train_lines_json[line_name]["trains"].push_back(trains_json);
+            // planned ticks for every node of the route, stops the trip skips are passed at interpolated times
+            std::vector<std::optional<std::pair<int, int>>> node_ticks(route.sequence.size());
+            for (const auto &stop : stop_times)
+            {
+                auto it{std::ranges::find(route.sequence, stop_to_node[stop.stop])};
+                if (it != route.sequence.end())
+                {
+                    node_ticks[it - route.sequence.begin()] = std::make_pair(stop.arrival / Constants::TIMETABLE_SECONDS_PER_TICK, stop.departure / Constants::TIMETABLE_SECONDS_PER_TICK);
+                }
+            }
+
+            // interpolation steps backwards from the first served node, so these indices stay signed
+            int node_count{static_cast<int>(node_ticks.size())};
+            int first_served{static_cast<int>(std::ranges::find_if(node_ticks, [](const auto &t)
+                                                                   { return t.has_value(); }) -
+                                              node_ticks.begin())};
+            int previous{first_served};
+            for (int i{first_served + 1}; i < node_count; ++i)
+            {
+                if (!node_ticks[i].has_value())
+                {
+                    continue;
+                }
+
+                for (int j{previous + 1}; j < i; ++j)
+                {
+                    int from{node_ticks[previous]->second};
+                    int to{node_ticks[i]->first};
+                    int tick{from + (to - from) * (j - previous) / (i - previous)};
+                    node_ticks[j] = std::make_pair(tick, tick);
+                }
+                previous = i;
+            }
+
+            for (int i{first_served - 1}; i >= 0; --i)
+            {
+                int tick{node_ticks[i + 1]->first - Constants::DEFAULT_TRAVEL_TIME - Constants::DEFAULT_DWELL_TIME};
+                node_ticks[i] = std::make_pair(tick, tick + Constants::DEFAULT_DWELL_TIME);
+            }
+
+            for (int i{previous + 1}; i < node_count; ++i)
+            {
+                int tick{node_ticks[i - 1]->second + Constants::DEFAULT_TRAVEL_TIME};
+                node_ticks[i] = std::make_pair(tick, tick + Constants::DEFAULT_DWELL_TIME);
+            }
+
+            // ticks are coarser than timetable seconds, so stops closer than a tick apart are pushed back to keep time moving forward
+            for (std::size_t i{0}; i < node_ticks.size(); ++i)
+            {
+                auto &[arrival, departure]{*node_ticks[i]};
+                if (i > 0)
+                {
+                    arrival = std::max(arrival, node_ticks[i - 1]->second + 1);
+                }
+                departure = std::max(departure, arrival + 1);
+            }
+
+            TrainId train_id{train_info.id};
+            std::string headsign{timetable.headsign(*candidate.trip)};
+
+            ScheduledTrain &train{scheduled.emplace_back(ScheduledTrain{train_id, train_info, headsign.empty() ? route.headsign : headsign, {}})};
+
+            int yard_departure{node_ticks.front()->first - Constants::DEFAULT_TRAVEL_TIME};
+            train.stops.push_back(ScheduledStop{static_cast<int>(origin_yard_info.id), Utils::generate_yard_name(origin_yard_info), -1, yard_departure});
+            origin_tick = std::min(origin_tick, yard_departure);
+
+            for (std::size_t i{0}; i < route.sequence.size(); ++i)
+            {
+                const Transit::Map::Node *node{graph.get_node(route.sequence[i])};
+                if (!node)
+                {
+                    continue;
+                }
+
+                train.stops.push_back(ScheduledStop{node->id, node->name, node_ticks[i]->first, node_ticks[i]->second});
+            }
+
+            train.stops.push_back(ScheduledStop{static_cast<int>(destination_yard_info.id), Utils::generate_yard_name(destination_yard_info), node_ticks.back()->second + Constants::DEFAULT_TRAVEL_TIME, -1});
+
+            // store chosen route to registry for continuity
+            registry.register_route(train_id, route);
+        }
+    }
+
+    // the earliest yard departure of the system becomes tick 0
+    std::vector<ScheduleFormat::Stop> pattern_stops{};
+    for (const auto &train : scheduled)
+    {
+        // the origin yard departure starts the trip, every other tick is relative to it
+        int start_tick{train.stops.front().departure_tick};
+
+        pattern_stops.clear();
+        for (const auto &stop : train.stops)
+        {
+            writer.add_station(stop.station_id, stop.station_name);
+            pattern_stops.push_back(ScheduleFormat::Stop{stop.station_id, stop.arrival_tick == -1 ? -1 : stop.arrival_tick - start_tick, stop.departure_tick == -1 ? -1 : stop.departure_tick - start_tick});
+        }
+
+        writer.add_trip(train.train_info.train_line, train.train_id, train.train_info.direction, train.headsign, writer.add_pattern(pattern_stops), start_tick - origin_tick);
     }
 }
 
-void Scheduler::generate_train_schedule(nlohmann::json &schedule_json, const Transit::Map::Graph &graph, const Transit::Map::Route &route, const Info &train_info, const Info &origin_yard_info, const Info &destination_yard_info)
+std::uint32_t Scheduler::generate_stopping_pattern(ScheduleWriter &writer, const Transit::Map::Graph &graph, const Transit::Map::Route &route, const Info &origin_yard_info, const Info &destination_yard_info)
 {
-    using json = nlohmann::json;
+    std::vector<ScheduleFormat::Stop> stops{};
+    stops.reserve(route.sequence.size() + 2);
 
-    int current_tick{train_info.instance * Constants::DEFAULT_YARD_HEADWAY};
+    // yard ids are instance 0 of the registry encoding and fit the int station ids
+    int origin_yard_id{static_cast<int>(origin_yard_info.id)};
+    int destination_yard_id{static_cast<int>(destination_yard_info.id)};
 
-    json origin{};
-    origin["station_id"] = origin_yard_info.id;
-    origin["station_name"] = Utils::generate_yard_name(origin_yard_info);
-    origin["arrival_tick"] = -1;
-    origin["departure_tick"] = current_tick;
-    schedule_json.push_back(origin);
+    int current_tick{0};
+
+    writer.add_station(origin_yard_id, Utils::generate_yard_name(origin_yard_info));
+    stops.push_back(ScheduleFormat::Stop{origin_yard_id, -1, current_tick});
 
     current_tick += Constants::DEFAULT_TRAVEL_TIME;
 
-    for (int i{0}; i < route.sequence.size(); ++i)
+    for (std::size_t i{0}; i < route.sequence.size(); ++i)
     {
         const Transit::Map::Node *node{graph.get_node(route.sequence[i])};
         if (!node)
@@ -169,14 +691,11 @@ void Scheduler::generate_train_schedule(nlohmann::json &schedule_json, const Tra
             continue;
         }
 
-        json stop;
-        stop["station_id"] = node->id;
-        stop["station_name"] = node->name;
-        stop["arrival_tick"] = current_tick;
-
+        int arrival_tick{current_tick};
         current_tick += Constants::DEFAULT_DWELL_TIME;
-        stop["departure_tick"] = current_tick;
-        schedule_json.push_back(stop);
+
+        writer.add_station(node->id, node->name);
+        stops.push_back(ScheduleFormat::Stop{node->id, arrival_tick, current_tick});
 
         if (i < route.distances.size())
         {
@@ -184,10 +703,232 @@ void Scheduler::generate_train_schedule(nlohmann::json &schedule_json, const Tra
         }
     }
 
-    json end{};
-    end["station_id"] = destination_yard_info.id;
-    end["station_name"] = Utils::generate_yard_name(destination_yard_info);
-    end["arrival_tick"] = current_tick;
-    end["departure_tick"] = -1;
-    schedule_json.push_back(end);
-}
\ No newline at end of file
+    writer.add_station(destination_yard_id, Utils::generate_yard_name(destination_yard_info));
+    stops.push_back(ScheduleFormat::Stop{destination_yard_id, current_tick, -1});
+
+    return writer.add_pattern(stops);
+}
+
+std::uint64_t Scheduler::fingerprint(const Transit::Map::Graph &graph, const Registry &registry, Constants::System system_code)
+{
+    Utils::Fingerprint fp{};
+    fp.add(ScheduleFormat::VERSION);
+    fp.add(system_code);
+
+    // constants read while scheduling
+    fp.add(Constants::DEFAULT_DWELL_TIME);
+    fp.add(Constants::DEFAULT_TRAVEL_TIME);
+    fp.add(Constants::DEFAULT_YARD_HEADWAY);
+    fp.add(Constants::SCHEDULE_FROM_TIMETABLE);
+    fp.add(Constants::TIMETABLE_SECONDS_PER_TICK);
+    fp.add(Constants::SCHEDULE_SERVICE_DAY);
+    fp.add(Constants::SERVICE_DAY_TICKS);
+    fp.add(Constants::DEFAULT_TURNAROUND_TIME);
+
+    // unordered containers are hashed in sorted order, so equal inputs give equal fingerprints across runs
+    auto add_lines = [&](const std::unordered_set<TrainLine> &train_lines)
+    {
+        std::vector<std::string> names{};
+        names.reserve(train_lines.size());
+        std::ranges::transform(train_lines, std::back_inserter(names), [](const TrainLine &line)
+                               { return trainline_to_string(line); });
+        std::ranges::sort(names);
+
+        fp.add(static_cast<std::uint64_t>(names.size()));
+        for (const auto &name : names)
+        {
+            fp.add(name);
+        }
+    };
+
+    const auto &adjacency_list{graph.get_adjacency_list()};
+    std::vector<int> node_ids{};
+    node_ids.reserve(adjacency_list.size());
+    std::ranges::transform(adjacency_list, std::back_inserter(node_ids), [](const auto &pair)
+                           { return pair.first; });
+    std::ranges::sort(node_ids);
+
+    for (int node_id : node_ids)
+    {
+        fp.add(node_id);
+        if (const Transit::Map::Node *node{graph.get_node(node_id)})
+        {
+            fp.add(node->name);
+            add_lines(node->train_lines);
+        }
+
+        std::vector<const Transit::Map::Edge *> edges{};
+        for (const auto &edge : adjacency_list.at(node_id))
+        {
+            edges.push_back(&edge);
+        }
+        std::ranges::sort(edges, {}, [](const Transit::Map::Edge *e)
+                          { return std::tie(e->to, e->weight); });
+
+        fp.add(static_cast<std::uint64_t>(edges.size()));
+        for (const Transit::Map::Edge *edge : edges)
+        {
+            fp.add(edge->to);
+            fp.add(edge->weight);
+            add_lines(edge->train_lines);
+        }
+    }
+
+    std::vector<std::pair<std::string, const std::vector<Transit::Map::Route> *>> line_routes{};
+    for (const auto &[train_line, routes] : graph.get_routes())
+    {
+        line_routes.emplace_back(trainline_to_string(train_line), &routes);
+    }
+    std::ranges::sort(line_routes, {}, &std::pair<std::string, const std::vector<Transit::Map::Route> *>::first);
+
+    for (const auto &[name, routes] : line_routes)
+    {
+        fp.add(name);
+        fp.add(static_cast<std::uint64_t>(routes->size()));
+        for (const auto &route : *routes)
+        {
+            fp.add(route.headsign);
+            fp.add(std::visit([](const auto &d)
+                              { return static_cast<int>(d); }, route.direction));
+            fp.add(static_cast<std::uint64_t>(route.sequence.size()));
+            fp.add_bytes(route.sequence.data(), route.sequence.size() * sizeof(int));
+            fp.add(static_cast<std::uint64_t>(route.distances.size()));
+            fp.add_bytes(route.distances.data(), route.distances.size() * sizeof(int));
+        }
+    }
+
+    // fleet sizes are carried by the train ids
+    const auto &train_registry{registry.get_train_registry(system_code)};
+    fp.add(static_cast<std::uint64_t>(train_registry.size()));
+    fp.add_bytes(train_registry.data(), train_registry.size() * sizeof(TrainId));
+
+    for (const auto &[from, to] : registry.get_yard_registry(system_code))
+    {
+        fp.add(from);
+        fp.add(to);
+    }
+
+    // headways the service day is planned from
+    ServiceProfile profile{ServiceProfile::default_for(system_code)};
+    fp.add(static_cast<std::uint64_t>(profile.periods.size()));
+    for (const auto &period : profile.periods)
+    {
+        fp.add(period.start_tick);
+        fp.add(period.headway);
+    }
+    fp.add(profile.end_tick);
+    fp.add(profile.turnaround);
+
+    if constexpr (Constants::SCHEDULE_FROM_TIMETABLE)
+    {
+        std::string timetable_path{timetable_file(system_code)};
+        fp.add(std::filesystem::exists(timetable_path));
+        if (std::filesystem::exists(timetable_path))
+        {
+            Utils::MappedFile timetable{timetable_path};
+            fp.add_bytes(timetable.data(), timetable.size());
+        }
+    }
+
+    return fp.value();
+}
+
+bool Scheduler::restore_routes(const std::string &routes_path, const std::string &schedule_path, std::uint64_t inputs, const Transit::Map::Graph &graph, Registry &registry, Constants::System system_code)
+{
+    if (!std::filesystem::exists(routes_path) || !std::filesystem::exists(schedule_path))
+    {
+        return false;
+    }
+
+    try
+    {
+        Utils::MappedFile file{routes_path};
+        if (file.size() < sizeof(RouteCacheHeader))
+        {
+            return false;
+        }
+
+        // mappings are page aligned, so the header and the entries after it are well aligned
+        const auto *header{reinterpret_cast<const RouteCacheHeader *>(file.data())};
+        if (!std::equal(std::begin(ROUTE_CACHE_MAGIC), std::end(ROUTE_CACHE_MAGIC), header->magic) || header->version != ROUTE_CACHE_VERSION ||
+            header->fingerprint != inputs || header->schedule_size != std::filesystem::file_size(schedule_path) ||
+            header->route_count != (file.size() - sizeof(RouteCacheHeader)) / sizeof(RouteCacheEntry))
+        {
+            return false;
+        }
+
+        ScheduleIndex index{schedule_path};
+        if (index.get_system_code() != system_code)
+        {
+            return false;
+        }
+
+        std::span<const RouteCacheEntry> entries(reinterpret_cast<const RouteCacheEntry *>(file.data() + sizeof(RouteCacheHeader)), static_cast<std::size_t>(header->route_count));
+        const auto &routes_map{graph.get_routes()};
+
+        // every entry is resolved before the first is registered, so a damaged sidecar leaves the registry untouched
+        std::vector<std::pair<TrainId, const Transit::Map::Route *>> routes{};
+        routes.reserve(entries.size());
+        for (const auto &entry : entries)
+        {
+            Info train_info{registry.decode(entry.train_id)};
+            auto it{routes_map.find(train_info.train_line)};
+            if (train_info.system_code != system_code || it == routes_map.end() || entry.route >= it->second.size())
+            {
+                return false;
+            }
+            routes.emplace_back(entry.train_id, &it->second[entry.route]);
+        }
+
+        for (const auto &[train_id, route] : routes)
+        {
+            registry.register_route(train_id, *route);
+        }
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void Scheduler::write_routes(const std::string &routes_path, const std::string &schedule_path, std::uint64_t inputs, const Transit::Map::Graph &graph, const Registry &registry, Constants::System system_code)
+{
+    const auto &routes_map{graph.get_routes()};
+
+    std::vector<RouteCacheEntry> entries{};
+    for (TrainId train_id : registry.get_train_registry(system_code))
+    {
+        auto route{registry.get_registered_route(train_id)};
+        if (!route.has_value())
+        {
+            continue;
+        }
+
+        const auto &routes{routes_map.at(registry.decode(train_id).train_line)};
+        entries.push_back(RouteCacheEntry{train_id, static_cast<std::uint32_t>(&route->get() - routes.data()), 0});
+    }
+
+    RouteCacheHeader header{};
+    std::copy(std::begin(ROUTE_CACHE_MAGIC), std::end(ROUTE_CACHE_MAGIC), header.magic);
+    header.version = ROUTE_CACHE_VERSION;
+    header.fingerprint = inputs;
+    header.schedule_size = std::filesystem::file_size(schedule_path);
+    header.route_count = entries.size();
+
+    std::ofstream out(routes_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("Failed to open output file: " + routes_path);
+    }
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(RouteCacheEntry)));
+
+    out.flush();
+    if (!out)
+    {
+        throw std::runtime_error("Failed to write route cache: " + routes_path);
+    }
+}
@@ -0,0 +1,94 @@
+/**
+ * for details on design, see:
+ * docs/system/service_planner.md
+ */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+#include "system/service_planner.h"
+
+int ServiceProfile::headway_at(int tick) const
+{
+    auto it{std::ranges::upper_bound(periods, tick, {}, &HeadwayPeriod::start_tick)};
+    return (it == periods.begin()) ? periods.front().headway : std::prev(it)->headway;
+}
+
+ServiceProfile ServiceProfile::default_for(Constants::System system_code)
+{
+    // overnight, early morning, morning peak, midday, evening peak, evening and late night
+    switch (system_code)
+    {
+    case Constants::System::SUBWAY:
+        return ServiceProfile{{{0, 20}, {360, 8}, {420, 4}, {600, 6}, {960, 4}, {1140, 8}, {1320, 12}}, Constants::SERVICE_DAY_TICKS, Constants::DEFAULT_TURNAROUND_TIME};
+    case Constants::System::METRO_NORTH:
+    case Constants::System::LIRR:
+        return ServiceProfile{{{0, 60}, {300, 30}, {360, 15}, {600, 30}, {960, 15}, {1140, 30}, {1320, 60}}, Constants::SERVICE_DAY_TICKS, Constants::DEFAULT_TURNAROUND_TIME};
+    }
+
+    throw std::runtime_error("Unknown system encountered when building a service profile");
+}
+
+std::vector<ServicePlanner::Run> ServicePlanner::plan(const ServiceProfile &profile, const std::array<std::vector<int>, 2> &run_ticks, const std::vector<std::pair<TrainId, int>> &fleet)
+{
+    if (profile.periods.empty() || std::ranges::any_of(profile.periods, [](const HeadwayPeriod &p)
+                                                       { return p.headway <= 0; }))
+    {
+        throw std::invalid_argument("Service profile needs positive headways");
+    }
+
+    // trains waiting in each yard, the earliest ready train leaves first and ties go to the lower id
+    using Waiting = std::pair<int /* ready tick */, TrainId>;
+    std::array<std::priority_queue<Waiting, std::vector<Waiting>, std::greater<>>, 2> yards{};
+    for (const auto &[train_id, side] : fleet)
+    {
+        if (side != 0 && side != 1)
+        {
+            throw std::invalid_argument("Train " + std::to_string(train_id) + " starts from an unknown yard side");
+        }
+        yards[side].emplace(0, train_id);
+    }
+
+    std::array<int, 2> planned{};
+    std::array<int, 2> departures{};
+    for (int side{0}; side < 2; ++side)
+    {
+        planned[side] = run_ticks[side].empty() ? profile.end_tick : profile.periods.front().start_tick;
+    }
+
+    std::vector<Run> runs{};
+
+    while (true)
+    {
+        int side{(planned[0] <= planned[1]) ? 0 : 1};
+        int tick{planned[side]};
+        if (tick >= profile.end_tick)
+        {
+            break;
+        }
+
+        int headway{profile.headway_at(tick)};
+        planned[side] += headway;
+
+        // a train may leave late within its slot, a slot no train can reach in time is dropped
+        auto &yard{yards[side]};
+        if (yard.empty() || yard.top().first >= tick + headway)
+        {
+            continue;
+        }
+
+        auto [ready_tick, train_id]{yard.top()};
+        yard.pop();
+
+        int start_tick{std::max(tick, ready_tick)};
+        int variant{departures[side]++ % static_cast<int>(run_ticks[side].size())};
+
+        runs.push_back(Run{train_id, side, variant, start_tick});
+        yards[1 - side].emplace(start_tick + run_ticks[side][variant] + profile.turnaround, train_id);
+    }
+
+    return runs;
+}
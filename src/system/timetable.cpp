@@ -0,0 +1,146 @@
+/**
+ * for details on design, see:
+ * docs/system/timetable.md
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "system/timetable.h"
+
+Timetable::Timetable(const std::string &file_path) : file(file_path)
+{
+    if (file.size() < sizeof(TimetableFormat::Header))
+    {
+        throw std::runtime_error("Timetable is truncated: " + file_path);
+    }
+
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (!std::equal(std::begin(TimetableFormat::MAGIC), std::end(TimetableFormat::MAGIC), header.magic))
+    {
+        throw std::runtime_error("Not a timetable file: " + file_path);
+    }
+
+    if (header.version != TimetableFormat::VERSION)
+    {
+        throw std::runtime_error("Unsupported timetable version " + std::to_string(header.version) + ": " + file_path);
+    }
+
+    routes_section = section<TimetableFormat::Route>(header.routes_offset, header.route_count, "routes");
+    stops_section = section<TimetableFormat::StringRef>(header.stops_offset, header.stop_count, "stops");
+    trips_section = section<TimetableFormat::Trip>(header.trips_offset, header.trip_count, "trips");
+    stop_index_section = section<std::uint32_t>(header.stop_index_offset, header.stop_time_count, "stop index");
+    arrival_delta_section = section<std::uint16_t>(header.arrival_delta_offset, header.stop_time_count, "arrival deltas");
+    dwell_section = section<std::uint16_t>(header.dwell_offset, header.stop_time_count, "dwells");
+
+    auto heap{section<char>(header.string_heap_offset, header.string_heap_size, "string heap")};
+    string_heap = std::string_view(heap.data(), heap.size());
+
+    validate();
+}
+
+std::size_t Timetable::route_count() const
+{
+    return routes_section.size();
+}
+
+std::string_view Timetable::route_name(std::uint32_t route) const
+{
+    return resolve(routes_section[route].name);
+}
+
+std::span<const TimetableFormat::Trip> Timetable::trips(std::uint32_t route) const
+{
+    const TimetableFormat::Route &entry{routes_section[route]};
+    return trips_section.subspan(entry.first_trip, entry.trip_count);
+}
+
+std::size_t Timetable::trip_count() const
+{
+    return trips_section.size();
+}
+
+std::string_view Timetable::headsign(const TimetableFormat::Trip &trip) const
+{
+    return resolve(trip.headsign);
+}
+
+std::size_t Timetable::stop_count() const
+{
+    return stops_section.size();
+}
+
+std::string_view Timetable::stop_code(std::uint32_t stop) const
+{
+    return resolve(stops_section[stop]);
+}
+
+void Timetable::decode(const TimetableFormat::Trip &trip, std::vector<StopTime> &out) const
+{
+    out.clear();
+    out.reserve(trip.stop_time_count);
+
+    int previous_departure{trip.start_time};
+    for (std::uint32_t i{trip.first_stop_time}; i < trip.first_stop_time + trip.stop_time_count; ++i)
+    {
+        int arrival{previous_departure + arrival_delta_section[i]};
+        int departure{arrival + dwell_section[i]};
+
+        out.push_back(StopTime{stop_index_section[i], arrival, departure});
+        previous_departure = departure;
+    }
+}
+
+template <typename T>
+std::span<const T> Timetable::section(std::uint64_t offset, std::uint64_t count, const std::string &name) const
+{
+    if (offset % alignof(T) != 0 || offset > file.size() || count > (file.size() - offset) / sizeof(T))
+    {
+        throw std::runtime_error("Timetable " + name + " section is out of bounds");
+    }
+
+    // mappings are page aligned and sections are written on ALIGNMENT boundaries, so the cast is well aligned
+    return std::span<const T>(reinterpret_cast<const T *>(file.data() + offset), static_cast<std::size_t>(count));
+}
+
+std::string_view Timetable::resolve(const TimetableFormat::StringRef &ref) const
+{
+    return string_heap.substr(ref.offset, ref.length);
+}
+
+void Timetable::validate() const
+{
+    auto valid_ref = [&](const TimetableFormat::StringRef &ref)
+    {
+        return ref.offset <= string_heap.size() && ref.length <= string_heap.size() - ref.offset;
+    };
+
+    for (const auto &route : routes_section)
+    {
+        if (!valid_ref(route.name) || route.first_trip > trips_section.size() || route.trip_count > trips_section.size() - route.first_trip)
+        {
+            throw std::runtime_error("Timetable route entry is out of bounds");
+        }
+    }
+
+    if (!std::all_of(stops_section.begin(), stops_section.end(), valid_ref))
+    {
+        throw std::runtime_error("Timetable stop code is out of bounds");
+    }
+
+    for (const auto &trip : trips_section)
+    {
+        if (!valid_ref(trip.headsign) || trip.route >= routes_section.size() || trip.first_stop_time > stop_index_section.size() || trip.stop_time_count > stop_index_section.size() - trip.first_stop_time)
+        {
+            throw std::runtime_error("Timetable trip entry is out of bounds");
+        }
+    }
+
+    if (!std::all_of(stop_index_section.begin(), stop_index_section.end(), [&](std::uint32_t stop)
+                     { return stop < stops_section.size(); }))
+    {
+        throw std::runtime_error("Timetable stop index is out of bounds");
+    }
+}
@@ -9,6 +9,7 @@
 #include "map/metro_north.h"
 #include "core/dispatch.h"
 #include "system/central_logger.h"
+#include "system/scheduler.h"
 #include "core/agency_control.h"
 
 class AgencyControlTest : public ::testing::Test
@@ -35,6 +36,8 @@ protected:
         ASSERT_NE(it, Constants::SYSTEMS.end()) << "Invalid system code";
         name = it->first;
 
+        // trains are only built for routes the scheduler registered
+        Scheduler::write_schedule(mnr, registry, name, code);
         agency_control = std::make_unique<AgencyControl>(code, name, mnr, registry, central_logger);
         dispatch = agency_control->get_dispatch(train_line);
         ASSERT_NE(dispatch, nullptr);
@@ -78,10 +81,10 @@ protected:
             yard = to_outbound;
         }
 
-        std::optional<Platform *> platform_opt{yard->select_platform(direction, train_line)};
-        EXPECT_TRUE(platform_opt.has_value());
+        std::vector<Platform *> platforms{yard->select_platforms(direction, train_line)};
+        EXPECT_FALSE(platforms.empty());
 
-        Platform *platform{*platform_opt};
+        Platform *platform{platforms.front()};
         EXPECT_NE(platform, nullptr);
         train->spawn(platform);
 
@@ -189,4 +192,27 @@ TEST_F(AgencyControlTest, HandlesSwitchRequestAndResolveForCollisions)
     EXPECT_EQ(granted_links.size(), 1) << "only one train should be granted the switch";
     EXPECT_EQ(granted_links.front().first, train_1);
     EXPECT_EQ(granted_links.front().second, to_1);
-}
\ No newline at end of file
+}
+
+TEST_F(AgencyControlTest, RestartsTheRepairOfASignalFailedAgainByAnotherLine)
+{
+    const auto &platforms{to_outbound->get_platforms()};
+    auto platform{std::ranges::find_if(platforms, [](const Platform *p)
+                                       { return p->get_signal() != nullptr; })};
+    ASSERT_NE(platform, platforms.end());
+    Signal *signal{(*platform)->get_signal()};
+
+    TimingWheel &timers{agency_control->get_timers()};
+    std::size_t pending{timers.size()};
+
+    agency_control->fail_signal(10, signal, 5, train_line);
+    agency_control->fail_signal(12, signal, 5, MNR::TrainLine::HARLEM);
+    EXPECT_EQ(timers.size(), pending + 1) << "a signal should have one pending repair whichever line failed it";
+
+    timers.advance(15);
+    EXPECT_FALSE(signal->is_functional()) << "the first repair should have been cancelled";
+
+    timers.advance(16);
+    EXPECT_TRUE(signal->is_functional());
+    EXPECT_EQ(timers.size(), pending);
+}
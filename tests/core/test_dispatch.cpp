@@ -3,6 +3,8 @@
 
 #include <ranges>
 #include <algorithm>
+#include <limits>
+#include <iterator>
 
 #include "utils/utils.h"
 #include "constants/constants.h"
@@ -63,7 +65,33 @@ TEST_F(DispatchTest, ConstructorInitializesCorrectly)
 TEST_F(DispatchTest, LoadsScheduleSuccessfully)
 {
     const auto &routes_map{mnr.get_routes()};
-    const auto &schedules{dispatch->get_station_schedules()};
+    const auto &train_schedules{dispatch->get_train_schedules()};
+    const auto &yard_departures{dispatch->get_yard_departures()};
+    ASSERT_EQ(train_schedules.size(), dispatch->get_trains().size());
+    EXPECT_TRUE(std::ranges::all_of(train_schedules, [](const TrainSchedule &entry)
+                                    { return entry.stops.empty(); }) &&
+                std::ranges::all_of(yard_departures, [](const auto &entry)
+                                    { return entry.second.empty(); }))
+        << "events should only be derived once their trip starts";
+
+    // release every trip by advancing past the last scheduled start
+    for (int tick{0}; tick <= Constants::DEFAULT_TRAINS_PER_LINE * Constants::DEFAULT_YARD_HEADWAY; ++tick)
+    {
+        dispatch->authorize(tick);
+    }
+
+    for (std::size_t i{0}; i < train_schedules.size(); ++i)
+    {
+        int last_tick{-1};
+        for (const Event &stop : train_schedules[i].stops)
+        {
+            EXPECT_GE(stop.tick, last_tick) << "stops of a train should be in the order it reaches them";
+            last_tick = stop.tick;
+            EXPECT_EQ(stop.train_id, dispatch->get_trains()[i]->get_id());
+            EXPECT_FALSE(stop.type == EventType::DEPARTURE && yard_departures.contains(stop.station_id))
+                << "departures from yards should only be kept with the yard";
+        }
+    }
 
     auto it{routes_map.find(train_line)};
     ASSERT_NE(it, routes_map.end());
@@ -77,27 +105,22 @@ TEST_F(DispatchTest, LoadsScheduleSuccessfully)
         const Transit::Map::Node *node{mnr.get_node(route.sequence[i])};
         ASSERT_NE(node, nullptr);
 
-        auto schedule_it{schedules.find(node->id)};
-        ASSERT_NE(schedule_it, schedules.end());
-
-        const auto &sched{schedule_it->second};
-        EXPECT_FALSE(sched.arrivals.empty()) << "arrivals should have events in the queue";
-        EXPECT_FALSE(sched.departures.empty()) << "departures should have events in the queue";
+        auto has_stop{[&](EventType type)
+                      { return std::ranges::any_of(train_schedules, [&](const TrainSchedule &entry)
+                                                   { return std::ranges::any_of(entry.stops, [&](const Event &stop)
+                                                                                { return stop.station_id == node->id && stop.type == type; }); }); }};
 
-        int last_tick{-1};
-        for (const auto &[tick, event] : sched.arrivals)
+        EXPECT_TRUE(has_stop(EventType::ARRIVAL)) << "arrivals should be scheduled at station " << node->id;
+        if (auto yard_it{yard_departures.find(node->id)}; yard_it != yard_departures.end())
         {
-            EXPECT_GT(tick, last_tick);
-            last_tick = tick;
-            EXPECT_EQ(event.station_id, node->id);
+            for (const auto &[tick, event] : yard_it->second)
+            {
+                EXPECT_EQ(event.station_id, node->id);
+            }
         }
-
-        last_tick = -1;
-        for (const auto &[tick, event] : sched.departures)
+        else
         {
-            EXPECT_GT(tick, last_tick);
-            last_tick = tick;
-            EXPECT_EQ(event.station_id, node->id);
+            EXPECT_TRUE(has_stop(EventType::DEPARTURE)) << "departures should be scheduled at station " << node->id;
         }
     }
 }
@@ -169,9 +192,10 @@ TEST_F(DispatchTest, ExecutesTrainMovementAccordingToAuthorizations)
     train->move_to_track(current);
     EXPECT_EQ(train->get_current_track(), current) << "train should have moved into track right before the track with a switch";
 
+    StateStore *state{train->get_state_store()};
     while (train->get_dwell() > 0)  // have to decrement dwell
     {
-        train->request_movement();
+        state->count_down_dwell(train->get_slot(), train->get_slot() + 1);
     }
 
     dispatch->authorize(tick);
@@ -185,4 +209,35 @@ TEST_F(DispatchTest, ExecutesTrainMovementAccordingToAuthorizations)
     
     dispatch->execute(tick);
     EXPECT_EQ(train->get_current_track(), next) << "agency control should authorize train and have it move into the track with a switch";
-}
\ No newline at end of file
+}
+TEST_F(DispatchTest, ReportsNextEventAfterCurrentTick)
+{
+    int tick{0};
+    for (int runs{0}; runs < 50; ++runs)
+    {
+        ac->run(tick);
+
+        int next{ac->next_event_tick()};
+        if (next == std::numeric_limits<int>::max())
+        {
+            break; // nothing left to run
+        }
+
+        ASSERT_GT(next, tick) << "Runs should always move forward in time";
+        EXPECT_LE(next, dispatch->next_event_tick(tick)) << "The system should wait for no later than each of its lines";
+
+        tick = next;
+    }
+}
+
+TEST_F(DispatchTest, KeepsOnlyTrainsInServiceActive)
+{
+    for (int tick{0}; tick < 200; ++tick)
+    {
+        ac->run(tick);
+
+        std::vector<Train *> in_service{};
+        std::ranges::copy_if(dispatch->get_trains(), std::back_inserter(in_service), &Train::is_active);
+        EXPECT_EQ(dispatch->get_active_trains(), in_service) << "Trains should join on spawn and leave on despawn, in slot order";
+    }
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "constants/constants.h"
+#include "map/metro_north.h"
+#include "system/factory.h"
+#include "system/registry.h"
+
+class LineTopologyTest : public ::testing::Test
+{
+protected:
+    Factory factory{};
+    Transit::Map::MetroNorth &graph{Transit::Map::MetroNorth::get_instance()};
+    Registry &registry{Registry::get_instance()};
+    MNR::TrainLine train_line{MNR::TrainLine::HUDSON};
+
+    void SetUp() override
+    {
+        factory.build_network(graph, registry, Constants::System::METRO_NORTH);
+    }
+};
+
+TEST_F(LineTopologyTest, MatchesTrackLookups)
+{
+    const LineTopology &topology{factory.get_topology(train_line)};
+
+    for (const Track *track : factory.get_tracks())
+    {
+        EXPECT_EQ(topology.get_next_track(track), track->get_next_track(train_line)) << "Track " << track->get_id();
+        EXPECT_EQ(topology.get_prev_track(track), track->get_prev_track(train_line)) << "Track " << track->get_id();
+    }
+}
+
+TEST_F(LineTopologyTest, MatchesStationPlatforms)
+{
+    const LineTopology &topology{factory.get_topology(train_line)};
+
+    for (const Station *station : factory.get_stations())
+    {
+        for (MNR::Direction direction : {MNR::Direction::INBOUND, MNR::Direction::OUTBOUND})
+        {
+            auto expected{station->select_platforms(direction, train_line)};
+            EXPECT_TRUE(std::ranges::equal(topology.get_platforms(station, direction), expected)) << "Station " << station->get_id();
+        }
+    }
+}
+
+TEST_F(LineTopologyTest, PrefersFreeSuccessor)
+{
+    std::unordered_set<TrainLine> lines{train_line};
+    Signal signal{0};
+    signal.change_state(SignalState::GREEN);
+
+    Track fork{0, &signal, 1, lines};
+    Track left{1, &signal, 1, lines};
+    Track right{2, &signal, 1, lines};
+    fork.add_next_track(&left);
+    fork.add_next_track(&right);
+
+    std::vector<Track *> tracks{&fork, &left, &right};
+    LineTopology topology{train_line, tracks, {}};
+    EXPECT_EQ(topology.get_next_track(&fork), &left);
+
+    Train train{1, "Test", train_line, ServiceType::BOTH, MNR::Direction::INBOUND, {}};
+    ASSERT_TRUE(left.accept_entry(&train));
+    EXPECT_EQ(topology.get_next_track(&fork), &right);
+
+    ASSERT_TRUE(right.accept_entry(&train));
+    EXPECT_EQ(topology.get_next_track(&fork), &right) << "Falls back to the last occupied successor";
+}
+
+TEST_F(LineTopologyTest, UnknownLineIsEmpty)
+{
+    const LineTopology &topology{factory.get_topology(SUB::TrainLine::A)};
+    for (const Track *track : factory.get_tracks())
+    {
+        EXPECT_TRUE(topology.get_next_tracks(track).empty());
+    }
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "core/signal.h"
+#include "core/signal_propagator.h"
+#include "core/track.h"
+#include "core/train.h"
+#include "system/central_logger.h"
+
+class SignalPropagatorTest : public testing::Test
+{
+protected:
+    MNR::TrainLine train_line{MNR::TrainLine::HUDSON};
+    StateStore state{};
+    std::vector<std::unique_ptr<Signal>> signals{};
+    std::vector<std::unique_ptr<Track>> chain{};
+    std::vector<Track *> tracks{};
+
+    std::string log_path{std::string(LOG_DIRECTORY) + "/signal_propagator_test.txt"};
+    std::unique_ptr<Logger> logger{};
+    std::unique_ptr<LineTopology> topology{};
+    std::vector<const LineTopology *> lines{};
+
+    Train train{1, "Test", train_line, ServiceType::BOTH, MNR::Direction::INBOUND, {}, &state};
+
+    // a straight chain of blocks 0 -> 1 -> 2 -> 3 -> 4
+    void SetUp() override
+    {
+        for (int i{0}; i < 5; ++i)
+        {
+            signals.push_back(std::make_unique<Signal>(i, &state));
+            chain.push_back(std::make_unique<Track>(i, signals.back().get(), 1, std::unordered_set<TrainLine>{train_line}, &state));
+            signals.back()->set_track(chain.back().get());
+            tracks.push_back(chain.back().get());
+        }
+        for (int i{1}; i < 5; ++i)
+        {
+            tracks[i - 1]->add_next_track(tracks[i]);
+            tracks[i]->add_prev_track(tracks[i - 1]);
+        }
+
+        logger = std::make_unique<Logger>(log_path, Constants::System::METRO_NORTH, CentralLogger::get_instance());
+        topology = std::make_unique<LineTopology>(train_line, tracks, std::span<Station *const>{});
+        lines.push_back(topology.get());
+    }
+
+    void TearDown() override
+    {
+        logger.reset();
+        std::filesystem::remove(log_path);
+    }
+
+    std::vector<SignalState> aspects() const
+    {
+        std::vector<SignalState> result{};
+        for (const auto &signal : signals)
+        {
+            result.push_back(signal->get_state());
+        }
+        return result;
+    }
+
+    int logged_lines() const
+    {
+        std::ifstream file{log_path};
+        int count{0};
+        for (std::string line; std::getline(file, line);)
+        {
+            ++count;
+        }
+        return count;
+    }
+};
+
+TEST_F(SignalPropagatorTest, InitializesWithoutLogging)
+{
+    SignalPropagator propagator{tracks, lines, logger.get()};
+    propagator.initialize(tracks);
+
+    EXPECT_EQ(aspects(), std::vector<SignalState>(5, SignalState::GREEN));
+    EXPECT_EQ(logged_lines(), 0);
+}
+
+TEST_F(SignalPropagatorTest, UpdatesTwoBlocksBehindAnOccupancyChange)
+{
+    SignalPropagator propagator{tracks, lines, logger.get()};
+    propagator.initialize(tracks);
+
+    ASSERT_TRUE(train.move_to_track(tracks[3]));
+    propagator.on_occupancy_change(0, tracks[3]);
+
+    using enum SignalState;
+    EXPECT_EQ(aspects(), (std::vector<SignalState>{GREEN, YELLOW, YELLOW, RED, GREEN}));
+    EXPECT_EQ(logged_lines(), 3);
+
+    ASSERT_TRUE(train.move_to_track(tracks[4]));
+    propagator.on_occupancy_change(1, tracks[3]);
+    propagator.on_occupancy_change(1, tracks[4]);
+
+    EXPECT_EQ(aspects(), (std::vector<SignalState>{GREEN, GREEN, YELLOW, YELLOW, RED}));
+    EXPECT_EQ(logged_lines(), 6) << "Only signals whose aspect changed are logged";
+}
+
+TEST_F(SignalPropagatorTest, SharedBlockShowsMostRestrictiveAspect)
+{
+    // a second line branches off block 2 through its own block 5, which is occupied
+    MNR::TrainLine other_line{MNR::TrainLine::HARLEM};
+    Signal branch_signal{5, &state};
+    Track branch{5, &branch_signal, 1, std::unordered_set<TrainLine>{other_line}, &state};
+    tracks[2]->add_train_line(other_line);
+    tracks[2]->add_next_track(&branch);
+    branch.add_prev_track(tracks[2]);
+
+    std::vector<Track *> all_tracks{tracks};
+    all_tracks.push_back(&branch);
+    LineTopology main_line{train_line, all_tracks, {}};
+    LineTopology branch_line{other_line, all_tracks, {}};
+    std::vector<const LineTopology *> both{&main_line, &branch_line};
+
+    SignalPropagator propagator{all_tracks, both, logger.get()};
+    propagator.initialize(all_tracks);
+    EXPECT_TRUE(signals[2]->is_green());
+
+    ASSERT_TRUE(train.move_to_track(&branch));
+    propagator.on_occupancy_change(0, &branch);
+    EXPECT_TRUE(branch_signal.is_red());
+    EXPECT_TRUE(signals[2]->is_yellow()) << "Occupied block ahead on the second line";
+    EXPECT_TRUE(signals[1]->is_green()) << "Block 1 only serves the first line";
+}
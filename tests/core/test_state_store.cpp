@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+
+#include "core/state_store.h"
+
+class StateStoreTest : public testing::Test
+{
+protected:
+    StateStore state{};
+};
+
+TEST_F(StateStoreTest, CountsDownDwellOfActiveTrains)
+{
+    std::size_t idle{state.add_train()};
+    std::size_t dwelling{state.add_train()};
+    std::size_t moving{state.add_train()};
+
+    state.status[dwelling] = TrainStatus::DEPARTING;
+    state.dwell_timer[dwelling] = 1;
+    state.status[moving] = TrainStatus::MOVING;
+
+    state.count_down_dwell(0, 3);
+    EXPECT_FALSE(state.ready[idle]);
+    EXPECT_FALSE(state.ready[dwelling]);
+    EXPECT_TRUE(state.ready[moving]);
+    EXPECT_EQ(state.dwell_timer[dwelling], 0);
+
+    state.count_down_dwell(0, 3);
+    EXPECT_TRUE(state.ready[dwelling]);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <utility>
+#include <vector>
+
+#include "core/timing_wheel.h"
+
+class TimingWheelTest : public testing::Test
+{
+protected:
+    TimingWheel wheel{};
+    std::vector<std::pair<int, int>> fired{}; // timer id, tick it fired at
+
+    TimingWheel::Handle add(int expire_tick, int id)
+    {
+        return wheel.schedule(expire_tick, [this, id](int tick)
+                              { fired.emplace_back(id, tick); });
+    }
+};
+
+TEST_F(TimingWheelTest, FiresTimersAtTheirTickInOrder)
+{
+    add(5, 1);
+    add(2, 2);
+    add(64, 3);   // first tick of the second level
+    add(5000, 4); // cascaded down through two levels
+
+    EXPECT_EQ(wheel.next_expiry(), 2);
+
+    wheel.advance(4);
+    EXPECT_THAT(fired, testing::ElementsAre(std::pair{2, 2}));
+    EXPECT_EQ(wheel.next_expiry(), 5);
+
+    wheel.advance(6000);
+    EXPECT_THAT(fired, testing::ElementsAre(std::pair{2, 2}, std::pair{1, 5}, std::pair{3, 64}, std::pair{4, 5000}));
+    EXPECT_EQ(wheel.size(), 0u);
+    EXPECT_EQ(wheel.next_expiry(), std::nullopt);
+    EXPECT_EQ(wheel.get_tick(), 6000);
+}
+
+TEST_F(TimingWheelTest, CancelledTimersNeverFire)
+{
+    TimingWheel::Handle cancelled{add(10, 1)};
+    add(10, 2);
+
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(cancelled)) << "A timer should only be cancelled once";
+
+    // the freed timer is reused, the stale handle must not cancel its successor
+    add(20, 3);
+    EXPECT_FALSE(wheel.cancel(cancelled));
+
+    wheel.advance(30);
+    EXPECT_THAT(fired, testing::ElementsAre(std::pair{2, 10}, std::pair{3, 20}));
+}
+
+TEST_F(TimingWheelTest, CallbacksCanScheduleAndCancel)
+{
+    TimingWheel::Handle later{};
+    wheel.schedule(3, [&](int tick)
+                   {
+                       fired.emplace_back(1, tick);
+                       wheel.cancel(later);
+                       add(tick, 4); // not in the past, fires on the next tick
+                   });
+    later = add(3, 2);
+    add(100, 3);
+
+    wheel.advance(200);
+    EXPECT_THAT(fired, testing::ElementsAre(std::pair{1, 3}, std::pair{4, 4}, std::pair{3, 100}));
+}
+
+TEST_F(TimingWheelTest, PastTimersFireOnTheNextAdvance)
+{
+    wheel.advance(50);
+    add(10, 1);
+
+    EXPECT_EQ(wheel.next_expiry(), 51);
+    wheel.advance(51);
+    EXPECT_THAT(fired, testing::ElementsAre(std::pair{1, 51}));
+}
@@ -2,6 +2,7 @@
 #include <gmock/gmock.h>
 
 #include "core/platform.h"
+#include "core/signal.h"
 #include "core/track.h"
 #include "core/train.h"
 
@@ -23,9 +24,11 @@ protected:
 
     std::unordered_set<TrainLine> train_lines{SUB::TrainLine::FOUR};
 
-    MockTrack mock_track{1, nullptr, 1, train_lines};
-    MockPlatform mock_platform{2, nullptr, nullptr, SUB::Direction::DOWNTOWN, 2, train_lines};
-    Train train{1, *train_lines.begin(), ServiceType::EXPRESS, SUB::Direction::DOWNTOWN};
+    Signal signal{1};
+    MockTrack mock_track{1, &signal, 1, train_lines};
+    MockPlatform mock_platform{2, &signal, nullptr, SUB::Direction::DOWNTOWN, 2, train_lines};
+    Station station{3, "Station", false, train_lines};
+    Train train{1, "Train Headsign", *train_lines.begin(), ServiceType::EXPRESS, SUB::Direction::DOWNTOWN, {&station}};
 };
 
 TEST_F(TrainTest, ConstructorInitializesCorrectly)
@@ -42,10 +45,8 @@ TEST_F(TrainTest, ConstructorInitializesCorrectly)
 
 TEST_F(TrainTest, HandlesHeadsign)
 {
-    std::string headsign{"Train Headsign"};
-    train.set_headsign(headsign);
-
-    EXPECT_EQ(train.get_headsign(), headsign);
+    EXPECT_EQ(train.get_headsign(), "Train Headsign");
+    EXPECT_EQ(train.get_destination(), &station);
 }
 
 TEST_F(TrainTest, HandlesDwell)
@@ -73,17 +74,23 @@ TEST_F(TrainTest, HandlesPunctuality)
     EXPECT_TRUE(train.is_late()) << "Train should be late if positive punctuality delta";
 }
 
-TEST_F(TrainTest, RequestsMovementAndHandlesDwellTimer)
+TEST_F(TrainTest, CountsDownDwellThroughItsStateStore)
 {
+    EXPECT_CALL(mock_platform, accept_entry(&train)).WillOnce(::testing::Return(true));
+    train.spawn(&mock_platform);
+
     int dwell{2};
     train.add_dwell(dwell);
 
+    StateStore *state{train.get_state_store()};
     while (train.get_dwell() > 0)
     {
-        EXPECT_FALSE(train.request_movement()) << "Train should not move when dwell timer is greater than 0";
+        state->count_down_dwell(train.get_slot(), train.get_slot() + 1);
+        EXPECT_FALSE(train.is_ready()) << "Train should not move when dwell timer is greater than 0";
     }
 
-    EXPECT_TRUE(train.request_movement()) << "Train should move once dwell timer is 0";
+    state->count_down_dwell(train.get_slot(), train.get_slot() + 1);
+    EXPECT_TRUE(train.is_ready()) << "Train should move once dwell timer is 0";
 }
 
 TEST_F(TrainTest, MovesToTrackSuccessfully)
@@ -129,4 +136,27 @@ TEST_F(TrainTest, DespawnsToNullptrIsOutOfService)
 
     train.despawn();
     EXPECT_FALSE(train.is_active());
-}
\ No newline at end of file
+}
+
+TEST_F(TrainTest, DespawnsInServiceToIdle)
+{
+    EXPECT_CALL(mock_platform, accept_entry(&train)).WillOnce(::testing::Return(true));
+    train.spawn(&mock_platform);
+
+    train.despawn(true);
+    EXPECT_TRUE(train.is_idle()) << "A train with runs left should be able to spawn again";
+}
+
+TEST_F(TrainTest, BeginsRunWithItsDirectionHeadsignAndRoute)
+{
+    Station yard{4, "Yard", true, train_lines};
+    train.begin_run(SUB::Direction::UPTOWN, "Woodlawn", {&station, &yard});
+
+    EXPECT_EQ(std::get<SUB::Direction>(train.get_direction()), SUB::Direction::UPTOWN);
+    EXPECT_EQ(train.get_headsign(), "Woodlawn");
+    EXPECT_EQ(train.get_destination(), &station);
+
+    EXPECT_CALL(mock_platform, accept_entry(&train)).WillOnce(::testing::Return(true));
+    train.move_to_track(&mock_platform);
+    EXPECT_EQ(train.get_destination(), &yard) << "A train should head for the yard after the last station of its run";
+}
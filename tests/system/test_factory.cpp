@@ -32,7 +32,7 @@ TEST_F(FactoryTest, CreatesTrainsSuccessfully)
 
     EXPECT_EQ(trains.size(), train_registry.size());
 
-    std::vector<int> train_ids{};
+    std::vector<TrainId> train_ids{};
     train_ids.reserve(trains.size());
     std::ranges::transform(trains, std::back_inserter(train_ids), [](const auto &train)
                            { return train->get_id(); });
@@ -77,7 +77,7 @@ TEST_F(RegistryTest, EncodesAndDecodesCorrectly)
     TrainLine train_line{static_cast<SUB::TrainLine>(train_line_code)};
     Direction direction{static_cast<SUB::Direction>(direction_code)};
 
-    int encoded_id{registry.encode(system_code, train_line_code, direction_code, instance)};
+    TrainId encoded_id{registry.encode(system_code, train_line_code, direction_code, instance)};
 
     auto decoded{registry.decode(encoded_id)};
 
@@ -85,4 +85,86 @@ TEST_F(RegistryTest, EncodesAndDecodesCorrectly)
     EXPECT_EQ(decoded.train_line, train_line);
     EXPECT_EQ(decoded.direction, direction);
     EXPECT_EQ(decoded.instance, instance);
-}
\ No newline at end of file
+}
+
+TEST_F(RegistryTest, EncodesInstancesBeyondEightBits)
+{
+    int instance{100000};
+    TrainId encoded_id{registry.encode(Constants::System::LIRR, 3, 1, instance)};
+
+    auto decoded{registry.decode(encoded_id)};
+    EXPECT_EQ(decoded.id, encoded_id);
+    EXPECT_EQ(decoded.instance, instance);
+    EXPECT_EQ(decoded.train_line, TrainLine{static_cast<LIRR::TrainLine>(3)});
+    EXPECT_EQ(decoded.direction, Direction{static_cast<LIRR::Direction>(1)});
+
+    for (const auto &[from_id, to_id] : registry.get_yard_registry(Constants::System::LIRR))
+    {
+        EXPECT_EQ(registry.decode(from_id).instance, 0) << "Yards should keep ids that fit an int";
+    }
+}
+
+TEST_F(RegistryTest, ReadsSingleFieldsOfAnId)
+{
+    TrainId encoded_id{registry.encode(Constants::System::LIRR, 3, 1, 100000)};
+
+    EXPECT_EQ(Registry::system_code_of(encoded_id), static_cast<int>(Constants::System::LIRR));
+    EXPECT_EQ(Registry::train_line_code_of(encoded_id), 3);
+    EXPECT_EQ(Registry::direction_code_of(encoded_id), 1);
+    EXPECT_EQ(Registry::instance_of(encoded_id), 100000);
+}
+
+TEST_F(RegistryTest, SetsFleetSizePerLine)
+{
+    // the shared instance may already be frozen by tests that scheduled the system
+    struct FreshRegistry : Registry
+    {
+        FreshRegistry() = default;
+    } registry{};
+
+    Constants::System system_code{Constants::System::METRO_NORTH};
+    ASSERT_FALSE(registry.is_frozen(system_code));
+
+    TrainLine train_line{MNR::TrainLine::HARLEM};
+    std::size_t default_count{registry.get_train_registry(system_code).size()};
+
+    EXPECT_EQ(registry.get_fleet_size(system_code, train_line), Constants::DEFAULT_TRAINS_PER_LINE);
+
+    registry.set_fleet_size(system_code, train_line, 601);
+    EXPECT_EQ(registry.get_fleet_size(system_code, train_line), 601);
+
+    const auto &trains{registry.get_train_registry(system_code)};
+    EXPECT_EQ(trains.size(), default_count - Constants::DEFAULT_TRAINS_PER_LINE + 601);
+
+    int harlem_trains{0};
+    int max_instance{0};
+    for (TrainId train_id : trains)
+    {
+        Info info{registry.decode(train_id)};
+        if (info.train_line == train_line)
+        {
+            ++harlem_trains;
+            max_instance = std::max(max_instance, info.instance);
+        }
+    }
+    EXPECT_EQ(harlem_trains, 601);
+    EXPECT_EQ(max_instance, 300) << "Trains should be split across directions with the extra train in the first";
+
+    EXPECT_THROW(registry.set_fleet_size(system_code, train_line, -1), std::invalid_argument);
+
+    registry.set_fleet_size(system_code, train_line, Constants::DEFAULT_TRAINS_PER_LINE);
+    EXPECT_EQ(registry.get_train_registry(system_code).size(), default_count);
+}
+
+TEST_F(RegistryTest, IgnoresUnknownTrainsInRouteRegistry)
+{
+    Constants::System system_code{Constants::System::SUBWAY};
+    int fleet_size{registry.get_fleet_size(system_code, SUB::TrainLine::A)};
+
+    TrainId unregistered{registry.encode(system_code, static_cast<int>(SUB::TrainLine::A), 0, fleet_size)};
+    EXPECT_FALSE(registry.get_registered_route(unregistered).has_value());
+    EXPECT_FALSE(registry.get_registered_route(-1).has_value());
+
+    Transit::Map::Route route{"Test", SUB::Direction::UPTOWN, {}, {}};
+    EXPECT_THROW(registry.register_route(unregistered, route), std::invalid_argument);
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <filesystem>
+#include <vector>
+
+#include "config.h"
+#include "system/schedule_index.h"
+#include "system/schedule_writer.h"
+
+class ScheduleIndexTest : public ::testing::Test
+{
+protected:
+    std::string test_directory{};
+    std::string file_path{};
+
+    void SetUp() override
+    {
+        test_directory = std::string(SCHED_DIRECTORY) + "/index_test";
+        std::filesystem::create_directories(test_directory);
+        file_path = test_directory + "/schedule.bin";
+
+        ScheduleWriter writer{Constants::System::METRO_NORTH};
+        writer.add_station(10, "A");
+        writer.add_station(11, "B");
+        writer.add_station(12, "C");
+        writer.add_station(20, "D");
+
+        std::vector<ScheduleFormat::Stop> inbound{{10, -1, 0}, {11, 3, 4}, {12, 8, -1}};
+        std::vector<ScheduleFormat::Stop> harlem{{20, -1, 0}, {11, 5, -1}};
+        std::vector<ScheduleFormat::Stop> outbound{{12, -1, 0}, {10, 4, -1}};
+
+        writer.add_trip(MNR::TrainLine::HUDSON, 1, MNR::Direction::INBOUND, "Grand Central", writer.add_pattern(inbound), 0);
+        writer.add_trip(MNR::TrainLine::HARLEM, 5, MNR::Direction::INBOUND, "Grand Central", writer.add_pattern(harlem), 1);
+        writer.add_trip(MNR::TrainLine::HUDSON, 3, MNR::Direction::OUTBOUND, "Poughkeepsie", writer.add_pattern(outbound), 5);
+        writer.add_trip(MNR::TrainLine::HUDSON, 7, MNR::Direction::INBOUND, "Grand Central", writer.add_pattern(inbound), 6);
+
+        writer.write(file_path);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(test_directory);
+    }
+};
+
+TEST_F(ScheduleIndexTest, IndexesTripsPerTrainLine)
+{
+    const ScheduleIndex index{file_path};
+    EXPECT_EQ(index.get_trip_count(), 4);
+    EXPECT_EQ(index.get_pattern_count(), 3) << "Trips with the same stops should share a pattern";
+
+    auto trips{index.get_trips(MNR::TrainLine::HUDSON)};
+    ASSERT_EQ(trips.size(), 3);
+
+    EXPECT_EQ(trips[0].train_id, 1);
+    EXPECT_EQ(trips[0].start_tick, 0);
+    EXPECT_TRUE(directions_equal(index.get_direction(trips[0]), MNR::Direction::INBOUND));
+    EXPECT_EQ(index.get_headsign(trips[0]), "Grand Central");
+
+    auto stops{index.get_stops(trips[0])};
+    ASSERT_EQ(stops.size(), 3);
+    EXPECT_EQ(stops[0].station_id, 10);
+    EXPECT_EQ(stops[0].arrival_tick, -1);
+    EXPECT_EQ(stops[1].arrival_tick, 3);
+    EXPECT_EQ(stops[1].departure_tick, 4);
+    EXPECT_EQ(stops[2].departure_tick, -1);
+
+    EXPECT_EQ(trips[1].train_id, 3) << "Trips should keep the order they were scheduled in";
+    EXPECT_TRUE(directions_equal(index.get_direction(trips[1]), MNR::Direction::OUTBOUND));
+
+    auto return_stops{index.get_stops(trips[1])};
+    ASSERT_EQ(return_stops.size(), 2);
+    EXPECT_EQ(return_stops[0].station_id, 12);
+    EXPECT_EQ(return_stops[1].arrival_tick, 4);
+
+    EXPECT_EQ(trips[2].pattern, trips[0].pattern);
+    EXPECT_EQ(trips[2].start_tick, 6);
+
+    EXPECT_EQ(index.get_trips(MNR::TrainLine::HARLEM).size(), 1);
+    EXPECT_TRUE(index.get_trips(MNR::TrainLine::NEW_HAVEN).empty()) << "Lines missing from the schedule should have no trips";
+
+    EXPECT_EQ(index.get_station_name(11), "B");
+    EXPECT_TRUE(index.get_station_name(99).empty());
+}
+
+TEST_F(ScheduleIndexTest, ConvertsToJson)
+{
+    const ScheduleIndex index{file_path};
+    std::string json_path{test_directory + "/schedule.json"};
+    index.write_json(json_path);
+
+    std::ifstream file(json_path);
+    nlohmann::json json{};
+    ASSERT_NO_THROW(file >> json) << "JSON should be valid";
+
+    const auto &hudson{json["train_lines"]["Hudson"]["trains"]};
+    ASSERT_EQ(hudson.size(), 3);
+    EXPECT_EQ(hudson[0]["train_id"], 1);
+    EXPECT_EQ(hudson[0]["direction"], "inbound");
+    EXPECT_EQ(hudson[0]["headsign"], "Grand Central");
+    ASSERT_EQ(hudson[0]["schedule"].size(), 3);
+    EXPECT_EQ(hudson[0]["schedule"][1]["station_name"], "B");
+    EXPECT_EQ(hudson[0]["schedule"][1]["arrival_tick"], 3);
+    EXPECT_EQ(hudson[0]["schedule"][2]["departure_tick"], -1);
+
+    EXPECT_EQ(hudson[1]["schedule"][1]["arrival_tick"], 9) << "Pattern ticks should be shifted by the trip start";
+    EXPECT_EQ(hudson[2]["schedule"][0]["arrival_tick"], -1);
+    EXPECT_EQ(hudson[2]["schedule"][0]["departure_tick"], 6);
+    EXPECT_EQ(hudson[2]["schedule"][2]["arrival_tick"], 14);
+
+    EXPECT_EQ(json["train_lines"]["Harlem"]["trains"].size(), 1);
+}
+
+TEST_F(ScheduleIndexTest, AppendsWritersInOrder)
+{
+    std::vector<ScheduleFormat::Stop> inbound{{10, -1, 0}, {11, 3, -1}};
+    std::vector<ScheduleFormat::Stop> outbound{{11, -1, 0}, {10, 3, -1}};
+
+    ScheduleWriter hudson{Constants::System::METRO_NORTH};
+    hudson.add_station(10, "A");
+    hudson.add_station(11, "B");
+    hudson.add_trip(MNR::TrainLine::HUDSON, 1, MNR::Direction::INBOUND, "Grand Central", hudson.add_pattern(inbound), 0);
+    hudson.add_trip(MNR::TrainLine::HUDSON, 2, MNR::Direction::OUTBOUND, "Poughkeepsie", hudson.add_pattern(outbound), 4);
+
+    ScheduleWriter harlem{Constants::System::METRO_NORTH};
+    harlem.add_station(11, "B");
+    harlem.add_station(10, "A");
+    harlem.add_trip(MNR::TrainLine::HARLEM, 5, MNR::Direction::OUTBOUND, "Wassaic", harlem.add_pattern(outbound), 2);
+
+    ScheduleWriter merged{Constants::System::METRO_NORTH};
+    merged.append(hudson);
+    merged.append(harlem);
+    EXPECT_EQ(merged.get_trip_count(), 3);
+    EXPECT_EQ(merged.get_pattern_count(), 2) << "Equal patterns of different writers should be stored once";
+
+    std::string merged_path{test_directory + "/merged.bin"};
+    merged.write(merged_path);
+
+    const ScheduleIndex index{merged_path};
+    auto harlem_trips{index.get_trips(MNR::TrainLine::HARLEM)};
+    ASSERT_EQ(harlem_trips.size(), 1);
+    EXPECT_EQ(index.get_headsign(harlem_trips[0]), "Wassaic");
+    EXPECT_EQ(harlem_trips[0].pattern, index.get_trips(MNR::TrainLine::HUDSON)[1].pattern);
+    EXPECT_EQ(index.get_stops(harlem_trips[0])[0].station_id, 11);
+    EXPECT_EQ(index.get_station_name(10), "A");
+
+    EXPECT_THROW(merged.append(ScheduleWriter{Constants::System::LIRR}), std::logic_error);
+}
+
+TEST_F(ScheduleIndexTest, RejectsInvalidFiles)
+{
+    EXPECT_THROW(ScheduleIndex{test_directory + "/missing.bin"}, std::runtime_error);
+
+    std::string invalid_path{test_directory + "/invalid.bin"};
+
+    {
+        ScheduleFormat::Header header{};
+        std::copy(std::begin(ScheduleFormat::MAGIC), std::end(ScheduleFormat::MAGIC), header.magic);
+        header.version = ScheduleFormat::VERSION + 1;
+
+        std::ofstream out(invalid_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    EXPECT_THROW(ScheduleIndex{invalid_path}, std::runtime_error) << "Unknown version should be rejected";
+
+    {
+        ScheduleFormat::Header header{};
+        std::copy(std::begin(ScheduleFormat::MAGIC), std::end(ScheduleFormat::MAGIC), header.magic);
+        header.version = ScheduleFormat::VERSION;
+        header.system_code = static_cast<std::uint32_t>(Constants::System::METRO_NORTH);
+        header.trip_count = 4;
+        header.trips_offset = sizeof(ScheduleFormat::Header);
+
+        std::ofstream out(invalid_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    EXPECT_THROW(ScheduleIndex{invalid_path}, std::runtime_error) << "Trips past the end of the file should be rejected";
+}
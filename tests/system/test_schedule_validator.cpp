@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+#include "config.h"
+#include "core/platform.h"
+#include "core/station.h"
+#include "map/metro_north.h"
+#include "system/factory.h"
+#include "system/schedule_index.h"
+#include "system/schedule_validator.h"
+#include "system/schedule_writer.h"
+
+class ScheduleValidatorTest : public ::testing::Test
+{
+protected:
+    Factory factory{};
+    Transit::Map::MetroNorth &graph{Transit::Map::MetroNorth::get_instance()};
+    Registry &registry{Registry::get_instance()};
+
+    std::string test_directory{};
+    std::string file_path{};
+
+    const Station *from{nullptr};
+    const Station *to{nullptr};
+    int travel_ticks{0};
+
+    void SetUp() override
+    {
+        factory.build_network(graph, registry, Constants::System::METRO_NORTH);
+
+        test_directory = std::string(SCHED_DIRECTORY) + "/validator_test";
+        std::filesystem::create_directories(test_directory);
+        file_path = test_directory + "/schedule.bin";
+
+        // any two stations joined by inbound Hudson track
+        for (const Platform *platform : factory.get_platforms())
+        {
+            if (from != nullptr)
+            {
+                break;
+            }
+            if (!platform->supports_train_line(MNR::TrainLine::HUDSON) || !directions_equal(platform->get_direction(), MNR::Direction::INBOUND) || platform->get_station()->is_yard())
+            {
+                continue;
+            }
+
+            for (const Track *track : platform->get_next_tracks())
+            {
+                travel_ticks = 0;
+                while (track != nullptr && !track->is_platform())
+                {
+                    travel_ticks += track->get_duration();
+                    track = track->get_next_tracks().empty() ? nullptr : track->get_next_tracks().front();
+                }
+
+                if (track != nullptr && !static_cast<const Platform *>(track)->get_station()->is_yard())
+                {
+                    from = platform->get_station();
+                    to = static_cast<const Platform *>(track)->get_station();
+                    break;
+                }
+            }
+        }
+        ASSERT_NE(from, nullptr);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(test_directory);
+    }
+
+    std::vector<ScheduleValidator::Conflict> validate(const std::vector<std::pair<TrainId, int>> &trips)
+    {
+        ScheduleWriter writer{Constants::System::METRO_NORTH};
+        std::vector<ScheduleFormat::Stop> stops{{from->get_id(), 0, 2}, {to->get_id(), 2 + travel_ticks, 4 + travel_ticks}};
+        std::uint32_t pattern{writer.add_pattern(stops)};
+
+        for (const auto &[train_id, start_tick] : trips)
+        {
+            writer.add_trip(MNR::TrainLine::HUDSON, train_id, MNR::Direction::INBOUND, "Grand Central", pattern, start_tick);
+        }
+        writer.write(file_path);
+
+        return ScheduleValidator(factory).validate(ScheduleIndex{file_path});
+    }
+};
+
+TEST_F(ScheduleValidatorTest, AcceptsSpacedTrips)
+{
+    int spacing{travel_ticks + 4};
+    EXPECT_TRUE(validate({{1, 0}, {2, spacing}, {3, 2 * spacing}}).empty());
+}
+
+TEST_F(ScheduleValidatorTest, ReportsBlockAndHeadwayConflicts)
+{
+    auto conflicts{validate({{1, 0}, {2, 1}, {3, 2 * (travel_ticks + 4)}})};
+
+    auto block{std::ranges::find(conflicts, ScheduleValidator::ConflictType::BLOCK, &ScheduleValidator::Conflict::type)};
+    ASSERT_NE(block, conflicts.end());
+    EXPECT_EQ(block->first_train, 1);
+    EXPECT_EQ(block->second_train, 2);
+
+    auto headway{std::ranges::find(conflicts, ScheduleValidator::ConflictType::HEADWAY, &ScheduleValidator::Conflict::type)};
+    ASSERT_NE(headway, conflicts.end());
+    EXPECT_EQ(headway->tick, 3);
+
+    EXPECT_TRUE(std::ranges::none_of(conflicts, [](const auto &c)
+                                     { return c.first_train == 3 || c.second_train == 3; }))
+        << "Trains away from the conflict should not be reported";
+    EXPECT_TRUE(std::ranges::is_sorted(conflicts, {}, &ScheduleValidator::Conflict::tick));
+}
+
+TEST_F(ScheduleValidatorTest, ReportsPlatformConflictsBeyondCapacity)
+{
+    int capacity{static_cast<int>(std::ranges::count_if(from->get_platforms(), [](const Platform *p)
+                                                        { return directions_equal(p->get_direction(), MNR::Direction::INBOUND); }))};
+
+    // trains dwell at the first station together and leave far enough apart to keep the track clear
+    ScheduleWriter writer{Constants::System::METRO_NORTH};
+    for (int i{0}; i <= capacity; ++i)
+    {
+        std::vector<ScheduleFormat::Stop> stops{{from->get_id(), 0, 4 + 10 * i}};
+        writer.add_trip(MNR::TrainLine::HUDSON, i + 1, MNR::Direction::INBOUND, "Grand Central", writer.add_pattern(stops), 0);
+    }
+    writer.add_trip(MNR::TrainLine::HUDSON, 99, MNR::Direction::OUTBOUND, "Poughkeepsie", writer.add_pattern(std::vector<ScheduleFormat::Stop>{{from->get_id(), 0, 4}}), 0);
+    writer.write(file_path);
+
+    auto conflicts{ScheduleValidator(factory).validate(ScheduleIndex{file_path})};
+    ASSERT_EQ(conflicts.size(), 1) << "Only the train beyond the platform count should conflict";
+    EXPECT_EQ(conflicts[0].type, ScheduleValidator::ConflictType::PLATFORM);
+    EXPECT_EQ(conflicts[0].resource_id, from->get_id());
+    EXPECT_EQ(conflicts[0].second_train, capacity + 1);
+}
+
+
+TEST_F(ScheduleValidatorTest, ReportsConflictsBehindAnOccupancyOfTheSameTrain)
+{
+    // train 2 crawls over the block, so the occupancy of train 1 that ends first is not the one it conflicts with
+    ScheduleWriter writer{Constants::System::METRO_NORTH};
+    std::vector<ScheduleFormat::Stop> fast{{from->get_id(), 0, 2}, {to->get_id(), 2 + 4 * travel_ticks, 4 + 4 * travel_ticks}};
+    std::vector<ScheduleFormat::Stop> slow{{from->get_id(), 0, 2}, {to->get_id(), 2 + 10 * travel_ticks, 4 + 10 * travel_ticks}};
+    std::uint32_t fast_pattern{writer.add_pattern(fast)};
+    std::uint32_t slow_pattern{writer.add_pattern(slow)};
+
+    writer.add_trip(MNR::TrainLine::HUDSON, 1, MNR::Direction::INBOUND, "Grand Central", fast_pattern, 0);
+    writer.add_trip(MNR::TrainLine::HUDSON, 2, MNR::Direction::INBOUND, "Grand Central", slow_pattern, 0);
+    writer.add_trip(MNR::TrainLine::HUDSON, 1, MNR::Direction::INBOUND, "Grand Central", fast_pattern, 1);
+    writer.write(file_path);
+
+    auto conflicts{ScheduleValidator(factory).validate(ScheduleIndex{file_path})};
+    EXPECT_TRUE(std::ranges::any_of(conflicts, [](const auto &c)
+                                    { return c.type == ScheduleValidator::ConflictType::BLOCK && c.first_train == 2 && c.second_train == 1; }))
+        << "The later trip of train 1 should conflict with train 2 while its earlier trip is still on the block";
+    EXPECT_TRUE(std::ranges::none_of(conflicts, [](const auto &c)
+                                     { return c.first_train == c.second_train; }));
+}
@@ -158,4 +158,41 @@ TEST_F(SchedulerTest, ValidateRouteSequences)
             EXPECT_TRUE(matches_any) << "train " << train["train_id"] << " had invalid start/end: " << actual_sequence.front() << " -> " << actual_sequence.back();
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_F(SchedulerTest, FreezesRegistryAfterScheduling)
+{
+    scheduler.write_schedule(mnr, registry, test_directory, system_code);
+    ASSERT_TRUE(registry.is_frozen(system_code)) << "Routes should be frozen once the schedule is written";
+
+    const auto &train_registry{registry.get_train_registry(system_code)};
+    ASSERT_FALSE(train_registry.empty());
+    EXPECT_TRUE(registry.get_registered_route(train_registry.front()).has_value());
+
+    EXPECT_NO_THROW(scheduler.write_schedule(mnr, registry, test_directory, system_code)) << "Rescheduling with the same routes should be allowed";
+    EXPECT_THROW(registry.set_fleet_size(system_code, MNR::TrainLine::HUDSON, 20), std::logic_error);
+}
+
+TEST_F(SchedulerTest, ReusesCachedSchedule)
+{
+    std::string folder{std::string(SCHED_DIRECTORY) + "/" + test_directory};
+    std::string schedule_path{folder + "/schedule.bin"};
+    std::string routes_path{folder + "/routes.bin"};
+
+    scheduler.write_schedule(mnr, registry, test_directory, system_code);
+    ASSERT_TRUE(std::filesystem::exists(routes_path)) << "Routes should be written next to the schedule";
+    auto written{std::filesystem::last_write_time(schedule_path)};
+
+    std::filesystem::remove(file_path);
+    ASSERT_NO_THROW(scheduler.write_schedule(mnr, registry, test_directory, system_code));
+    EXPECT_EQ(std::filesystem::last_write_time(schedule_path), written) << "Unchanged inputs should reuse the schedule";
+    EXPECT_TRUE(std::filesystem::exists(file_path)) << "A missing schedule.json should be converted from the cached schedule";
+
+    const auto &train_registry{registry.get_train_registry(system_code)};
+    ASSERT_FALSE(train_registry.empty());
+    EXPECT_TRUE(registry.get_registered_route(train_registry.front()).has_value());
+
+    std::filesystem::resize_file(routes_path, 8);
+    ASSERT_NO_THROW(scheduler.write_schedule(mnr, registry, test_directory, system_code)) << "A damaged sidecar should regenerate the same routes";
+    EXPECT_GT(std::filesystem::file_size(routes_path), 8);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include "system/service_planner.h"
+
+class ServicePlannerTest : public ::testing::Test
+{
+protected:
+    ServiceProfile profile{{{0, 10}, {100, 5}}, 200, 4};
+};
+
+TEST_F(ServicePlannerTest, FollowsHeadwayProfile)
+{
+    EXPECT_EQ(profile.headway_at(0), 10);
+    EXPECT_EQ(profile.headway_at(99), 10);
+    EXPECT_EQ(profile.headway_at(100), 5);
+
+    std::vector<std::pair<TrainId, int>> fleet{};
+    for (int i{0}; i < 40; ++i)
+    {
+        fleet.emplace_back(i, i % 2);
+    }
+
+    auto runs{ServicePlanner::plan(profile, {{{30}, {30}}}, fleet)};
+
+    std::vector<int> side_zero{};
+    for (const auto &run : runs)
+    {
+        if (run.side == 0)
+        {
+            side_zero.push_back(run.start_tick);
+        }
+    }
+
+    ASSERT_EQ(side_zero.size(), 30) << "Ten departures before tick 100 and twenty after";
+    EXPECT_EQ(side_zero[1] - side_zero[0], 10);
+    EXPECT_EQ(side_zero[11] - side_zero[10], 5);
+    EXPECT_LT(side_zero.back(), profile.end_tick);
+}
+
+TEST_F(ServicePlannerTest, CyclesTrainsThroughYards)
+{
+    auto runs{ServicePlanner::plan(profile, {{{30}, {30}}}, {{1, 0}, {2, 1}})};
+
+    std::map<TrainId, std::vector<ServicePlanner::Run>> by_train{};
+    for (const auto &run : runs)
+    {
+        by_train[run.train_id].push_back(run);
+    }
+
+    ASSERT_EQ(by_train.size(), 2);
+    for (const auto &[train_id, train_runs] : by_train)
+    {
+        ASSERT_GT(train_runs.size(), 2) << "Trains should run more than once a day";
+        for (int i{1}; i < train_runs.size(); ++i)
+        {
+            EXPECT_NE(train_runs[i].side, train_runs[i - 1].side) << "A run should leave from the yard the previous one ended at";
+            EXPECT_GE(train_runs[i].start_tick, train_runs[i - 1].start_tick + 30 + profile.turnaround);
+        }
+    }
+}
+
+TEST_F(ServicePlannerTest, DropsSlotsWithoutTrainsAndAlternatesVariants)
+{
+    auto runs{ServicePlanner::plan(profile, {{{30, 40}, {}}}, {{1, 0}, {2, 0}})};
+
+    ASSERT_EQ(runs.size(), 2) << "Trains never return to a side that is not served";
+    EXPECT_EQ(runs[0].variant, 0);
+    EXPECT_EQ(runs[1].variant, 1);
+    EXPECT_EQ(runs[1].start_tick, 10);
+
+    EXPECT_THROW(ServicePlanner::plan(ServiceProfile{{{0, 0}}, 10, 0}, {{{1}, {1}}}, {{1, 0}}), std::invalid_argument);
+}
+
+TEST_F(ServicePlannerTest, PlansSubwayServiceDayQuickly)
+{
+    ServiceProfile subway{ServiceProfile::default_for(Constants::System::SUBWAY)};
+
+    std::vector<std::pair<TrainId, int>> fleet{};
+    for (int i{0}; i < 200; ++i)
+    {
+        fleet.emplace_back(i, i % 2);
+    }
+
+    auto start{std::chrono::steady_clock::now()};
+    std::size_t trips{0};
+    for (int line{0}; line < 30; ++line)
+    {
+        trips += ServicePlanner::plan(subway, {{{150, 160}, {150}}}, fleet).size();
+    }
+    auto elapsed{std::chrono::steady_clock::now() - start};
+
+    EXPECT_GT(trips, 10000);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+}
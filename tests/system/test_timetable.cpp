@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "system/timetable.h"
+
+class TimetableTest : public ::testing::TestWithParam<std::string>
+{
+protected:
+    std::string file_path{};
+
+    void SetUp() override
+    {
+        file_path = std::string(DATA_DIRECTORY) + "/clean/" + GetParam() + "/timetable.bin";
+        if (!std::filesystem::exists(file_path))
+        {
+            GTEST_SKIP() << "Timetable not built, run the etl first: " << file_path;
+        }
+    }
+};
+
+TEST_P(TimetableTest, LoadsRoutesInNameOrder)
+{
+    Timetable timetable{file_path};
+
+    ASSERT_GT(timetable.route_count(), 0u);
+    ASSERT_GT(timetable.trip_count(), 0u);
+
+    std::size_t trips_seen{0};
+    for (std::uint32_t r{0}; r < timetable.route_count(); ++r)
+    {
+        if (r > 0)
+        {
+            EXPECT_LT(timetable.route_name(r - 1), timetable.route_name(r)) << "Routes should be sorted by name";
+        }
+
+        auto trips{timetable.trips(r)};
+        trips_seen += trips.size();
+
+        for (std::size_t t{1}; t < trips.size(); ++t)
+        {
+            EXPECT_LE(trips[t - 1].start_time, trips[t].start_time) << "Trips of route " << timetable.route_name(r) << " should be sorted by start time";
+        }
+
+        for (const auto &trip : trips)
+        {
+            EXPECT_EQ(trip.route, r);
+        }
+    }
+
+    EXPECT_EQ(trips_seen, timetable.trip_count()) << "Every trip should belong to exactly one route";
+}
+
+TEST_P(TimetableTest, DecodesMonotonicStopTimes)
+{
+    Timetable timetable{file_path};
+    std::vector<Timetable::StopTime> stop_times{};
+
+    for (std::uint32_t r{0}; r < timetable.route_count(); ++r)
+    {
+        for (const auto &trip : timetable.trips(r))
+        {
+            timetable.decode(trip, stop_times);
+
+            ASSERT_GE(stop_times.size(), 2u);
+            EXPECT_EQ(stop_times.front().arrival, trip.start_time);
+
+            for (std::size_t i{0}; i < stop_times.size(); ++i)
+            {
+                EXPECT_LE(stop_times[i].arrival, stop_times[i].departure);
+                EXPECT_LT(stop_times[i].stop, timetable.stop_count());
+                EXPECT_FALSE(timetable.stop_code(stop_times[i].stop).empty());
+
+                if (i > 0)
+                {
+                    EXPECT_LE(stop_times[i - 1].departure, stop_times[i].arrival);
+                }
+            }
+        }
+    }
+}
+
+TEST(TimetableFileTest, RejectsInvalidFiles)
+{
+    std::string file_path{std::string(DATA_DIRECTORY) + "/timetable_test.bin"};
+
+    {
+        std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+        out << "not a timetable";
+    }
+    EXPECT_THROW(Timetable{file_path}, std::runtime_error) << "Truncated file should be rejected";
+
+    {
+        TimetableFormat::Header header{};
+        std::copy(std::begin(TimetableFormat::MAGIC), std::end(TimetableFormat::MAGIC), header.magic);
+        header.version = TimetableFormat::VERSION;
+        header.trip_count = 1;
+        header.trips_offset = sizeof(TimetableFormat::Header);
+
+        std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    EXPECT_THROW(Timetable{file_path}, std::runtime_error) << "Section past the end of the file should be rejected";
+
+    std::filesystem::remove(file_path);
+    EXPECT_THROW(Timetable{file_path}, std::runtime_error) << "Missing file should be rejected";
+}
+
+INSTANTIATE_TEST_SUITE_P(Systems, TimetableTest, ::testing::Values("subway", "mnr", "lirr"));
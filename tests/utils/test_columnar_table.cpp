@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "config.h"
+#include "utils/utils.h"
+#include "utils/columnar_table.h"
+
+class ColumnarTableTest : public ::testing::TestWithParam<std::pair<std::string, std::string>>
+{
+protected:
+    std::string csv_path{};
+    std::string binary_path{};
+    std::string id_column{};
+
+    void SetUp() override
+    {
+        const auto &[system, id]{GetParam()};
+        csv_path = std::string(DATA_DIRECTORY) + "/clean/" + system + "/stations.csv";
+        binary_path = std::string(DATA_DIRECTORY) + "/clean/" + system + "/stations.bin";
+        id_column = id;
+
+        if (!std::filesystem::exists(binary_path))
+        {
+            GTEST_SKIP() << "Columnar stations not built, run the etl first: " << binary_path;
+        }
+    }
+};
+
+TEST_P(ColumnarTableTest, MatchesCsvStations)
+{
+    Utils::ColumnarTable table{binary_path};
+
+    auto ids{table.int32s(table.column(id_column, ColumnarFormat::Type::INT32))};
+    auto latitudes{table.float64s(table.column("latitude", ColumnarFormat::Type::FLOAT64))};
+    std::size_t name_column{table.column("stop_name", ColumnarFormat::Type::STRING)};
+
+    std::size_t row{0};
+    Utils::open_and_parse(csv_path, {id_column, "stop_name", "latitude"}, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+                          {
+        auto fields {Utils::from_tokens(Utils::split(line, ','), column_index)};
+
+        ASSERT_LT(row, table.row_count());
+        EXPECT_EQ(ids[row], Utils::string_view_to_numeric<int>(fields.at(id_column))) << "line " << line_num;
+        EXPECT_DOUBLE_EQ(latitudes[row], Utils::string_view_to_numeric<double>(fields.at("latitude"))) << "line " << line_num;
+        EXPECT_EQ(table.string(name_column, row), fields.at("stop_name")) << "line " << line_num;
+        ++row; });
+
+    EXPECT_EQ(row, table.row_count()) << "Binary and csv stations should have the same rows";
+}
+
+TEST_P(ColumnarTableTest, RejectsMismatchedColumnTypes)
+{
+    Utils::ColumnarTable table{binary_path};
+
+    EXPECT_THROW(table.column(id_column, ColumnarFormat::Type::STRING), std::runtime_error);
+    EXPECT_THROW(table.column("not_a_column", ColumnarFormat::Type::INT32), std::runtime_error);
+}
+
+TEST(ColumnarTableFileTest, RejectsInvalidFiles)
+{
+    std::string file_path{std::string(DATA_DIRECTORY) + "/columnar_test.bin"};
+
+    {
+        ColumnarFormat::Header header{};
+        std::copy(std::begin(ColumnarFormat::MAGIC), std::end(ColumnarFormat::MAGIC), header.magic);
+        header.version = ColumnarFormat::VERSION + 1;
+
+        std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    EXPECT_THROW(Utils::ColumnarTable{file_path}, std::runtime_error) << "Unknown version should be rejected";
+
+    {
+        ColumnarFormat::Header header{};
+        std::copy(std::begin(ColumnarFormat::MAGIC), std::end(ColumnarFormat::MAGIC), header.magic);
+        header.version = ColumnarFormat::VERSION;
+        header.column_count = 2;
+        header.schema_offset = sizeof(ColumnarFormat::Header);
+
+        std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    EXPECT_THROW(Utils::ColumnarTable{file_path}, std::runtime_error) << "Schema past the end of the file should be rejected";
+
+    std::filesystem::remove(file_path);
+}
+
+INSTANTIATE_TEST_SUITE_P(Systems, ColumnarTableTest, ::testing::Values(std::make_pair("subway", "complex_id"), std::make_pair("mnr", "stop_id"), std::make_pair("lirr", "stop_id")));
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <string>
+
+#include "utils/hasher.h"
+
+// reference digests of the xxHash implementation at seed 0
+TEST(HasherTest, MatchesXxh64OfEmptyInput)
+{
+    Utils::Hasher hasher{};
+    EXPECT_EQ(hasher.digest(), 0xEF46DB3751D8E999ULL);
+}
+
+TEST(HasherTest, MatchesXxh64OfInputShorterThanAStripe)
+{
+    Utils::Hasher hasher{};
+    hasher.update("abc");
+    EXPECT_EQ(hasher.digest(), 0x44BC2CF5AD770999ULL);
+}
+
+TEST(HasherTest, MatchesXxh64OfInputLongerThanAStripe)
+{
+    Utils::Hasher hasher{};
+    hasher.update("The quick brown fox jumps over the lazy dog");
+    EXPECT_EQ(hasher.digest(), 0x0B242D361FDA71BCULL);
+}
+
+TEST(HasherTest, MatchesXxh64WithSeed)
+{
+    Utils::Hasher hasher{1};
+    hasher.update("abc");
+    EXPECT_EQ(hasher.digest(), 0xBEA9CA8199328908ULL);
+}
+
+TEST(HasherTest, SplitUpdatesMatchOneUpdate)
+{
+    std::string input{};
+    for (int i{0}; i < 20; ++i)
+    {
+        input += "Grand Central " + std::to_string(i) + ";";
+    }
+
+    Utils::Hasher whole{};
+    whole.update(input);
+
+    // split points before, inside and across the 32 byte stripes
+    for (std::size_t step : {1u, 7u, 31u, 32u, 33u, 100u})
+    {
+        Utils::Hasher parts{};
+        for (std::size_t offset{0}; offset < input.size(); offset += step)
+        {
+            parts.update(std::string_view(input).substr(offset, step));
+        }
+        EXPECT_EQ(parts.digest(), whole.digest()) << "updates of " << step << " bytes";
+    }
+}
+
+TEST(HasherTest, DigestDoesNotEndTheStream)
+{
+    Utils::Hasher hasher{};
+    hasher.update("The quick brown fox ");
+    hasher.digest();
+    hasher.update("jumps over the lazy dog");
+    EXPECT_EQ(hasher.digest(), 0x0B242D361FDA71BCULL);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "config.h"
+#include "utils/json_writer.h"
+
+class JsonWriterTest : public ::testing::Test
+{
+protected:
+    std::string file_path{};
+
+    void SetUp() override
+    {
+        file_path = std::string(DATA_DIRECTORY) + "/json_writer_test.json";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(file_path);
+    }
+
+    std::string read_output() const
+    {
+        std::ifstream file(file_path);
+        std::stringstream contents{};
+        contents << file.rdbuf();
+        return contents.str();
+    }
+};
+
+TEST_F(JsonWriterTest, MatchesNlohmannDump)
+{
+    nlohmann::json expected{};
+    expected["empty_array"] = nlohmann::json::array();
+    expected["empty_object"] = nlohmann::json::object();
+    expected["lines"]["Hudson"]["trains"] = nlohmann::json::array({nlohmann::json{{"id", 1}, {"name", "Grand \"Central\"\n\\"}},
+                                                                   nlohmann::json{{"id", -12}, {"name", std::string("tab\tbell\x07")}}});
+    expected["numbers"] = nlohmann::json::array({0, -1, 2147483647});
+
+    {
+        Utils::JsonWriter writer{file_path};
+        writer.begin_object();
+        writer.key("empty_array");
+        writer.begin_array();
+        writer.end_array();
+        writer.key("empty_object");
+        writer.begin_object();
+        writer.end_object();
+        writer.key("lines");
+        writer.begin_object();
+        writer.key("Hudson");
+        writer.begin_object();
+        writer.key("trains");
+        writer.begin_array();
+        writer.begin_object();
+        writer.key("id");
+        writer.value(1);
+        writer.key("name");
+        writer.value("Grand \"Central\"\n\\");
+        writer.end_object();
+        writer.begin_object();
+        writer.key("id");
+        writer.value(-12);
+        writer.key("name");
+        writer.value("tab\tbell\x07");
+        writer.end_object();
+        writer.end_array();
+        writer.end_object();
+        writer.end_object();
+        writer.key("numbers");
+        writer.begin_array();
+        writer.value(0);
+        writer.value(-1);
+        writer.value(2147483647);
+        writer.end_array();
+        writer.end_object();
+        writer.finish();
+    }
+
+    EXPECT_EQ(read_output(), expected.dump(2));
+}
+
+TEST_F(JsonWriterTest, RejectsUnclosedDocuments)
+{
+    Utils::JsonWriter writer{file_path};
+    writer.begin_array();
+
+    EXPECT_THROW(writer.finish(), std::logic_error);
+}
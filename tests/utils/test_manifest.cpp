@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config.h"
+#include "manifest.h"
+
+class ManifestTest : public ::testing::Test
+{
+protected:
+    using Fingerprints = std::vector<std::pair<std::string, std::uint64_t>>;
+
+    std::string file_path{};
+    Fingerprints stations{{"config", 0x1111}, {"zips/mnr.zip:stops.txt", 0x2222}};
+    Fingerprints routes{{"config", 0x1111}, {"zips/mnr.zip:trips.txt", 0x3333}, {"zips/mnr.zip:stop_times.txt", 0x4444}};
+
+    void SetUp() override
+    {
+        file_path = std::string(DATA_DIRECTORY) + "/manifest_test.csv";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(file_path);
+    }
+};
+
+TEST_F(ManifestTest, IsCurrentOnlyForRecordedFingerprints)
+{
+    etl::Manifest manifest{};
+    EXPECT_FALSE(manifest.is_current("stations", stations)) << "Nothing recorded should not be current";
+
+    manifest.record("stations", stations);
+    EXPECT_TRUE(manifest.is_current("stations", stations));
+    EXPECT_FALSE(manifest.is_current("routes", routes)) << "Outputs should be tracked independently";
+    EXPECT_FALSE(manifest.is_current("stations", {})) << "An output without dependencies should never be current";
+}
+
+TEST_F(ManifestTest, ChangedInputInvalidatesOnlyItsOutputs)
+{
+    etl::Manifest manifest{};
+    manifest.record("stations", stations);
+    manifest.record("routes", routes);
+
+    Fingerprints changed{routes};
+    changed[2].second = 0x5555;
+    EXPECT_FALSE(manifest.is_current("routes", changed)) << "A changed input should invalidate its output";
+    EXPECT_TRUE(manifest.is_current("stations", stations)) << "Outputs not built from the input should stay current";
+
+    manifest.record("routes", changed);
+    EXPECT_TRUE(manifest.is_current("routes", changed));
+    EXPECT_FALSE(manifest.is_current("routes", routes)) << "Recording should replace the previous fingerprints";
+}
+
+TEST_F(ManifestTest, InvalidatesAnOutput)
+{
+    etl::Manifest manifest{};
+    manifest.record("stations", stations);
+    manifest.record("routes", routes);
+
+    manifest.invalidate("routes");
+    EXPECT_FALSE(manifest.is_current("routes", routes));
+    EXPECT_TRUE(manifest.is_current("stations", stations));
+}
+
+TEST_F(ManifestTest, SavesAndLoads)
+{
+    etl::Manifest manifest{};
+    manifest.record("stations", stations);
+    manifest.record("routes", routes);
+    ASSERT_TRUE(manifest.save(file_path));
+
+    etl::Manifest loaded{etl::Manifest::load(file_path)};
+    EXPECT_TRUE(loaded.is_current("stations", stations));
+    EXPECT_TRUE(loaded.is_current("routes", routes));
+
+    Fingerprints changed{stations};
+    changed[1].second = 0x2223;
+    EXPECT_FALSE(loaded.is_current("stations", changed));
+}
+
+TEST_F(ManifestTest, LoadsMissingOrDamagedFilesAsEmpty)
+{
+    EXPECT_FALSE(etl::Manifest::load(file_path).is_current("stations", stations)) << "A missing manifest should load empty";
+
+    {
+        std::ofstream out(file_path, std::ios::trunc);
+        out << "dependency,hash\n"
+            << "stations|config,not a hash\n"
+            << "stations|zips/mnr.zip:stops.txt\n"
+            << "routes|config," << std::hex << 0x1111 << "\n";
+    }
+
+    etl::Manifest loaded{etl::Manifest::load(file_path)};
+    EXPECT_FALSE(loaded.is_current("stations", stations)) << "Damaged lines should be skipped";
+    EXPECT_TRUE(loaded.is_current("routes", {{"config", 0x1111}})) << "Lines after a damaged one should still load";
+}
+
+TEST_F(ManifestTest, ConfigHashFollowsTheConfig)
+{
+    etl::SystemConfig config{};
+    config.name = "mnr";
+    config.station_columns = {"stop_id", "stop_name"};
+
+    std::uint64_t hash{etl::hash_config(config)};
+    EXPECT_EQ(etl::hash_config(config), hash);
+
+    config.station_columns = {"stop_id", "stop_name", "stop_lat"};
+    EXPECT_NE(etl::hash_config(config), hash) << "A changed config should change its fingerprint";
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <string>
+
+#include "utils/string_pool.h"
+
+class StringPoolTest : public testing::Test
+{
+protected:
+    Utils::StringPool pool{};
+};
+
+TEST_F(StringPoolTest, AssignsDenseIdsInOrderOfFirstAppearance)
+{
+    EXPECT_EQ(pool.intern("A15"), 0u);
+    EXPECT_EQ(pool.intern("A16"), 1u);
+    EXPECT_EQ(pool.intern("A15"), 0u) << "interning an existing string should return its id";
+    EXPECT_EQ(pool.intern(""), 2u);
+
+    EXPECT_EQ(pool.size(), 3u);
+    EXPECT_EQ(pool.view(0), "A15");
+    EXPECT_EQ(pool.view(1), "A16");
+    EXPECT_EQ(pool.view(2), "");
+}
+
+TEST_F(StringPoolTest, FindsWithoutInterning)
+{
+    pool.intern("Hudson");
+
+    std::string key{"Hudson"};
+    EXPECT_EQ(pool.find(key), 0u);
+    EXPECT_EQ(pool.find("Harlem"), std::nullopt);
+    EXPECT_EQ(pool.size(), 1u) << "find should not add strings to the pool";
+}
+
+TEST_F(StringPoolTest, ViewsOutliveSourceStrings)
+{
+    std::vector<std::uint32_t> ids{};
+    for (int i{0}; i < 10000; ++i)
+    {
+        std::string temporary{"trip_" + std::to_string(i)};
+        ids.push_back(pool.intern(temporary));
+    }
+
+    std::string oversized(100000, 'x');
+    std::uint32_t oversized_id{pool.intern(oversized)};
+    oversized.assign(oversized.size(), 'y');
+
+    for (int i{0}; i < 10000; ++i)
+    {
+        EXPECT_EQ(pool.view(ids[i]), "trip_" + std::to_string(i));
+    }
+
+    EXPECT_EQ(pool.view(oversized_id), std::string(100000, 'x'));
+}
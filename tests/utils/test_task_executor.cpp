@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "utils/task_executor.h"
+
+class TaskExecutorTest : public testing::Test
+{
+protected:
+    Utils::TaskExecutor executor{4};
+    Utils::TaskGraph graph{};
+};
+
+TEST_F(TaskExecutorTest, RunsTasksAfterTheirPredecessors)
+{
+    // one prepare, many lines, one finish, as in a tick of a system
+    std::atomic<int> prepared{0};
+    std::atomic<int> authorized{0};
+    std::vector<int> seen_at_finish{};
+
+    std::size_t prepare{graph.add([&]
+                                  { prepared.fetch_add(1); })};
+    std::size_t finish{graph.add([&]
+                                 { seen_at_finish.push_back(authorized.load()); })};
+
+    for (int line{0}; line < 26; ++line)
+    {
+        std::size_t authorize{graph.add([&]
+                                        {
+                                            EXPECT_EQ(prepared.load(), 1) << "Lines should only be authorized once prepared";
+                                            authorized.fetch_add(1); })};
+        graph.precede(prepare, authorize);
+        graph.precede(authorize, finish);
+    }
+
+    for (int run{1}; run <= 100; ++run)
+    {
+        prepared.store(0);
+        authorized.store(0);
+        executor.run(graph);
+    }
+
+    EXPECT_EQ(executor.size(), 4u);
+    ASSERT_EQ(seen_at_finish.size(), 100u) << "The graph should run once per run";
+    EXPECT_THAT(seen_at_finish, testing::Each(26)) << "Finish should run after every line";
+}
+
+TEST_F(TaskExecutorTest, RunsEveryTaskOncePerRunOfTheSameGraph)
+{
+    // a diamond, one root, two middles, one sink, run back to back like the tick graph
+    std::vector<std::atomic<int>> runs(4);
+    std::vector<std::size_t> nodes{};
+    for (std::size_t i{0}; i < runs.size(); ++i)
+    {
+        nodes.push_back(graph.add([&, i]
+                                  { runs[i].fetch_add(1); }));
+    }
+    graph.precede(nodes[0], nodes[1]);
+    graph.precede(nodes[0], nodes[2]);
+    graph.precede(nodes[1], nodes[3]);
+    graph.precede(nodes[2], nodes[3]);
+
+    for (int run{1}; run <= 2000; ++run)
+    {
+        executor.run(graph);
+        for (std::size_t i{0}; i < runs.size(); ++i)
+        {
+            ASSERT_EQ(runs[i].load(), run) << "Task " << i << " should run exactly once in every run";
+        }
+    }
+}
+
+TEST_F(TaskExecutorTest, RethrowsTaskFailuresAfterTheRun)
+{
+    std::atomic<int> finished{0};
+    std::size_t failing{graph.add([]
+                                  { throw std::runtime_error("task failed"); })};
+    std::size_t after{graph.add([&]
+                                { finished.fetch_add(1); })};
+    graph.precede(failing, after);
+    graph.add([&]
+              { finished.fetch_add(1); });
+
+    EXPECT_THROW(executor.run(graph), std::runtime_error);
+    EXPECT_EQ(finished.load(), 2) << "Tasks should still run once a task failed";
+
+    // the executor stays usable after a failed run
+    Utils::TaskGraph next{};
+    next.add([&]
+             { finished.fetch_add(1); });
+    executor.run(next);
+    EXPECT_EQ(finished.load(), 3);
+}
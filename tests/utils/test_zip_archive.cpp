@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "config.h"
+#include "zip_archive.h"
+
+class ZipArchiveTest : public ::testing::TestWithParam<bool /* deflated */>
+{
+protected:
+    static constexpr std::size_t BLOCK_SIZE{1 << 18}; // of ZipArchive, members are handed over in blocks of this size
+
+    struct Member
+    {
+        std::string name;
+        std::string data;
+        bool deflated;
+        std::uint32_t crc_offset{0}; // added to the recorded crc to damage it
+    };
+
+    std::string file_path{};
+    std::vector<std::string> errors{};
+    etl::Log log{[this](const std::string &message)
+                 { errors.push_back(message); }};
+
+    void SetUp() override
+    {
+        file_path = std::string(DATA_DIRECTORY) + "/zip_archive_test.zip";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(file_path);
+    }
+
+    static void put_16(std::string &out, std::uint16_t value)
+    {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    static void put_32(std::string &out, std::uint32_t value)
+    {
+        put_16(out, static_cast<std::uint16_t>(value & 0xFFFF));
+        put_16(out, static_cast<std::uint16_t>(value >> 16));
+    }
+
+    static std::string deflate_raw(const std::string &data)
+    {
+        z_stream stream{};
+        deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+        std::string out(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+        stream.avail_in = static_cast<uInt>(data.size());
+        stream.next_out = reinterpret_cast<Bytef *>(out.data());
+        stream.avail_out = static_cast<uInt>(out.size());
+        deflate(&stream, Z_FINISH);
+
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        return out;
+    }
+
+    // local headers and data, then the central directory and its end record
+    void write_zip(const std::vector<Member> &members) const
+    {
+        std::string zip{};
+        std::string directory{};
+
+        for (const auto &member : members)
+        {
+            std::string payload{member.deflated ? deflate_raw(member.data) : member.data};
+            std::uint32_t crc{static_cast<std::uint32_t>(crc32(0L, reinterpret_cast<const Bytef *>(member.data.data()), static_cast<uInt>(member.data.size()))) + member.crc_offset};
+            std::uint16_t method{static_cast<std::uint16_t>(member.deflated ? 8 : 0)};
+            std::uint32_t offset{static_cast<std::uint32_t>(zip.size())};
+
+            put_32(zip, 0x04034b50);
+            put_16(zip, 20);
+            put_16(zip, 0);
+            put_16(zip, method);
+            put_32(zip, 0);
+            put_32(zip, crc);
+            put_32(zip, static_cast<std::uint32_t>(payload.size()));
+            put_32(zip, static_cast<std::uint32_t>(member.data.size()));
+            put_16(zip, static_cast<std::uint16_t>(member.name.size()));
+            put_16(zip, 0);
+            zip += member.name;
+            zip += payload;
+
+            put_32(directory, 0x02014b50);
+            put_16(directory, 20);
+            put_16(directory, 20);
+            put_16(directory, 0);
+            put_16(directory, method);
+            put_32(directory, 0);
+            put_32(directory, crc);
+            put_32(directory, static_cast<std::uint32_t>(payload.size()));
+            put_32(directory, static_cast<std::uint32_t>(member.data.size()));
+            put_16(directory, static_cast<std::uint16_t>(member.name.size()));
+            put_16(directory, 0);
+            put_16(directory, 0);
+            put_16(directory, 0);
+            put_16(directory, 0);
+            put_32(directory, 0);
+            put_32(directory, offset);
+            directory += member.name;
+        }
+
+        std::uint32_t directory_offset{static_cast<std::uint32_t>(zip.size())};
+        zip += directory;
+
+        put_32(zip, 0x06054b50);
+        put_16(zip, 0);
+        put_16(zip, 0);
+        put_16(zip, static_cast<std::uint16_t>(members.size()));
+        put_16(zip, static_cast<std::uint16_t>(members.size()));
+        put_32(zip, static_cast<std::uint32_t>(directory.size()));
+        put_32(zip, directory_offset);
+        put_16(zip, 0);
+
+        std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+        out << zip;
+    }
+
+    std::string read_member(std::string_view name, bool &streamed)
+    {
+        std::string contents{};
+        auto archive{etl::ZipArchive::open(file_path, log)};
+        if (!archive.has_value())
+        {
+            streamed = false;
+            return contents;
+        }
+
+        const etl::ZipArchive::Entry *entry{archive->find(name)};
+        if (entry == nullptr)
+        {
+            streamed = false;
+            return contents;
+        }
+
+        streamed = archive->stream(*entry, [&](std::string_view block)
+                                   {
+            contents.append(block);
+            return true; });
+        return contents;
+    }
+};
+
+TEST_P(ZipArchiveTest, ReadsAMember)
+{
+    std::string stops{"stop_id,stop_name\n1,Grand Central\n2,Harlem 125 St\n"};
+    std::string trips{"trip_id,route_id\n10,1\n"};
+    write_zip({{"gtfs/stops.txt", stops, GetParam()}, {"gtfs/trips.txt", trips, GetParam()}});
+
+    bool streamed{false};
+    EXPECT_EQ(read_member("stops.txt", streamed), stops) << "Members should be found by basename";
+    EXPECT_TRUE(streamed);
+    EXPECT_EQ(read_member("gtfs/trips.txt", streamed), trips);
+    EXPECT_TRUE(streamed);
+    EXPECT_TRUE(errors.empty());
+}
+
+TEST_P(ZipArchiveTest, StitchesLinesSplitAcrossBlocks)
+{
+    std::string csv{"stop_id,stop_name\n"};
+    std::vector<std::string> names{};
+    for (int i{0}; csv.size() < 2 * BLOCK_SIZE + 100; ++i)
+    {
+        names.push_back("Station " + std::to_string(i * 7919));
+        csv += std::to_string(i) + "," + names.back() + "\n";
+    }
+    ASSERT_NE(csv[BLOCK_SIZE - 1], '\n') << "A line should straddle the first block boundary";
+
+    write_zip({{"stops.txt", csv, GetParam()}});
+
+    std::vector<std::string> parsed{};
+    bool read{etl::open_and_parse_member(file_path, "stops.txt", {"stop_id", "stop_name"}, [&](std::string_view line, const std::unordered_map<std::string_view, int> &column_index, int line_num)
+                                         {
+        auto tokens{Utils::split(line, ',')};
+        ASSERT_EQ(tokens.size(), 2u) << "line " << line_num << ": " << line;
+        EXPECT_EQ(Utils::string_view_to_numeric<int>(tokens[column_index.at("stop_id")]), line_num - 2);
+        parsed.emplace_back(tokens[column_index.at("stop_name")]); }, log)};
+
+    EXPECT_TRUE(read);
+    EXPECT_EQ(parsed, names);
+    EXPECT_TRUE(errors.empty());
+}
+
+TEST_P(ZipArchiveTest, RejectsAChecksumMismatch)
+{
+    write_zip({{"stops.txt", "stop_id,stop_name\n1,Grand Central\n", GetParam(), 1}});
+
+    bool streamed{true};
+    read_member("stops.txt", streamed);
+    EXPECT_FALSE(streamed) << "A member whose crc does not match should fail";
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_THAT(errors.front(), ::testing::HasSubstr("Checksum mismatch for stops.txt"));
+}
+
+TEST_P(ZipArchiveTest, ReportsMissingMembersAndColumns)
+{
+    write_zip({{"stops.txt", "stop_id,stop_name\n1,Grand Central\n", GetParam()}});
+
+    auto ignore = [](std::string_view, const std::unordered_map<std::string_view, int> &, int) {};
+    EXPECT_FALSE(etl::open_and_parse_member(file_path, "trips.txt", {"trip_id"}, ignore, log));
+    EXPECT_FALSE(etl::open_and_parse_member(file_path, "stops.txt", {"stop_lat"}, ignore, log));
+    EXPECT_FALSE(etl::open_and_parse_member(file_path + ".missing", "stops.txt", {"stop_id"}, ignore, log));
+
+    ASSERT_EQ(errors.size(), 3u);
+    EXPECT_THAT(errors[0], ::testing::HasSubstr("Missing member trips.txt"));
+    EXPECT_THAT(errors[1], ::testing::HasSubstr("Missing column stop_lat"));
+    EXPECT_THAT(errors[2], ::testing::HasSubstr("Failed to open"));
+}
+
+INSTANTIATE_TEST_SUITE_P(StoredAndDeflated, ZipArchiveTest, ::testing::Values(false, true));